@@ -0,0 +1,231 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#if defined(LINUX) && !defined(OS_X)
+#define _GNU_SOURCE
+#include <sched.h>
+#endif
+
+#include "bench_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+double bench_now(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+#endif
+}
+
+uint64_t bench_now_ns(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (uint64_t)(counter.QuadPart / frequency.QuadPart) * 1000000000u +
+		(uint64_t)(counter.QuadPart % frequency.QuadPart) * 1000000000u / frequency.QuadPart;
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+int bench_pin_cpu(int cpu)
+{
+#if defined(_WIN32)
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0 ? 0 : -1;
+#elif defined(LINUX) && !defined(OS_X)
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return sched_setaffinity(0, sizeof(set), &set);
+#else
+	// no thread affinity on this platform
+	return -1;
+#endif
+}
+
+static size_t bench_histogram_index(uint64_t value)
+{
+	size_t magnitude = BENCH_HISTOGRAM_BITS;
+
+	if (value < ((uint64_t)1 << BENCH_HISTOGRAM_BITS))
+		return (size_t)value;
+
+	while (magnitude < BENCH_HISTOGRAM_RANGE && (value >> (magnitude + 1)) != 0)
+		magnitude++;
+	if ((value >> (magnitude + 1)) != 0)
+		return BENCH_HISTOGRAM_BUCKETS - 1;
+
+	// the top bits of the value select the linear bucket
+	return ((magnitude - BENCH_HISTOGRAM_BITS + 1) << BENCH_HISTOGRAM_BITS) +
+		(size_t)(value >> (magnitude - BENCH_HISTOGRAM_BITS)) - ((size_t)1 << BENCH_HISTOGRAM_BITS);
+}
+
+static uint64_t bench_histogram_upper(size_t index)
+{
+	size_t magnitude;
+	size_t linear;
+
+	if (index < ((size_t)1 << BENCH_HISTOGRAM_BITS))
+		return index;
+
+	magnitude = (index >> BENCH_HISTOGRAM_BITS) + BENCH_HISTOGRAM_BITS - 1;
+	linear = (index & (((size_t)1 << BENCH_HISTOGRAM_BITS) - 1)) + ((size_t)1 << BENCH_HISTOGRAM_BITS);
+	return (((uint64_t)linear + 1) << (magnitude - BENCH_HISTOGRAM_BITS)) - 1;
+}
+
+void bench_histogram_clear(bench_histogram* h)
+{
+	memset(h, 0, sizeof(bench_histogram));
+	h->min = (uint64_t)-1;
+}
+
+void bench_histogram_record(bench_histogram* h, uint64_t value)
+{
+	h->counts[bench_histogram_index(value)]++;
+	h->total++;
+	h->sum += (double)value;
+	if (value < h->min) h->min = value;
+	if (value > h->max) h->max = value;
+}
+
+uint64_t bench_histogram_percentile(const bench_histogram* h, double percent)
+{
+	uint64_t rank;
+	uint64_t seen = 0;
+	uint64_t upper;
+	size_t   index;
+
+	if (h->total == 0)
+		return 0;
+
+	rank = (uint64_t)(percent / 100.0 * (double)h->total + 0.5);
+	if (rank < 1) rank = 1;
+
+	for (index = 0; index < BENCH_HISTOGRAM_BUCKETS; index++)
+	{
+		seen += h->counts[index];
+		if (seen >= rank)
+		{
+			// report the highest value of the bucket, but never above the maximum
+			upper = bench_histogram_upper(index);
+			return upper < h->max ? upper : h->max;
+		}
+	}
+	return h->max;
+}
+
+static ujoPointer bench_alloc(ujoPointer user, size_t size)
+{
+	((bench_counter*)user)->allocs++;
+	return malloc(size);
+}
+
+static ujoPointer bench_realloc(ujoPointer user, ujoPointer ref, size_t oldsize, size_t size)
+{
+	((bench_counter*)user)->allocs++;
+	return realloc(ref, size);
+}
+
+static void bench_free(ujoPointer user, ujoPointer ref)
+{
+	if (ref != NULL)
+		((bench_counter*)user)->frees++;
+	free(ref);
+}
+
+void bench_counting_allocator(ujoAllocator* allocator, bench_counter* counter)
+{
+	memset(counter, 0, sizeof(bench_counter));
+	allocator->alloc   = bench_alloc;
+	allocator->realloc = bench_realloc;
+	allocator->free    = bench_free;
+	allocator->user    = counter;
+}
+
+const char* bench_json_string(const char* s)
+{
+	static char quoted[256];
+	size_t      pos = 0;
+
+	quoted[pos++] = '"';
+	while (*s && pos < sizeof(quoted) - 3)
+	{
+		if (*s == '"' || *s == '\\')
+			quoted[pos++] = '\\';
+		quoted[pos++] = *s++;
+	}
+	quoted[pos++] = '"';
+	quoted[pos] = 0;
+
+	return quoted;
+}
+
+const char* bench_library_version(void)
+{
+	static char version[32];
+	uint32_t    libversion;
+	uint32_t    apiversion;
+
+	// the version is encoded as decimal digits, 901 is 0.9.1
+	ujo_get_version(&libversion, &apiversion);
+	snprintf(version, sizeof(version), "%u.%u.%u", 
+		libversion / 1000, (libversion / 100) % 10, libversion % 100);
+
+	return version;
+}
@@ -0,0 +1,109 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#ifndef __BENCH_HELPER_H__
+#define __BENCH_HELPER_H__
+
+#include "ujo.h"
+
+/**
+ * allocation counters of a benchmark allocator
+ */
+typedef struct {
+	uint64_t allocs;
+	uint64_t frees;
+} bench_counter;
+
+/**
+ * log-linear latency histogram, 2^BENCH_HISTOGRAM_BITS linear buckets for
+ * each power of two up to 2^BENCH_HISTOGRAM_RANGE
+ */
+#define BENCH_HISTOGRAM_BITS     5
+#define BENCH_HISTOGRAM_RANGE    40
+#define BENCH_HISTOGRAM_BUCKETS  ((BENCH_HISTOGRAM_RANGE - BENCH_HISTOGRAM_BITS + 2) << BENCH_HISTOGRAM_BITS)
+
+typedef struct {
+	uint64_t counts[BENCH_HISTOGRAM_BUCKETS];
+	uint64_t total;
+	uint64_t min;
+	uint64_t max;
+	double   sum;
+} bench_histogram;
+
+/**
+ * current time of a monotonic clock in seconds
+ */
+double bench_now(void);
+
+/**
+ * current time of a monotonic clock in nanoseconds
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * pin the calling thread to a cpu, returns 0 on success
+ */
+int bench_pin_cpu(int cpu);
+
+/**
+ * remove all values from a histogram
+ */
+void bench_histogram_clear(bench_histogram* h);
+
+/**
+ * add a value to a histogram
+ */
+void bench_histogram_record(bench_histogram* h, uint64_t value);
+
+/**
+ * get the value below which the given percentage of all values lies
+ */
+uint64_t bench_histogram_percentile(const bench_histogram* h, double percent);
+
+/**
+ * initialize an allocator counting allocations and reallocations
+ */
+void bench_counting_allocator(ujoAllocator* allocator, bench_counter* counter);
+
+/**
+ * quote a string for JSON output, the result is valid until the next call
+ */
+const char* bench_json_string(const char* s);
+
+/**
+ * version of the linked library as major.minor.micro, the result is static
+ */
+const char* bench_library_version(void);
+
+#endif
@@ -0,0 +1,717 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ujo.h"
+#include "bench_helper.h"
+
+#define BENCH_FILE        "./bench_ujo.ujo"
+#define BENCH_DEPTH       32
+#define BENCH_COLUMNS     8
+
+typedef ujoError (*bench_write_func)(ujo_writer* w, uint32_t n);
+
+/**
+ * a benchmark case writes n values of one type in one container shape
+ */
+typedef struct {
+	const char*       type;
+	const char*       shape;
+	bench_write_func  write;
+} bench_case;
+
+static char     bench_text[1024];
+static uint16_t bench_text_u16[32];
+static uint32_t bench_text_u32[16];
+static uint8_t  bench_data[4096];
+
+/* types in a flat list */
+
+static ujoError write_int64(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_int64(w, (int64_t)i * 1000003));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_int32(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_int32(w, (int32_t)i));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_int8(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_int8(w, (int8_t)i));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_int16(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_int16(w, (int16_t)i));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_uint64(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_uint64(w, (uint64_t)i));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_uint32(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_uint32(w, (uint32_t)i));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_uint16(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_uint16(w, (uint16_t)i));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_uint8(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_uint8(w, (uint8_t)i));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_bool(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_bool(w, (ujoBool)(i & 1)));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_float64(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_float64(w, i * 0.25));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_float32(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_float32(w, (float32_t)(i * 0.25)));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_float16(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_float16(w, (float32_t)(i % 1024) * 0.5f));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_strings(ujo_writer* w, uint32_t n, size_t size)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_string_c(w, bench_text, size));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_string8(ujo_writer* w, uint32_t n)    { return write_strings(w, n, 8); }
+static ujoError write_string64(ujo_writer* w, uint32_t n)   { return write_strings(w, n, 64); }
+static ujoError write_string1024(ujo_writer* w, uint32_t n) { return write_strings(w, n, 1023); }
+
+static ujoError write_string_u8(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_string_u8(w, (const uint8_t*)bench_text, 64));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_string_u16(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_string_u16(w, bench_text_u16, 32));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_string_u32(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_string_u32(w, bench_text_u32, 16));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_binaries(ujo_writer* w, uint32_t n, uint32_t size)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_binary(w, 0, bench_data, size));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_binary64(ujo_writer* w, uint32_t n)   { return write_binaries(w, n, 64); }
+static ujoError write_binary4096(ujo_writer* w, uint32_t n) { return write_binaries(w, n, 4096); }
+
+static ujoError write_timestamp(ujo_writer* w, uint32_t n)
+{
+	ujoError    err;
+	ujoDateTime dt;
+	uint32_t    i;
+
+	memset(&dt, 0, sizeof(dt));
+	dt.year = 2016; dt.month = 5; dt.day = 17;
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		dt.second = (uint8_t)(i % 60);
+		dt.millisecond = (uint16_t)(i % 1000);
+		return_on_err(ujo_writer_add_timestamp(w, dt));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_date(ujo_writer* w, uint32_t n)
+{
+	ujoError    err;
+	ujoDateTime dt;
+	uint32_t    i;
+
+	memset(&dt, 0, sizeof(dt));
+	dt.year = 2016; dt.month = 5;
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		dt.day = (uint8_t)(i % 28 + 1);
+		return_on_err(ujo_writer_add_date(w, dt));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_time(ujo_writer* w, uint32_t n)
+{
+	ujoError    err;
+	ujoDateTime dt;
+	uint32_t    i;
+
+	memset(&dt, 0, sizeof(dt));
+	dt.hour = 13;
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		dt.second = (uint8_t)(i % 60);
+		return_on_err(ujo_writer_add_time(w, dt));
+	}
+	return ujo_writer_list_close(w);
+}
+
+static ujoError write_uxtime(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (i = 0; i < n; i++)
+	{
+		return_on_err(ujo_writer_add_uxtime(w, 1463500000 + i));
+	}
+	return ujo_writer_list_close(w);
+}
+
+/* container shapes with int32 values */
+
+static ujoError write_deep(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t level;
+	uint32_t i;
+
+	for (level = 0; level < BENCH_DEPTH; level++)
+	{
+		return_on_err(ujo_writer_list_open(w));
+		for (i = level; i < n; i += BENCH_DEPTH)
+		{
+			return_on_err(ujo_writer_add_int32(w, (int32_t)i));
+		}
+	}
+	for (level = 0; level < BENCH_DEPTH; level++)
+	{
+		return_on_err(ujo_writer_list_close(w));
+	}
+	return UJO_SUCCESS;
+}
+
+static ujoError write_map(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	// n values are n/2 key value pairs
+	return_on_err(ujo_writer_map_open(w));
+	for (i = 0; i + 1 < n; i += 2)
+	{
+		return_on_err(ujo_writer_add_int32(w, (int32_t)i));
+		return_on_err(ujo_writer_add_int32(w, (int32_t)(i+1)));
+	}
+	return ujo_writer_map_close(w);
+}
+
+static ujoError write_table(ujo_writer* w, uint32_t n)
+{
+	ujoError err;
+	uint32_t i;
+
+	return_on_err(ujo_writer_table_open(w));
+	for (i = 0; i < BENCH_COLUMNS; i++)
+	{
+		return_on_err(ujo_writer_add_string_c(w, "column", 6));
+	}
+	return_on_err(ujo_writer_table_end_columns(w));
+	for (i = 0; i < n - n % BENCH_COLUMNS; i++)
+	{
+		return_on_err(ujo_writer_add_int32(w, (int32_t)i));
+	}
+	return ujo_writer_table_close(w);
+}
+
+static const bench_case bench_cases[] = {
+	{ "int64",       "flat_list", write_int64 },
+	{ "int32",       "flat_list", write_int32 },
+	{ "int16",       "flat_list", write_int16 },
+	{ "int8",        "flat_list", write_int8 },
+	{ "uint64",      "flat_list", write_uint64 },
+	{ "uint32",      "flat_list", write_uint32 },
+	{ "uint16",      "flat_list", write_uint16 },
+	{ "uint8",       "flat_list", write_uint8 },
+	{ "bool",        "flat_list", write_bool },
+	{ "float64",     "flat_list", write_float64 },
+	{ "float32",     "flat_list", write_float32 },
+	{ "float16",     "flat_list", write_float16 },
+	{ "string_8",    "flat_list", write_string8 },
+	{ "string_64",   "flat_list", write_string64 },
+	{ "string_1024", "flat_list", write_string1024 },
+	{ "string_u8",   "flat_list", write_string_u8 },
+	{ "string_u16",  "flat_list", write_string_u16 },
+	{ "string_u32",  "flat_list", write_string_u32 },
+	{ "binary_64",   "flat_list", write_binary64 },
+	{ "binary_4096", "flat_list", write_binary4096 },
+	{ "timestamp",   "flat_list", write_timestamp },
+	{ "date",        "flat_list", write_date },
+	{ "time",        "flat_list", write_time },
+	{ "uxtime",      "flat_list", write_uxtime },
+	{ "int32",       "deep_nesting", write_deep },
+	{ "int32",       "wide_map", write_map },
+	{ "int32",       "table", write_table },
+};
+
+/**
+ * read all elements of a document, returns the number of elements
+ */
+static ujoError bench_read(ujo_reader* r, uint64_t* elements)
+{
+	ujoError     err;
+	ujo_element* element;
+	ujoBool      eod;
+
+	return_on_err(ujo_reader_get_first(r, &element, &eod));
+	while (!eod)
+	{
+		(*elements)++;
+		ujo_free_element(element);
+		return_on_err(ujo_reader_get_next(r, &element, &eod));
+	}
+	return UJO_SUCCESS;
+}
+
+typedef struct {
+	size_t    bytes;
+	uint64_t  elements;
+	double    encode_seconds;
+	double    decode_seconds;
+	uint64_t  encode_allocs;
+	uint64_t  decode_allocs;
+} bench_result;
+
+static ujoError bench_memory(const bench_case* c, uint32_t n, uint32_t iterations, ujoBool unchecked, bench_result* result)
+{
+	ujoError      err;
+	ujo_writer*   w;
+	ujo_reader*   r;
+	ujoByte*      data;
+	size_t        datasize;
+	ujoAllocator  allocator;
+	bench_counter counter;
+	uint32_t      i;
+	double        start;
+
+	bench_counting_allocator(&allocator, &counter);
+
+	// the first document warms up the writer
+	return_on_err(ujo_new_memory_writer_ex(&w, &allocator));
+	err = ujo_writer_set_unchecked(w, unchecked);
+	if (err == UJO_SUCCESS)
+		err = c->write(w, n);
+	if (err == UJO_SUCCESS)
+		err = ujo_writer_finish(w);
+
+	counter.allocs = 0;
+	start = bench_now();
+	for (i = 0; i < iterations && err == UJO_SUCCESS; i++)
+	{
+		err = ujo_writer_reset(w);
+		if (err == UJO_SUCCESS)
+			err = c->write(w, n);
+		if (err == UJO_SUCCESS)
+			err = ujo_writer_finish(w);
+	}
+	result->encode_seconds = bench_now() - start;
+	result->encode_allocs = counter.allocs;
+
+	if (err == UJO_SUCCESS)
+		err = ujo_writer_get_buffer(w, &data, &datasize);
+	if (err == UJO_SUCCESS)
+		err = ujo_new_memory_reader_ex(&r, &allocator);
+	if (err != UJO_SUCCESS)
+	{
+		ujo_free_writer(w);
+		return err;
+	}
+	result->bytes = datasize;
+
+	err = ujo_reader_set_buffer(r, data, datasize);
+	counter.allocs = 0;
+	start = bench_now();
+	for (i = 0; i < iterations && err == UJO_SUCCESS; i++)
+	{
+		result->elements = 0;
+		err = ujo_reader_reset(r);
+		if (err == UJO_SUCCESS)
+			err = bench_read(r, &result->elements);
+	}
+	result->decode_seconds = bench_now() - start;
+	result->decode_allocs = counter.allocs;
+
+	ujo_free_reader(r);
+	ujo_free_writer(w);
+
+	return err;
+}
+
+static ujoError bench_file(const bench_case* c, uint32_t n, uint32_t iterations, bench_result* result)
+{
+	ujoError      err = UJO_SUCCESS;
+	ujo_writer*   w;
+	ujo_reader*   r;
+	ujoAllocator  allocator;
+	bench_counter counter;
+	uint32_t      i;
+	double        start;
+	FILE*         f;
+
+	bench_counting_allocator(&allocator, &counter);
+
+	start = bench_now();
+	for (i = 0; i < iterations && err == UJO_SUCCESS; i++)
+	{
+		err = ujo_new_file_writer_ex(&w, BENCH_FILE, &allocator);
+		if (err != UJO_SUCCESS)
+			return err;
+		err = c->write(w, n);
+		ujo_free_writer(w);
+	}
+	result->encode_seconds = bench_now() - start;
+	result->encode_allocs = counter.allocs;
+
+	f = fopen(BENCH_FILE, "rb");
+	if (f != NULL)
+	{
+		fseek(f, 0, SEEK_END);
+		result->bytes = (size_t)ftell(f);
+		fclose(f);
+	}
+
+	counter.allocs = 0;
+	start = bench_now();
+	for (i = 0; i < iterations && err == UJO_SUCCESS; i++)
+	{
+		err = ujo_new_file_reader_ex(&r, BENCH_FILE, &allocator);
+		if (err != UJO_SUCCESS)
+			return err;
+		result->elements = 0;
+		err = bench_read(r, &result->elements);
+		ujo_free_reader(r);
+	}
+	result->decode_seconds = bench_now() - start;
+	result->decode_allocs = counter.allocs;
+
+	remove(BENCH_FILE);
+
+	return err;
+}
+
+static void bench_print(FILE* out, const bench_case* c, const char* backend, uint32_t n, uint32_t iterations, const bench_result* result, ujoBool first)
+{
+	double megabytes = (double)result->bytes * iterations / (1024.0 * 1024.0);
+	double values = (double)n * iterations;
+
+	fprintf(out, "%s    {", first ? "" : ",\n");
+	fprintf(out, "\"type\": %s, ", bench_json_string(c->type));
+	fprintf(out, "\"shape\": %s, ", bench_json_string(c->shape));
+	fprintf(out, "\"backend\": %s, ", bench_json_string(backend));
+	fprintf(out, "\"values\": %u, \"bytes\": %lu, \"elements\": %lu, ", n, (unsigned long)result->bytes, (unsigned long)result->elements);
+	fprintf(out, "\"encode_mb_s\": %.2f, \"encode_values_s\": %.0f, ", 
+		megabytes / result->encode_seconds, values / result->encode_seconds);
+	fprintf(out, "\"decode_mb_s\": %.2f, \"decode_values_s\": %.0f, ",
+		megabytes / result->decode_seconds, values / result->decode_seconds);
+	fprintf(out, "\"encode_allocs_per_value\": %.4f, \"decode_allocs_per_value\": %.4f}",
+		result->encode_allocs / values, result->decode_allocs / values);
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: bench_ujo [-n values] [-i iterations] [-o output.json] [-t type] [-b memory|unchecked|file]\n\n");
+	fprintf(stderr, "Measures encode and decode throughput of libujo and writes the results as JSON.\n");
+}
+
+/**
+ * Main function.
+ */
+int main(int argc, char **argv)
+{
+	ujoError      err;
+	uint32_t      n = 100000;
+	uint32_t      iterations = 10;
+	const char*   output = NULL;
+	const char*   type = NULL;
+	const char*   backend = NULL;
+	FILE*         out = stdout;
+	bench_result  result;
+	ujoBool       first = ujoTrue;
+	size_t        index;
+	int           arg;
+
+	for (arg = 1; arg < argc; arg++)
+	{
+		if (arg + 1 < argc && strcmp(argv[arg], "-n") == 0)
+			n = (uint32_t)strtoul(argv[++arg], NULL, 10);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-i") == 0)
+			iterations = (uint32_t)strtoul(argv[++arg], NULL, 10);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-o") == 0)
+			output = argv[++arg];
+		else if (arg + 1 < argc && strcmp(argv[arg], "-t") == 0)
+			type = argv[++arg];
+		else if (arg + 1 < argc && strcmp(argv[arg], "-b") == 0)
+			backend = argv[++arg];
+		else {
+			usage();
+			return -1;
+		}
+	}
+	if (n < BENCH_DEPTH || iterations == 0) {
+		usage();
+		return -1;
+	}
+
+	memset(bench_text, 'x', sizeof(bench_text));
+	bench_text[sizeof(bench_text)-1] = 0;
+	for (index = 0; index < sizeof(bench_data); index++)
+		bench_data[index] = (uint8_t)index;
+	for (index = 0; index < sizeof(bench_text_u16) / sizeof(uint16_t); index++)
+		bench_text_u16[index] = (uint16_t)(0x3B1 + index);
+	for (index = 0; index < sizeof(bench_text_u32) / sizeof(uint32_t); index++)
+		bench_text_u32[index] = (uint32_t)(0x1F600 + index);
+
+	if (output != NULL) {
+		out = fopen(output, "w");
+		if (out == NULL) {
+			fprintf(stderr, "bench_ujo: cannot open %s\n", output);
+			return -1;
+		}
+	}
+
+	fprintf(out, "{\n  \"library\": \"libujo-c\",\n  \"version\": \"%s\",\n", bench_library_version());
+	fprintf(out, "  \"values\": %u,\n  \"iterations\": %u,\n  \"results\": [\n", n, iterations);
+
+	for (index = 0; index < sizeof(bench_cases) / sizeof(bench_case); index++)
+	{
+		const bench_case* c = &bench_cases[index];
+
+		if (type != NULL && strcmp(type, c->type) != 0)
+			continue;
+
+		if (backend == NULL || strcmp(backend, "memory") == 0)
+		{
+			memset(&result, 0, sizeof(result));
+			err = bench_memory(c, n, iterations, ujoFalse, &result);
+			if (err != UJO_SUCCESS) {
+				fprintf(stderr, "bench_ujo: %s %s memory failed with error %u\n", c->type, c->shape, err);
+				return -1;
+			}
+			bench_print(out, c, "memory", n, iterations, &result, first);
+			first = ujoFalse;
+		}
+		if (backend == NULL || strcmp(backend, "unchecked") == 0)
+		{
+			memset(&result, 0, sizeof(result));
+			err = bench_memory(c, n, iterations, ujoTrue, &result);
+			if (err != UJO_SUCCESS) {
+				fprintf(stderr, "bench_ujo: %s %s unchecked failed with error %u\n", c->type, c->shape, err);
+				return -1;
+			}
+			bench_print(out, c, "unchecked", n, iterations, &result, first);
+			first = ujoFalse;
+		}
+		if (backend == NULL || strcmp(backend, "file") == 0)
+		{
+			memset(&result, 0, sizeof(result));
+			err = bench_file(c, n, iterations, &result);
+			if (err != UJO_SUCCESS) {
+				fprintf(stderr, "bench_ujo: %s %s file failed with error %u\n", c->type, c->shape, err);
+				return -1;
+			}
+			bench_print(out, c, "file", n, iterations, &result, first);
+			first = ujoFalse;
+		}
+	}
+
+	fprintf(out, "\n  ]\n}\n");
+	if (out != stdout)
+		fclose(out);
+
+	return 0;
+}
@@ -0,0 +1,558 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ujo.h"
+#include "ujo_corpus.h"
+#include "bench_helper.h"
+
+#define LATENCY_SEEDS     1024
+#define LATENCY_EVICT_MB  16
+#define LATENCY_DEPTH     256
+
+/**
+ * one writer call of a pre-generated document
+ *
+ * A terminator closes the container given in subtype, a terminator with
+ * subtype UJO_TERMINATOR ends the column names of a table. Strings and
+ * binary data point into the corpus document of the record.
+ */
+typedef struct {
+	ujoTypeId  type;
+	ujoTypeId  subtype;
+	uint32_t   n;
+	union {
+		int64_t        i64;
+		int32_t        i32;
+		int16_t        i16;
+		int8_t         i8;
+		uint64_t       u64;
+		uint32_t       u32;
+		uint16_t       u16;
+		uint8_t        u8;
+		float64_t      f64;
+		float32_t      f32;
+		ujoBool        b;
+		ujoDateTime    dt;
+		const uint8_t* data;
+	} value;
+} latency_op;
+
+/**
+ * the values of one seed, generated before the run
+ */
+typedef struct {
+	ujoByte*    document;
+	latency_op* ops;
+	size_t      count;
+} latency_record;
+
+/**
+ * state of a latency run
+ */
+typedef struct {
+	ujoCorpusKind    kind;
+	uint64_t         size;
+	uint64_t         documents;
+	ujoBool          cold;
+	uint8_t*         evict;
+	size_t           evictsize;
+	latency_record   records[LATENCY_SEEDS];
+	bench_histogram  encode;
+	bench_histogram  decode;
+} latency_run;
+
+static ujoError latency_on_element(ujo_element* e, ujoPointer data)
+{
+	(*(uint64_t*)data)++;
+	return UJO_SUCCESS;
+}
+
+/**
+ * write over a buffer larger than the caches to evict library code and data
+ */
+static void latency_evict(latency_run* run)
+{
+	size_t index;
+
+	for (index = 0; index < run->evictsize; index += 64)
+		run->evict[index]++;
+}
+
+/**
+ * write the pre-generated values of a record, only writer calls are made
+ */
+static ujoError latency_encode(ujo_writer* w, const latency_record* record)
+{
+	ujoError          err;
+	const latency_op* op;
+	const latency_op* last = record->ops + record->count;
+
+	for (op = record->ops; op < last; op++)
+	{
+		switch (op->type)
+		{
+		case UJO_TERMINATOR:
+			if (op->subtype == UJO_TYPE_LIST)
+				err = ujo_writer_list_close(w);
+			else if (op->subtype == UJO_TYPE_MAP)
+				err = ujo_writer_map_close(w);
+			else if (op->subtype == UJO_TYPE_TABLE)
+				err = ujo_writer_table_close(w);
+			else
+				err = ujo_writer_table_end_columns(w);
+			break;
+		case UJO_TYPE_LIST:      err = ujo_writer_list_open(w); break;
+		case UJO_TYPE_MAP:       err = ujo_writer_map_open(w); break;
+		case UJO_TYPE_TABLE:     err = ujo_writer_table_open(w); break;
+		case UJO_TYPE_FLOAT64:   err = ujo_writer_add_float64(w, op->value.f64); break;
+		case UJO_TYPE_FLOAT32:   err = ujo_writer_add_float32(w, op->value.f32); break;
+		case UJO_TYPE_FLOAT16:   err = ujo_writer_add_float16(w, op->value.f32); break;
+		case UJO_TYPE_INT64:     err = ujo_writer_add_int64(w, op->value.i64); break;
+		case UJO_TYPE_INT32:     err = ujo_writer_add_int32(w, op->value.i32); break;
+		case UJO_TYPE_INT16:     err = ujo_writer_add_int16(w, op->value.i16); break;
+		case UJO_TYPE_INT8:      err = ujo_writer_add_int8(w, op->value.i8); break;
+		case UJO_TYPE_UINT64:    err = ujo_writer_add_uint64(w, op->value.u64); break;
+		case UJO_TYPE_UINT32:    err = ujo_writer_add_uint32(w, op->value.u32); break;
+		case UJO_TYPE_UINT16:    err = ujo_writer_add_uint16(w, op->value.u16); break;
+		case UJO_TYPE_UINT8:     err = ujo_writer_add_uint8(w, op->value.u8); break;
+		case UJO_TYPE_BOOL:      err = ujo_writer_add_bool(w, op->value.b); break;
+		case UJO_TYPE_NONE:      err = ujo_writer_add_none(w); break;
+		case UJO_TYPE_NULL_FLAG: err = ujo_writer_add_null(w, op->subtype); break;
+		case UJO_TYPE_UX_TIME:   err = ujo_writer_add_uxtime(w, op->value.i64); break;
+		case UJO_TYPE_DATE:      err = ujo_writer_add_date(w, op->value.dt); break;
+		case UJO_TYPE_TIME:      err = ujo_writer_add_time(w, op->value.dt); break;
+		case UJO_TYPE_TIMESTAMP: err = ujo_writer_add_timestamp(w, op->value.dt); break;
+		case UJO_TYPE_BIN:       err = ujo_writer_add_binary(w, op->subtype, op->value.data, op->n); break;
+		case UJO_TYPE_STRING:
+			if (op->subtype == UJO_SUB_STRING_C)
+				err = ujo_writer_add_string_c(w, (const char*)op->value.data, op->n);
+			else if (op->subtype == UJO_SUB_STRING_U8)
+				err = ujo_writer_add_string_u8(w, op->value.data, op->n);
+			else if (op->subtype == UJO_SUB_STRING_U16)
+				err = ujo_writer_add_string_u16(w, (const uint16_t*)op->value.data, op->n);
+			else
+				err = ujo_writer_add_string_u32(w, (const uint32_t*)op->value.data, op->n);
+			break;
+		default:
+			err = UJO_ERR_INVALID_DATA;
+			break;
+		}
+		if (err != UJO_SUCCESS)
+			return err;
+	}
+	return UJO_SUCCESS;
+}
+
+static ujoError latency_string_op(ujo_element* e, latency_op* op)
+{
+	ujoError  err;
+	char*     c_string;
+	uint8_t*  u8_string;
+	uint16_t* u16_string;
+	uint32_t* u32_string;
+
+	err = ujo_element_get_string_type(e, &op->subtype);
+	if (err != UJO_SUCCESS)
+		return err;
+
+	switch (op->subtype)
+	{
+	case UJO_SUB_STRING_C:
+		err = ujo_element_get_string_c(e, &c_string, &op->n);
+		op->value.data = (const uint8_t*)c_string;
+		break;
+	case UJO_SUB_STRING_U8:
+		err = ujo_element_get_string_u8(e, &u8_string, &op->n);
+		op->value.data = u8_string;
+		break;
+	case UJO_SUB_STRING_U16:
+		err = ujo_element_get_string_u16(e, &u16_string, &op->n);
+		op->value.data = (const uint8_t*)u16_string;
+		break;
+	default:
+		err = ujo_element_get_string_u32(e, &u32_string, &op->n);
+		op->value.data = (const uint8_t*)u32_string;
+		break;
+	}
+	return err;
+}
+
+/**
+ * convert an element into the writer call that produced it
+ */
+static ujoError latency_element_op(ujo_element* e, latency_op* op, ujoTypeId* stack, size_t* depth)
+{
+	ujoError err;
+	uint8_t* data;
+
+	memset(op, 0, sizeof(latency_op));
+	err = ujo_element_get_type(e, &op->type);
+	if (err != UJO_SUCCESS)
+		return err;
+
+	if (op->type & UJO_TYPE_NULL_FLAG)
+	{
+		op->type = UJO_TYPE_NULL_FLAG;
+		return ujo_element_get_null_type(e, &op->subtype);
+	}
+
+	switch (op->type)
+	{
+	case UJO_TERMINATOR:
+		if (*depth == 0)
+			return UJO_ERR_INVALID_DATA;
+		op->subtype = stack[--(*depth)];
+		return UJO_SUCCESS;
+	case UJO_TYPE_LIST:
+	case UJO_TYPE_MAP:
+	case UJO_TYPE_TABLE:
+		// a table is closed twice, after the column names and after the rows
+		if (*depth + 2 > LATENCY_DEPTH)
+			return UJO_ERR_INVALID_DATA;
+		stack[(*depth)++] = op->type;
+		if (op->type == UJO_TYPE_TABLE)
+			stack[(*depth)++] = UJO_TERMINATOR;
+		return UJO_SUCCESS;
+	case UJO_TYPE_FLOAT64:   return ujo_element_get_float64(e, &op->value.f64);
+	case UJO_TYPE_FLOAT32:   return ujo_element_get_float32(e, &op->value.f32);
+	case UJO_TYPE_FLOAT16:   return ujo_element_get_float16(e, &op->value.f32);
+	case UJO_TYPE_INT64:     return ujo_element_get_int64(e, &op->value.i64);
+	case UJO_TYPE_INT32:     return ujo_element_get_int32(e, &op->value.i32);
+	case UJO_TYPE_INT16:     return ujo_element_get_int16(e, &op->value.i16);
+	case UJO_TYPE_INT8:      return ujo_element_get_int8(e, &op->value.i8);
+	case UJO_TYPE_UINT64:    return ujo_element_get_uint64(e, &op->value.u64);
+	case UJO_TYPE_UINT32:    return ujo_element_get_uint32(e, &op->value.u32);
+	case UJO_TYPE_UINT16:    return ujo_element_get_uint16(e, &op->value.u16);
+	case UJO_TYPE_UINT8:     return ujo_element_get_uint8(e, &op->value.u8);
+	case UJO_TYPE_BOOL:      return ujo_element_get_bool(e, &op->value.b);
+	case UJO_TYPE_NONE:      return UJO_SUCCESS;
+	case UJO_TYPE_UX_TIME:   return ujo_element_get_uxtime(e, &op->value.i64);
+	case UJO_TYPE_DATE:      return ujo_element_get_date(e, &op->value.dt);
+	case UJO_TYPE_TIME:      return ujo_element_get_time(e, &op->value.dt);
+	case UJO_TYPE_TIMESTAMP: return ujo_element_get_timestamp(e, &op->value.dt);
+	case UJO_TYPE_BIN:
+		err = ujo_element_get_binary(e, &op->subtype, &data, &op->n);
+		op->value.data = data;
+		return err;
+	case UJO_TYPE_STRING:
+		return latency_string_op(e, op);
+	default:
+		return UJO_ERR_INVALID_DATA;
+	}
+}
+
+/**
+ * generate the corpus document of a seed and record its writer calls
+ */
+static ujoError latency_prepare(latency_run* run, uint64_t seed)
+{
+	ujoError        err;
+	latency_record* record = &run->records[seed];
+	ujo_writer*     w;
+	ujo_reader*     r;
+	ujo_element*    e;
+	ujoBool         eod;
+	ujoByte*        data;
+	size_t          datasize;
+	ujoIovec        iovec;
+	ujoTypeId       stack[LATENCY_DEPTH];
+	size_t          depth = 0;
+	size_t          size = 0;
+	latency_op*     ops;
+
+	err = ujo_new_memory_writer(&w);
+	if (err != UJO_SUCCESS)
+		return err;
+	err = ujo_corpus_write(w, run->kind, seed, run->size);
+	if (err == UJO_SUCCESS)
+		err = ujo_writer_get_buffer(w, &data, &datasize);
+	if (err == UJO_SUCCESS)
+	{
+		record->document = (ujoByte*)malloc(datasize);
+		if (record->document == NULL)
+			err = UJO_ERR_ALLOCATION;
+		else
+			memcpy(record->document, data, datasize);
+	}
+	ujo_free_writer(w);
+	if (err != UJO_SUCCESS)
+		return err;
+
+	// strings and binary data are read as views on the kept document
+	iovec.base = record->document;
+	iovec.len  = datasize;
+	err = ujo_new_memory_reader(&r);
+	if (err != UJO_SUCCESS)
+		return err;
+	err = ujo_reader_set_iovecs(r, &iovec, 1);
+	if (err == UJO_SUCCESS)
+		err = ujo_reader_get_first(r, &e, &eod);
+	while (err == UJO_SUCCESS && !eod)
+	{
+		if (record->count == size)
+		{
+			size = size ? size * 2 : 256;
+			ops = (latency_op*)realloc(record->ops, size * sizeof(latency_op));
+			if (ops == NULL)
+				err = UJO_ERR_ALLOCATION;
+			else
+				record->ops = ops;
+		}
+		if (err == UJO_SUCCESS)
+			err = latency_element_op(e, &record->ops[record->count++], stack, &depth);
+		ujo_free_element(e);
+		if (err == UJO_SUCCESS)
+			err = ujo_reader_get_next(r, &e, &eod);
+	}
+	ujo_free_reader(r);
+	if (err != UJO_SUCCESS)
+		return err;
+
+	// the recorded calls have to reproduce the corpus document
+	err = ujo_new_memory_writer(&w);
+	if (err != UJO_SUCCESS)
+		return err;
+	err = latency_encode(w, record);
+	if (err == UJO_SUCCESS)
+		err = ujo_writer_get_buffer(w, &data, &datasize);
+	if (err == UJO_SUCCESS && (datasize != iovec.len || memcmp(data, record->document, datasize) != 0))
+		err = UJO_ERR_INVALID_DATA;
+	ujo_free_writer(w);
+
+	return err;
+}
+
+/**
+ * encode and decode one document, each operation is timed on its own
+ */
+static ujoError latency_document(latency_run* run, uint64_t seed)
+{
+	ujoError    err;
+	ujo_writer* w;
+	ujo_reader* r;
+	ujoByte*    data;
+	size_t      datasize;
+	uint64_t    elements = 0;
+	uint64_t    start;
+	uint64_t    end;
+
+	if (run->cold)
+		latency_evict(run);
+
+	start = bench_now_ns();
+	err = ujo_new_memory_writer(&w);
+	if (err != UJO_SUCCESS)
+		return err;
+	err = latency_encode(w, &run->records[seed]);
+	if (err == UJO_SUCCESS)
+		err = ujo_writer_get_buffer(w, &data, &datasize);
+	end = bench_now_ns();
+	if (err != UJO_SUCCESS)
+	{
+		ujo_free_writer(w);
+		return err;
+	}
+	bench_histogram_record(&run->encode, end - start);
+
+	if (run->cold)
+		latency_evict(run);
+
+	start = bench_now_ns();
+	err = ujo_new_memory_reader(&r);
+	if (err == UJO_SUCCESS)
+	{
+		err = ujo_reader_set_buffer(r, data, datasize);
+		if (err == UJO_SUCCESS)
+			err = ujo_reader_set_on_element(r, latency_on_element, &elements);
+		if (err == UJO_SUCCESS)
+			err = ujo_reader_parse(r);
+		ujo_free_reader(r);
+	}
+	end = bench_now_ns();
+	if (err == UJO_SUCCESS)
+		bench_histogram_record(&run->decode, end - start);
+
+	ujo_free_writer(w);
+
+	return err;
+}
+
+static void latency_print(FILE* out, const char* operation, const bench_histogram* h, ujoBool last)
+{
+	fprintf(out, "    %s: {", bench_json_string(operation));
+	fprintf(out, "\"count\": %lu, \"min\": %lu, \"mean\": %.1f, ", 
+		(unsigned long)h->total, (unsigned long)h->min, h->total ? h->sum / (double)h->total : 0.0);
+	fprintf(out, "\"p50\": %lu, \"p90\": %lu, \"p99\": %lu, \"p999\": %lu, \"p9999\": %lu, \"max\": %lu}%s\n",
+		(unsigned long)bench_histogram_percentile(h, 50.0),
+		(unsigned long)bench_histogram_percentile(h, 90.0),
+		(unsigned long)bench_histogram_percentile(h, 99.0),
+		(unsigned long)bench_histogram_percentile(h, 99.9),
+		(unsigned long)bench_histogram_percentile(h, 99.99),
+		(unsigned long)h->max, last ? "" : ",");
+}
+
+static void usage(void)
+{
+	fprintf(stderr, "usage: latency_ujo [-n documents] [-k kind] [-s size] [-c cpu] [-m warm|cold] [-e evict_mb] [-o output.json]\n\n");
+	fprintf(stderr, "Measures the latency of encoding and decoding single documents and writes\n");
+	fprintf(stderr, "percentiles in nanoseconds as JSON. Kinds: telemetry, events, status, images, config\n");
+}
+
+/**
+ * Main function.
+ */
+int main(int argc, char **argv)
+{
+	ujoError     err = UJO_SUCCESS;
+	latency_run* run;
+	const char*  kind = "telemetry";
+	const char*  mode = "warm";
+	const char*  output = NULL;
+	FILE*        out = stdout;
+	int          cpu = -1;
+	size_t       evictmb = LATENCY_EVICT_MB;
+	uint64_t     index;
+	int          arg;
+
+	// the histograms are too large for the stack
+	run = (latency_run*)calloc(1, sizeof(latency_run));
+	if (run == NULL)
+		return -1;
+	run->size = 128;
+
+	for (arg = 1; arg < argc; arg++)
+	{
+		if (arg + 1 < argc && strcmp(argv[arg], "-n") == 0)
+			run->documents = strtoull(argv[++arg], NULL, 10);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-k") == 0)
+			kind = argv[++arg];
+		else if (arg + 1 < argc && strcmp(argv[arg], "-s") == 0)
+			run->size = strtoull(argv[++arg], NULL, 10);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-c") == 0)
+			cpu = atoi(argv[++arg]);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-m") == 0)
+			mode = argv[++arg];
+		else if (arg + 1 < argc && strcmp(argv[arg], "-e") == 0)
+			evictmb = (size_t)strtoul(argv[++arg], NULL, 10);
+		else if (arg + 1 < argc && strcmp(argv[arg], "-o") == 0)
+			output = argv[++arg];
+		else {
+			usage();
+			return -1;
+		}
+	}
+	// evicting the caches costs milliseconds, cold runs are shorter
+	if (run->documents == 0)
+		run->documents = strcmp(mode, "cold") == 0 ? 10000 : 1000000;
+	if (ujo_corpus_get_kind(kind, &run->kind) != UJO_SUCCESS ||
+		(strcmp(mode, "warm") != 0 && strcmp(mode, "cold") != 0)) {
+		usage();
+		return -1;
+	}
+
+	if (cpu >= 0 && bench_pin_cpu(cpu) != 0) {
+		fprintf(stderr, "latency_ujo: cannot pin to cpu %d\n", cpu);
+		return -1;
+	}
+
+	run->cold = strcmp(mode, "cold") == 0;
+	if (run->cold) {
+		run->evictsize = evictmb * 1024 * 1024;
+		run->evict = (uint8_t*)calloc(1, run->evictsize);
+		if (run->evict == NULL) {
+			fprintf(stderr, "latency_ujo: cannot allocate %lu MB to evict caches\n", (unsigned long)evictmb);
+			return -1;
+		}
+	}
+
+	if (output != NULL) {
+		out = fopen(output, "w");
+		if (out == NULL) {
+			fprintf(stderr, "latency_ujo: cannot open %s\n", output);
+			return -1;
+		}
+	}
+
+	bench_histogram_clear(&run->encode);
+	bench_histogram_clear(&run->decode);
+
+	// the values are generated up front, the run times the library calls only
+	for (index = 0; index < LATENCY_SEEDS && err == UJO_SUCCESS; index++)
+		err = latency_prepare(run, index);
+	if (err != UJO_SUCCESS) {
+		fprintf(stderr, "latency_ujo: generating seed %lu failed with error %u\n", (unsigned long)index, err);
+		return -1;
+	}
+
+	// a warm run starts with caches and allocator already in use
+	if (!run->cold)
+	{
+		for (index = 0; index < LATENCY_SEEDS && err == UJO_SUCCESS; index++)
+			err = latency_document(run, index);
+		bench_histogram_clear(&run->encode);
+		bench_histogram_clear(&run->decode);
+	}
+
+	for (index = 0; index < run->documents && err == UJO_SUCCESS; index++)
+		err = latency_document(run, index % LATENCY_SEEDS);
+
+	if (err != UJO_SUCCESS) {
+		fprintf(stderr, "latency_ujo: document %lu failed with error %u\n", (unsigned long)index, err);
+		return -1;
+	}
+
+	fprintf(out, "{\n  \"library\": \"libujo-c\",\n  \"version\": \"%s\",\n", bench_library_version());
+	fprintf(out, "  \"kind\": %s,\n", bench_json_string(kind));
+	fprintf(out, "  \"size\": %lu,\n  \"documents\": %lu,\n", (unsigned long)run->size, (unsigned long)run->documents);
+	fprintf(out, "  \"mode\": %s,\n  \"cpu\": %d,\n  \"unit\": \"ns\",\n", bench_json_string(mode), cpu);
+	fprintf(out, "  \"latency\": {\n");
+	latency_print(out, "encode", &run->encode, ujoFalse);
+	latency_print(out, "decode", &run->decode, ujoTrue);
+	fprintf(out, "  }\n}\n");
+	if (out != stdout)
+		fclose(out);
+
+	for (index = 0; index < LATENCY_SEEDS; index++)
+	{
+		free(run->records[index].document);
+		free(run->records[index].ops);
+	}
+	free(run->evict);
+	free(run);
+
+	return 0;
+}
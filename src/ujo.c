@@ -56,6 +56,34 @@
  * The reader object object is used to traverse UJO data.
  */
 
+/**
+ * \defgroup ujo_repack UJO Repack: Rewrite UJO data in its smallest form.
+ *
+ * Existing UJO documents are read and written again with the smallest
+ * lossless representation of each value.
+ */
+
+/**
+ * \defgroup ujo_template UJO Template: Pre-encoded documents with value slots.
+ *
+ * A template is encoded once. Messages with the same structure are produced
+ * by setting the values of its slots in place.
+ */
+
+/**
+ * \defgroup ujo_corpus UJO Corpus: Generate reproducible workload documents.
+ *
+ * Documents with typical IoT content of any size are generated from a seed
+ * to run benchmarks and tests with realistic data.
+ */
+
+/**
+ * \defgroup ujo_profile UJO Profile: Find out where the octets of documents are spent.
+ *
+ * Documents are read with bounded memory and the octets are broken down by
+ * type, string, map key and table column to guide encoding choices.
+ */
+
 /**
  * \defgroup ujo_element UJO Element: access UJO data.
  * 
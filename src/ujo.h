@@ -31,6 +31,7 @@
 #include "ujo_writer.h"
 #include "ujo_reader.h"
 #include "ujo_constants.h"
+#include "ujo_log.h"
 
 BEGIN_C_DECLS
 
@@ -0,0 +1,164 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ */
+
+#include "ujo_arena.h"
+#include "ujo_errors.h"
+#include "ujo_log.h"
+#include "ujo_macros.h"
+#include <string.h>
+
+/** 
+@cond INTERNAL_DOCS
+*/
+
+/* allocations are aligned to 8 octets */
+#define UJO_ARENA_ALIGN(size) (((size) + 7) & ~((size_t)7))
+
+typedef struct _ujoArenaBlock {
+	struct _ujoArenaBlock* next;
+	size_t                 size;
+	size_t                 used;
+} ujoArenaBlock;
+
+struct _ujoArena {
+	// backing allocator for the blocks
+	const ujoAllocator* allocator;
+	// allocator interface handing out arena memory
+	ujoAllocator        self;
+
+	size_t              blocksize;
+	ujoArenaBlock*      first;
+	ujoArenaBlock*      current;
+};
+
+static ujoPointer _ujo_arena_alloc(ujoPointer user, size_t size)
+{
+	return ujo_arena_alloc((ujoArena*)user, size);
+}
+
+static ujoPointer _ujo_arena_realloc(ujoPointer user, ujoPointer ref, size_t oldsize, size_t size)
+{
+	ujoPointer newref = ujo_arena_alloc((ujoArena*)user, size);
+
+	if (newref && ref)
+		memcpy(newref, ref, oldsize < size ? oldsize : size);
+	return newref;
+}
+
+static void _ujo_arena_free(ujoPointer user, ujoPointer ref)
+{
+	/* arena memory is released by ujo_arena_reset */
+}
+
+ujoArena* ujo_new_arena(size_t blocksize, const ujoAllocator* allocator)
+{
+	ujoArena* arena;
+
+	arena = ujo_new_ex(allocator, ujoArena, 1);
+	if (arena == NULL)
+		return NULL;
+
+	arena->allocator    = allocator;
+	arena->blocksize    = blocksize ? blocksize : UJO_DEFAULT_BUFSIZE;
+	arena->self.alloc   = _ujo_arena_alloc;
+	arena->self.realloc = _ujo_arena_realloc;
+	arena->self.free    = _ujo_arena_free;
+	arena->self.user    = arena;
+
+	return arena;
+};
+
+void ujo_free_arena(ujoArena* arena)
+{
+	ujoArenaBlock* block;
+
+	return_if_fail(arena, "invalid pointer");
+
+	while (arena->first)
+	{
+		block = arena->first;
+		arena->first = block->next;
+		ujo_allocator_free(arena->allocator, block);
+	}
+	ujo_allocator_free(arena->allocator, arena);
+};
+
+void ujo_arena_reset(ujoArena* arena)
+{
+	return_if_fail(arena, "invalid pointer");
+
+	/* blocks are kept and reused, each block is rewound when it is entered again */
+	arena->current = arena->first;
+	if (arena->current)
+		arena->current->used = 0;
+};
+
+ujoPointer ujo_arena_alloc(ujoArena* arena, size_t size)
+{
+	ujoArenaBlock* block;
+	ujoPointer     ref;
+	size_t         blocksize;
+
+	size = UJO_ARENA_ALIGN(size);
+
+	while (arena->current == NULL || arena->current->used + size > arena->current->size)
+	{
+		if (arena->current && arena->current->next)
+		{
+			arena->current = arena->current->next;
+			arena->current->used = 0;
+			continue;
+		}
+
+		blocksize = size > arena->blocksize ? size : arena->blocksize;
+		block = (ujoArenaBlock*)ujo_allocator_realloc(arena->allocator, NULL, 0, 
+			UJO_ARENA_ALIGN(sizeof(ujoArenaBlock)) + blocksize);
+		return_val_if_fail(block, "allocation failed", NULL);
+		block->next = NULL;
+		block->size = blocksize;
+		block->used = 0;
+
+		if (arena->current)
+			arena->current->next = block;
+		else
+			arena->first = block;
+		arena->current = block;
+	}
+
+	ref = (ujoByte*)arena->current + UJO_ARENA_ALIGN(sizeof(ujoArenaBlock)) + arena->current->used;
+	arena->current->used += size;
+
+	return ref;
+};
+
+const ujoAllocator* ujo_arena_get_allocator(ujoArena* arena)
+{
+	return &arena->self;
+};
+
+/** 
+@endcond
+*/
@@ -50,6 +50,9 @@ static const char       *UJO_MAGIC = "\x5F\x55\x4A\x4F";
 // compression types
 #define UJO_COMPRESS_NONE   ((uint8_t)0x00)
 
+// size of the document header: magic, version and compression
+#define UJO_HEADER_SIZE     7
+
 /** 
  * \addtogroup ujo_element_types
  * @{
@@ -82,6 +85,9 @@ static const char       *UJO_MAGIC = "\x5F\x55\x4A\x4F";
 #define UJO_TYPE_TIME       ((uint8_t)0x12)
 #define UJO_TYPE_TIMESTAMP  ((uint8_t)0x13)
 
+// ujo null values are marked by the highest bit of the type id
+#define UJO_TYPE_NULL_FLAG  ((uint8_t)0x80)
+
 //ujo container types
 #define UJO_TYPE_LIST       ((uint8_t)0x30)
 #define UJO_TYPE_MAP        ((uint8_t)0x31)
@@ -0,0 +1,453 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ */
+
+#include "ujo_corpus.h"
+#include "ujo_errors.h"
+#include "ujo_log.h"
+#include "ujo_macros.h"
+#include "ujo_constants.h"
+#include <stdio.h>
+#include <string.h>
+
+/**
+@cond INTERNAL_DOCS
+*/
+
+#define CORPUS_MAX_BURST     64
+#define CORPUS_STATUS_ROWS  128
+#define CORPUS_STATUS_ROW    96
+#define CORPUS_CHANNELS      16
+#define CORPUS_CONFIG_DEPTH  10
+#define CORPUS_IMAGE_MIN     64
+#define CORPUS_IMAGE_MAX  65536
+#define CORPUS_CHUNK       1024
+#define CORPUS_BIN_IMAGE      1
+
+typedef struct {
+	ujo_writer*  w;
+	uint64_t     state;     // splitmix64 state
+	uint64_t     size;      // requested document size
+	uint64_t     left;      // octets missing before the current record
+	int64_t      clock;     // unix time of the current record
+	uint32_t     seq;
+} ujo_corpus_ctx;
+
+static const char* _ujo_corpus_kinds[] = {
+	"telemetry", "events", "status", "images", "config"
+};
+
+static const char* _ujo_corpus_messages[] = {
+	"link up", "link down", "threshold exceeded", "threshold cleared",
+	"firmware update started", "firmware update finished", "door opened",
+	"door closed", "battery low", "watchdog reset", "sensor timeout",
+	"configuration changed"
+};
+
+static const char* _ujo_corpus_words[] = {
+	"network", "mqtt", "broker", "interval", "retries", "timeout", "sensors",
+	"limits", "upper", "lower", "calibration", "offset", "gain", "logging",
+	"level", "modbus", "registers", "address", "baudrate", "security", "tls",
+	"certificate", "schedule", "enabled"
+};
+
+#define CORPUS_COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static __inline uint64_t _ujo_corpus_next(ujo_corpus_ctx* ctx)
+{
+	uint64_t z = (ctx->state += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static __inline uint32_t _ujo_corpus_range(ujo_corpus_ctx* ctx, uint32_t lo, uint32_t hi)
+{
+	return lo + (uint32_t)(_ujo_corpus_next(ctx) % (hi - lo + 1));
+}
+
+static __inline float64_t _ujo_corpus_real(ujo_corpus_ctx* ctx, float64_t lo, float64_t hi)
+{
+	return lo + (hi - lo) * ((float64_t)(_ujo_corpus_next(ctx) >> 11) / 9007199254740992.0);
+}
+
+static __inline ujoError _ujo_corpus_key(ujo_corpus_ctx* ctx, const char* key)
+{
+	return ujo_writer_add_string_c(ctx->w, key, strlen(key));
+}
+
+static ujoError _ujo_corpus_telemetry(ujo_corpus_ctx* ctx)
+{
+	ujoError err;
+	char     device[16];
+
+	sprintf(device, "node-%04u", _ujo_corpus_range(ctx, 0, 9999));
+	ctx->clock += _ujo_corpus_range(ctx, 1, 10);
+
+	return_on_err(ujo_writer_map_open(ctx->w));
+	return_on_err(_ujo_corpus_key(ctx, "device"));
+	return_on_err(_ujo_corpus_key(ctx, device));
+	return_on_err(_ujo_corpus_key(ctx, "seq"));
+	return_on_err(ujo_writer_add_uint_auto(ctx->w, ctx->seq++));
+	return_on_err(_ujo_corpus_key(ctx, "ts"));
+	return_on_err(ujo_writer_add_uxtime(ctx->w, ctx->clock));
+	return_on_err(_ujo_corpus_key(ctx, "temperature"));
+	return_on_err(ujo_writer_add_float32(ctx->w, (float32_t)_ujo_corpus_real(ctx, -20.0, 45.0)));
+	return_on_err(_ujo_corpus_key(ctx, "humidity"));
+	return_on_err(ujo_writer_add_float16(ctx->w, (float32_t)_ujo_corpus_real(ctx, 10.0, 95.0)));
+	return_on_err(_ujo_corpus_key(ctx, "voltage"));
+	return_on_err(ujo_writer_add_float32(ctx->w, (float32_t)_ujo_corpus_real(ctx, 3.0, 3.6)));
+	return_on_err(_ujo_corpus_key(ctx, "ok"));
+	return_on_err(ujo_writer_add_bool(ctx->w, _ujo_corpus_range(ctx, 0, 31) != 0));
+	return ujo_writer_map_close(ctx->w);
+}
+
+static ujoError _ujo_corpus_events(ujo_corpus_ctx* ctx)
+{
+	ujoError err;
+	uint32_t burst;
+	uint32_t i;
+	char     source[16];
+
+	// mostly single events, now and then a burst
+	burst = _ujo_corpus_range(ctx, 0, 7) ? _ujo_corpus_range(ctx, 1, 4) : _ujo_corpus_range(ctx, 8, CORPUS_MAX_BURST);
+	sprintf(source, "gw-%03u", _ujo_corpus_range(ctx, 0, 255));
+	ctx->clock += _ujo_corpus_range(ctx, 1, 600);
+
+	return_on_err(ujo_writer_list_open(ctx->w));
+	for (i = 0; i < burst; i++)
+	{
+		return_on_err(ujo_writer_map_open(ctx->w));
+		return_on_err(_ujo_corpus_key(ctx, "seq"));
+		return_on_err(ujo_writer_add_uint_auto(ctx->w, ctx->seq++));
+		return_on_err(_ujo_corpus_key(ctx, "ts"));
+		return_on_err(ujo_writer_add_uxtime(ctx->w, ctx->clock + i / 8));
+		return_on_err(_ujo_corpus_key(ctx, "source"));
+		return_on_err(_ujo_corpus_key(ctx, source));
+		return_on_err(_ujo_corpus_key(ctx, "code"));
+		return_on_err(ujo_writer_add_uint16(ctx->w, (uint16_t)_ujo_corpus_range(ctx, 100, 999)));
+		return_on_err(_ujo_corpus_key(ctx, "level"));
+		return_on_err(ujo_writer_add_uint8(ctx->w, (uint8_t)_ujo_corpus_range(ctx, 0, 4)));
+		return_on_err(_ujo_corpus_key(ctx, "message"));
+		return_on_err(_ujo_corpus_key(ctx, _ujo_corpus_messages[_ujo_corpus_range(ctx, 0, CORPUS_COUNT(_ujo_corpus_messages) - 1)]));
+		return_on_err(ujo_writer_map_close(ctx->w));
+	}
+	return ujo_writer_list_close(ctx->w);
+}
+
+static ujoError _ujo_corpus_status(ujo_corpus_ctx* ctx)
+{
+	ujoError err;
+	uint32_t rows;
+	uint32_t i;
+	uint32_t c;
+	char     name[16];
+
+	// a small document gets a short table
+	rows = _ujo_corpus_range(ctx, 16, CORPUS_STATUS_ROWS);
+	if (ctx->left / CORPUS_STATUS_ROW < rows)
+		rows = (uint32_t)(ctx->left / CORPUS_STATUS_ROW) + 1;
+	ctx->clock += 60;
+
+	return_on_err(ujo_writer_table_open(ctx->w));
+	return_on_err(_ujo_corpus_key(ctx, "device"));
+	return_on_err(_ujo_corpus_key(ctx, "online"));
+	return_on_err(_ujo_corpus_key(ctx, "seen"));
+	return_on_err(_ujo_corpus_key(ctx, "uptime"));
+	return_on_err(_ujo_corpus_key(ctx, "firmware"));
+	return_on_err(_ujo_corpus_key(ctx, "rssi"));
+	return_on_err(_ujo_corpus_key(ctx, "battery"));
+	return_on_err(_ujo_corpus_key(ctx, "load"));
+	for (c = 0; c < CORPUS_CHANNELS; c++)
+	{
+		sprintf(name, "ch%02u", c);
+		return_on_err(_ujo_corpus_key(ctx, name));
+	}
+	return_on_err(ujo_writer_table_end_columns(ctx->w));
+
+	for (i = 0; i < rows; i++)
+	{
+		sprintf(name, "dev-%05u", i);
+		return_on_err(_ujo_corpus_key(ctx, name));
+		return_on_err(ujo_writer_add_bool(ctx->w, _ujo_corpus_range(ctx, 0, 15) != 0));
+		return_on_err(ujo_writer_add_uxtime(ctx->w, ctx->clock - _ujo_corpus_range(ctx, 0, 3600)));
+		return_on_err(ujo_writer_add_uint32(ctx->w, _ujo_corpus_range(ctx, 0, 90 * 86400)));
+		return_on_err(_ujo_corpus_key(ctx, _ujo_corpus_range(ctx, 0, 3) ? "2.4.1" : "2.3.7"));
+		return_on_err(ujo_writer_add_int8(ctx->w, (int8_t)-(int32_t)_ujo_corpus_range(ctx, 30, 110)));
+		return_on_err(ujo_writer_add_uint8(ctx->w, (uint8_t)_ujo_corpus_range(ctx, 0, 100)));
+		return_on_err(ujo_writer_add_float16(ctx->w, (float32_t)_ujo_corpus_real(ctx, 0.0, 4.0)));
+
+		// offline channels are reported as null
+		for (c = 0; c < CORPUS_CHANNELS; c++)
+		{
+			if (_ujo_corpus_range(ctx, 0, 9) == 0)
+				err = ujo_writer_add_null(ctx->w, UJO_TYPE_FLOAT32);
+			else
+				err = ujo_writer_add_float32(ctx->w, (float32_t)_ujo_corpus_real(ctx, 0.0, 100.0));
+			if (err != UJO_SUCCESS)
+				return err;
+		}
+	}
+	return ujo_writer_table_close(ctx->w);
+}
+
+static ujoError _ujo_corpus_images(ujo_corpus_ctx* ctx)
+{
+	ujoError    err;
+	uint8_t     chunk[CORPUS_CHUNK];
+	uint32_t    n;
+	uint32_t    left;
+	uint32_t    i;
+	uint64_t    value;
+	char        camera[16];
+	ujoDateTime dt;
+
+	// the last image is cut down so that the document ends close to its size
+	n = _ujo_corpus_range(ctx, 2048, CORPUS_IMAGE_MAX);
+	if (ctx->left < n)
+		n = (uint32_t)ctx->left;
+	if (n < CORPUS_IMAGE_MIN)
+		n = CORPUS_IMAGE_MIN;
+
+	sprintf(camera, "cam-%02u", _ujo_corpus_range(ctx, 0, 63));
+	ctx->clock += _ujo_corpus_range(ctx, 1, 300);
+
+	dt.year        = (int16_t)_ujo_corpus_range(ctx, 2015, 2025);
+	dt.month       = (uint8_t)_ujo_corpus_range(ctx, 1, 12);
+	dt.day         = (uint8_t)_ujo_corpus_range(ctx, 1, 28);
+	dt.hour        = (uint8_t)_ujo_corpus_range(ctx, 0, 23);
+	dt.minute      = (uint8_t)_ujo_corpus_range(ctx, 0, 59);
+	dt.second      = (uint8_t)_ujo_corpus_range(ctx, 0, 59);
+	dt.millisecond = (uint16_t)_ujo_corpus_range(ctx, 0, 999);
+
+	return_on_err(ujo_writer_map_open(ctx->w));
+	return_on_err(_ujo_corpus_key(ctx, "camera"));
+	return_on_err(_ujo_corpus_key(ctx, camera));
+	return_on_err(_ujo_corpus_key(ctx, "taken"));
+	return_on_err(ujo_writer_add_timestamp(ctx->w, dt));
+	return_on_err(_ujo_corpus_key(ctx, "width"));
+	return_on_err(ujo_writer_add_uint16(ctx->w, 640));
+	return_on_err(_ujo_corpus_key(ctx, "height"));
+	return_on_err(ujo_writer_add_uint16(ctx->w, 480));
+	return_on_err(_ujo_corpus_key(ctx, "format"));
+	return_on_err(_ujo_corpus_key(ctx, "jpeg"));
+	return_on_err(_ujo_corpus_key(ctx, "data"));
+
+	// compressed image data looks random, it is streamed in chunks
+	return_on_err(ujo_writer_binary_begin(ctx->w, CORPUS_BIN_IMAGE, n));
+	for (left = n; left > 0; left -= i)
+	{
+		for (i = 0; i < CORPUS_CHUNK && i < left; i += 8)
+		{
+			value = _ujo_corpus_next(ctx);
+			memcpy(chunk + i, &value, 8);
+		}
+		i = left < CORPUS_CHUNK ? left : CORPUS_CHUNK;
+		return_on_err(ujo_writer_binary_append(ctx->w, chunk, i));
+	}
+	return_on_err(ujo_writer_binary_end(ctx->w));
+
+	return ujo_writer_map_close(ctx->w);
+}
+
+static ujoError _ujo_corpus_config_node(ujo_corpus_ctx* ctx, uint32_t depth)
+{
+	ujoError err;
+	uint32_t keys;
+	uint32_t i;
+
+	keys = _ujo_corpus_range(ctx, 2, 5);
+
+	return_on_err(ujo_writer_map_open(ctx->w));
+	for (i = 0; i < keys; i++)
+	{
+		return_on_err(_ujo_corpus_key(ctx, _ujo_corpus_words[_ujo_corpus_range(ctx, 0, CORPUS_COUNT(_ujo_corpus_words) - 1)]));
+
+		// the first key of a node leads deeper until the maximum depth
+		if (depth < CORPUS_CONFIG_DEPTH && (i == 0 || _ujo_corpus_range(ctx, 0, 9) == 0))
+		{
+			return_on_err(_ujo_corpus_config_node(ctx, depth + 1));
+			continue;
+		}
+
+		switch (_ujo_corpus_range(ctx, 0, 4))
+		{
+		case 0:
+			return_on_err(ujo_writer_add_bool(ctx->w, _ujo_corpus_range(ctx, 0, 1)));
+			break;
+		case 1:
+			return_on_err(ujo_writer_add_int_auto(ctx->w, (int64_t)_ujo_corpus_range(ctx, 0, 100000) - 1000));
+			break;
+		case 2:
+			return_on_err(ujo_writer_add_float64(ctx->w, _ujo_corpus_real(ctx, 0.0, 1000.0)));
+			break;
+		case 3:
+			return_on_err(ujo_writer_add_none(ctx->w));
+			break;
+		default:
+			return_on_err(_ujo_corpus_key(ctx, _ujo_corpus_words[_ujo_corpus_range(ctx, 0, CORPUS_COUNT(_ujo_corpus_words) - 1)]));
+			break;
+		}
+	}
+	return ujo_writer_map_close(ctx->w);
+}
+
+/**
+@endcond
+*/
+
+/**
+ * \addtogroup ujo_corpus
+ * @{
+ */
+
+/**
+ * @brief Write a generated workload document.
+ *
+ * The document is a list of records of the given kind. Records are added
+ * until the document reaches the requested size, so it is at least size
+ * octets long and exceeds it by less than one record. At least one record
+ * is always written.
+ *
+ * The content only depends on kind, seed and size. Equal arguments produce
+ * identical documents on every platform and for every writer type.
+ *
+ * @param w     ujo writer handle of a new document
+ * @param kind  kind of records
+ * @param seed  seed of the pseudo random values
+ * @param size  approximate size of the document in octets
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_corpus_write_file, ujo_corpus_get_kind
+ */
+ujoError ujo_corpus_write(ujo_writer* w, ujoCorpusKind kind, uint64_t seed, uint64_t size)
+{
+	ujoError       err;
+	ujo_corpus_ctx ctx;
+	uint64_t       position;
+
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);
+	report_error(kind <= UJO_CORPUS_CONFIG, "invalid corpus kind", UJO_ERR_INVALID_DATA);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.w     = w;
+	ctx.state = seed;
+	ctx.size  = size;
+	ctx.clock = 1577836800;     // 2020-01-01
+
+	return_on_err(ujo_writer_list_open(w));
+
+	do
+	{
+		position = _ujo_writer_get_position(w);
+		ctx.left = size > position ? size - position : 0;
+
+		switch (kind)
+		{
+		case UJO_CORPUS_TELEMETRY:
+			err = _ujo_corpus_telemetry(&ctx);
+			break;
+		case UJO_CORPUS_EVENTS:
+			err = _ujo_corpus_events(&ctx);
+			break;
+		case UJO_CORPUS_STATUS:
+			err = _ujo_corpus_status(&ctx);
+			break;
+		case UJO_CORPUS_IMAGES:
+			err = _ujo_corpus_images(&ctx);
+			break;
+		default:
+			err = _ujo_corpus_config_node(&ctx, 1);
+			break;
+		}
+		if (err != UJO_SUCCESS)
+			return err;
+
+		// one octet is left for the terminator of the list
+		position = _ujo_writer_get_position(w);
+	} while (position + 1 < size);
+
+	return ujo_writer_list_close(w);
+};
+
+/**
+ * @brief Write a generated workload document to a file.
+ *
+ * The file is created with a file writer and filled using
+ * ujo_corpus_write().
+ *
+ * @param filename  path of the UJO file to create
+ * @param kind      kind of records
+ * @param seed      seed of the pseudo random values
+ * @param size      approximate size of the file in octets
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_corpus_write
+ */
+ujoError ujo_corpus_write_file(const char* filename, ujoCorpusKind kind, uint64_t seed, uint64_t size)
+{
+	ujoError    err;
+	ujo_writer* w;
+
+	return_on_err(ujo_new_file_writer(&w, filename));
+
+	err = ujo_corpus_write(w, kind, seed, size);
+
+	ujo_free_writer(w);
+
+	return err;
+};
+
+/**
+ * @brief Get a corpus kind by its name.
+ *
+ * The names are "telemetry", "events", "status", "images" and "config".
+ *
+ * @param name  name of the kind
+ * @param kind  the kind
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_corpus_write
+ */
+ujoError ujo_corpus_get_kind(const char* name, ujoCorpusKind* kind)
+{
+	size_t i;
+
+	report_error(name, "invalid name", UJO_ERR_INVALID_DATA);
+
+	for (i = 0; i < CORPUS_COUNT(_ujo_corpus_kinds); i++)
+	{
+		if (strcmp(name, _ujo_corpus_kinds[i]) == 0)
+		{
+			*kind = (ujoCorpusKind)i;
+			return UJO_SUCCESS;
+		}
+	}
+
+	report_error(0, "unknown corpus kind", UJO_ERR_INVALID_DATA);
+};
+
+/* @} */
@@ -27,8 +27,37 @@
 /* global includes */
 #include "ujo_decl.h"
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+static ujoMemoryFunctions _ujo_memory = { calloc, realloc, free };
+
+/** 
+ * @brief Replace the memory functions of the library.
+ *
+ * All later calls of ujo_calloc(), ujo_realloc() and ujo_free() use the
+ * given functions. Memory has to be released by the functions it was
+ * allocated with, so they should be installed before any object is
+ * created and restored after all objects are released. The call is not
+ * thread safe.
+ *
+ * @param functions memory functions or NULL to use calloc, realloc and free
+ * @see ujo_calloc, ujoAllocator
+ */
+void ujo_set_memory_functions(const ujoMemoryFunctions* functions)
+{
+	if (functions == NULL)
+	{
+		_ujo_memory.calloc  = calloc;
+		_ujo_memory.realloc = realloc;
+		_ujo_memory.free    = free;
+	}
+	else
+	{
+		_ujo_memory = *functions;
+	}
+}
+
 /** 
  * @brief Calloc helper for ujo library.
  *
@@ -40,7 +69,7 @@
  */
 ujoPointer ujo_calloc(size_t count, size_t size)
 {
-   return calloc (count, size);
+   return _ujo_memory.calloc (count, size);
 }
 
 /** 
@@ -54,7 +83,7 @@ ujoPointer ujo_calloc(size_t count, size_t size)
  */
 ujoPointer ujo_realloc(ujoPointer ref, size_t size)
 {
-   return realloc (ref, size);
+   return _ujo_memory.realloc (ref, size);
 }
 
 /** 
@@ -67,9 +96,76 @@ void ujo_free (ujoPointer ref)
 {
 	if (ref)
 	{
-		free (ref);
+		_ujo_memory.free (ref);
 	}
 	return;
 }
 
+/** 
+ * @brief Calloc helper for a custom allocator.
+ *
+ * The memory is cleared after allocation. Without allocator ujo_calloc()
+ * is used.
+ *
+ * @param a allocator or NULL
+ * @param count How many items to allocate.
+ * @param size Size of one item.
+ * 
+ * @return A newly allocated pointer.
+ * @see ujo_allocator_free
+ */
+ujoPointer ujo_allocator_calloc(const ujoAllocator* a, size_t count, size_t size)
+{
+	ujoPointer ref;
+
+	if (a == NULL)
+		return ujo_calloc(count, size);
+
+	ref = a->alloc(a->user, count*size);
+	if (ref)
+		memset(ref, 0, count*size);
+	return ref;
+}
+
+/** 
+ * @brief Realloc helper for a custom allocator.
+ *
+ * Without allocator ujo_realloc() is used.
+ *
+ * @param a allocator or NULL
+ * @param ref the reference to reallocate.
+ * @param oldsize current size of the reference.
+ * @param size Size of the new reference.
+ * 
+ * @return A newly allocated pointer.
+ * @see ujo_allocator_free
+ */
+ujoPointer ujo_allocator_realloc(const ujoAllocator* a, ujoPointer ref, size_t oldsize, size_t size)
+{
+	if (a == NULL)
+		return ujo_realloc(ref, size);
+	if (ref == NULL)
+		return a->alloc(a->user, size);
+
+	return a->realloc(a->user, ref, oldsize, size);
+}
 
+/** 
+ * @brief Free helper for a custom allocator.
+ *
+ * Null references are ignored. Without allocator ujo_free() is used.
+ *
+ * @param a allocator or NULL
+ * @param ref The reference to clear.
+ */
+void ujo_allocator_free(const ujoAllocator* a, ujoPointer ref)
+{
+	if (a == NULL)
+	{
+		ujo_free(ref);
+	}
+	else if (ref)
+	{
+		a->free(a->user, ref);
+	}
+}
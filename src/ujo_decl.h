@@ -93,14 +93,58 @@ typedef void * ujoPointer;
 
 #define UJO_NULL_POINTER 0
 
+/**
+ * @brief Custom memory allocator.
+ *
+ * An allocator is passed to the _ex constructors of readers and writers.
+ * All memory of the object and of the data it creates is then allocated
+ * and released by the allocator functions. The user pointer is passed to
+ * each function. The structure has to stay valid as long as objects 
+ * created with it exist.
+ */
+typedef struct {
+	/** allocate size octets, the memory need not be initialized */
+	ujoPointer (*alloc)(ujoPointer user, size_t size);
+	/** resize a block of oldsize octets to size octets */
+	ujoPointer (*realloc)(ujoPointer user, ujoPointer ref, size_t oldsize, size_t size);
+	/** release a block */
+	void       (*free)(ujoPointer user, ujoPointer ref);
+	/** custom data passed to the functions */
+	ujoPointer user;
+} ujoAllocator;
+
+/**
+ * @brief Memory functions used by the library.
+ *
+ * The functions replace calloc, realloc and free for all memory that is
+ * not allocated by a custom allocator. They are installed with
+ * ujo_set_memory_functions().
+ */
+typedef struct {
+	/** allocate count items of size octets, the memory is cleared */
+	ujoPointer (*calloc)(size_t count, size_t size);
+	/** resize a block to size octets */
+	ujoPointer (*realloc)(ujoPointer ref, size_t size);
+	/** release a block */
+	void       (*free)(ujoPointer ref);
+} ujoMemoryFunctions;
+
 BEGIN_C_DECLS
 
+	void        ujo_set_memory_functions(const ujoMemoryFunctions* functions);
+
 	ujoPointer  ujo_calloc(size_t count, size_t size);
 
 	ujoPointer  ujo_realloc(ujoPointer ref, size_t size);
 
 	void        ujo_free(ujoPointer ref);
 
+	ujoPointer  ujo_allocator_calloc(const ujoAllocator* a, size_t count, size_t size);
+
+	ujoPointer  ujo_allocator_realloc(const ujoAllocator* a, ujoPointer ref, size_t oldsize, size_t size);
+
+	void        ujo_allocator_free(const ujoAllocator* a, ujoPointer ref);
+
 END_C_DECLS
 
 
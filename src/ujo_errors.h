@@ -36,6 +36,8 @@
 #define UJO_ERR_INVALID_OBJECT          5505    // an operation can only be performed on specific objects
 #define UJO_ERR_NOT_IMPLEMENTED         5506    // the feature is not yet implemented
 #define UJO_ERR_FILE                    5507    // a file operation error
+#define UJO_ERR_TEMPLATE_MISMATCH       5508    // a document does not match a template
+#define UJO_ERR_BUFFER_FULL             5509    // a fixed buffer has no room for the value
 
 
 #define report_error(expr,message,ecode) \
@@ -55,7 +57,7 @@
  * @param expr The expresion to check.
  */
 #define return_if_fail(expr, message) \
-if (!(expr)) {UJO_LOG(#message":expression failed %s", expr); return;}
+if (!(expr)) {UJO_LOG(#message":expression failed %s", #expr); return;}
 
 /** 
  * @brief Allows to check a condition and return the given value if it
@@ -65,7 +67,7 @@ if (!(expr)) {UJO_LOG(#message":expression failed %s", expr); return;}
  * @param val The value to return if the expression is not meet.
  */
 #define return_val_if_fail(expr, message, val) \
-if (!(expr)) {UJO_LOG(#message":expression failed %s", expr); return val;}
+if (!(expr)) {UJO_LOG(#message":expression failed %s", #expr); return val;}
 
 
 #endif
\ No newline at end of file
@@ -26,65 +26,85 @@
 
 /* global includes */
 #include "ujo_log.h"
+#include "ujo_errors.h"
 
 #include <stdio.h>
 #include <stdarg.h>
-#include <time.h>
-#ifndef OS_X
-  #include <malloc.h>
-#endif // OS_X
 #include <string.h>
- 
 
-void log_print(char* filename, int line, char *fmt,...)
+#define UJO_LOG_MESSAGE_SIZE 512
+
+ujoLogLevel _ujo_log_level = UJO_LOG_OFF;
+
+static ujoLogFunc _ujo_log_sink      = NULL;
+static ujoPointer _ujo_log_sink_data = NULL;
+
+/** 
+ * \addtogroup ujo_module
+ * @{
+ */
+
+/**
+ * @brief Set the level of log messages.
+ *
+ * Messages up to the given level are passed to the log sink. The
+ * default level is UJO_LOG_OFF. The library reports failed operations
+ * with UJO_LOG_ERROR. The setting is global and not thread safe.
+ *
+ * @param level the highest level to log
+ *
+ * @return UJO error code or UJO_SUCCESS, UJO_ERR_NOT_IMPLEMENTED if the
+ * library is built without UJO_ENABLE_LOG
+ * @sa ujo_set_log_sink
+ */
+ujoError ujo_set_log_level(ujoLogLevel level)
+{
+#ifdef UJO_ENABLE_LOG
+	report_error(level >= UJO_LOG_OFF && level <= UJO_LOG_DEBUG, "invalid log level", UJO_ERR_INVALID_DATA);
+	_ujo_log_level = level;
+	return UJO_SUCCESS;
+#else
+	return UJO_ERR_NOT_IMPLEMENTED;
+#endif
+}
+
+/**
+ * @brief Set the function receiving log messages.
+ *
+ * Without a sink messages are written to stderr. The setting is global 
+ * and not thread safe.
+ *
+ * @param f    log function or NULL to write to stderr
+ * @param data custom data passed to the function
+ *
+ * @return UJO error code or UJO_SUCCESS, UJO_ERR_NOT_IMPLEMENTED if the
+ * library is built without UJO_ENABLE_LOG
+ * @sa ujo_set_log_level
+ */
+ujoError ujo_set_log_sink(ujoLogFunc f, ujoPointer data)
+{
+#ifdef UJO_ENABLE_LOG
+	_ujo_log_sink      = f;
+	_ujo_log_sink_data = data;
+	return UJO_SUCCESS;
+#else
+	return UJO_ERR_NOT_IMPLEMENTED;
+#endif
+}
+
+/* @} */
+
+void log_print(ujoLogLevel level, const char* filename, int line, const char *fmt,...)
 {
-    
-#ifdef WRITE_DEBUG_LOG	
 	va_list list;
-    char *p, *r;
-    int e;
-	time_t t;
-    
-	time(&t); 
-    printf("%s ", ctime(&t));
-    va_start( list, fmt );
- 
-    for ( p = fmt ; *p ; ++p )
-    {
-        if ( *p != '%' )//If simple string
-        {
-            fputc( *p, stdout );
-        }
-        else
-        {
-            switch ( *++p )
-            {
-                /* string */
-            case 's':
-            {
-                r = va_arg( list, char * );
- 
-                fprintf(stdout, "%s", r);
-                continue;
-            }
- 
-            /* integer */
-            case 'd':
-            {
-                e = va_arg( list, int );
- 
-                fprintf(stdout, "%d", e);
-                continue;
-            }
- 
-            default:
-                fputc( *p, stdout );
-            }
-        }
-    }
-    va_end( list );
-    fprintf(stdout, " [%s][line: %d] ",filename,line);
-    fprintf(stdout, "\n");
-	fflush(stdout);
-#endif /* WRITE_DEBUG_LOG */ 
-}
\ No newline at end of file
+	char    message[UJO_LOG_MESSAGE_SIZE];
+
+	va_start(list, fmt);
+	vsnprintf(message, sizeof(message), fmt, list);
+	va_end(list);
+
+	if (_ujo_log_sink)
+		_ujo_log_sink(level, filename, line, message, _ujo_log_sink_data);
+	else
+		fprintf(stderr, "%s [%s][line: %d]\n", message, filename, line);
+}
@@ -27,17 +27,78 @@
 #ifndef __UJO_LOG_H__
 #define __UJO_LOG_H__
 
-#include "ujo_decl.h"
+#include "ujo_types.h"
+#include "ujo_config.h"
 #include <stdio.h>
 #include <stdlib.h>
 
-#define UJO_LOG(...) log_print(__FILE__, __LINE__, __VA_ARGS__ )
+/** 
+ * \addtogroup ujo_module
+ * @{
+ */
+
+/**
+ * @brief Log levels.
+ */
+typedef enum {
+	/** no messages */
+	UJO_LOG_OFF   = 0,
+	/** failed operations */
+	UJO_LOG_ERROR = 1,
+	/** all messages */
+	UJO_LOG_DEBUG = 2
+} ujoLogLevel;
+
+/**
+ * @brief Receive a log message.
+ *
+ * @param level   level of the message
+ * @param file    source file reporting the message
+ * @param line    line in the source file
+ * @param message formatted message
+ * @param data    custom data passed to ujo_set_log_sink()
+ */
+typedef void (*ujoLogFunc)(ujoLogLevel level, const char* file, int line, const char* message, ujoPointer data);
+
+/* @} */
 
+/** 
+@cond INTERNAL_DOCS
+*/
+
+/*
+ * Without UJO_ENABLE_LOG messages are not compiled in at all. Otherwise
+ * a message costs one comparison as long as its level is not enabled.
+ */
+#ifdef UJO_ENABLE_LOG
+#define UJO_LOG_AT(level, ...) \
+	do { if (_ujo_log_level >= (level)) log_print(level, __FILE__, __LINE__, __VA_ARGS__); } while (0)
+#else
+#define UJO_LOG_AT(level, ...) do { } while (0)
+#endif
+
+#define UJO_LOG(...) UJO_LOG_AT(UJO_LOG_ERROR, __VA_ARGS__)
+
+/**
+@endcond
+*/
 
 BEGIN_C_DECLS
 
-	void log_print(char* filename, int line, char *fmt,...);
+	ujoError ujo_set_log_level(ujoLogLevel level);
+
+	ujoError ujo_set_log_sink(ujoLogFunc f, ujoPointer data);
+
+	/** 
+	@cond INTERNAL_DOCS
+	*/
+	extern ujoLogLevel _ujo_log_level;
+
+	void log_print(ujoLogLevel level, const char* filename, int line, const char *fmt,...);
+	/**
+	@endcond
+	*/
 
 END_C_DECLS
 
-#endif
\ No newline at end of file
+#endif
@@ -28,6 +28,7 @@
 #define __UJO_MACROS_H__
 
 #include "ujo_writer.h"
+#include "ujo_config.h"
 
 #define writer_prev_state_if(writer, expr) \
 	if (expr) {_ujo_writer_state_prev(writer)}
@@ -43,4 +44,30 @@
  */
 #define ujo_new(type, count) (type *) ujo_calloc (count, sizeof (type))
 
+/** 
+ * @brief Support macro to allocate memory with a custom allocator.
+ *
+ * @param allocator The allocator or NULL for the default allocation.
+ * @param type The type to allocate
+ * @param count How many items to allocate.
+ * 
+ * @return A newly allocated pointer.
+ */
+#define ujo_new_ex(allocator, type, count) (type *) ujo_allocator_calloc (allocator, count, sizeof (type))
+
+/** 
+ * @brief Support macro to add to a counter of a statistics structure.
+ *
+ * The macro is empty if the library is built without UJO_ENABLE_STATS.
+ *
+ * @param stats The statistics structure.
+ * @param counter The member to increase.
+ * @param n The value to add.
+ */
+#ifdef UJO_ENABLE_STATS
+#define ujo_stats_add(stats, counter, n) ((stats).counter += (n))
+#else
+#define ujo_stats_add(stats, counter, n)
+#endif
+
 #endif
\ No newline at end of file
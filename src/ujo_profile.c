@@ -0,0 +1,871 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ */
+
+#include "ujo_profile.h"
+#include "ujo_writer.h"
+#include "ujo_errors.h"
+#include "ujo_log.h"
+#include "ujo_macros.h"
+#include "ujo_constants.h"
+#include <string.h>
+#include <stdlib.h>
+
+/** 
+@cond INTERNAL_DOCS
+*/
+
+#define UJO_PROFILE_DEFAULT_ENTRIES 4096
+
+typedef struct {
+	ujoProfileEntry  e;
+	uint64_t         hash;
+} ujo_profile_item;
+
+/* strings of one kind, limited to maxentries distinct values */
+typedef struct {
+	ujo_profile_item* items;
+	size_t            count;
+	// item index + 1, 0 for an empty slot
+	uint32_t*         slots;
+	size_t            mask;
+} ujo_profile_dict;
+
+/* open container */
+typedef struct {
+	ujoTypeId  type;
+	uint64_t   start;
+	// map: the next element is a key
+	ujoBool    key;
+	// table: the column names are complete
+	ujoBool    values;
+	uint32_t   column;
+	uint32_t   columns;
+	// table: item index + 1 of the column names, 0 if not tracked
+	uint32_t*  names;
+	uint32_t   size;
+} ujo_profile_frame;
+
+struct _ujo_profile {
+	size_t              maxentries;
+	ujoProfileSummary   summary;
+	ujo_profile_dict    dicts[3];
+
+	ujo_profile_frame*  frames;
+	size_t              depth;
+	size_t              size;
+};
+
+/* position of an element in its container */
+typedef enum {
+	PROFILE_VALUE,
+	PROFILE_KEY,
+	PROFILE_COLUMN
+} ujoProfileRole;
+
+static __inline uint64_t _ujo_profile_hash(ujoTypeId subtype, const uint8_t* data, uint32_t size)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL ^ subtype;
+	uint32_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/* count a string, return its item index + 1 or 0 if the dictionary is full */
+static uint32_t _ujo_profile_lookup(ujo_profile* p, ujoProfileTable table, ujoTypeId subtype, 
+	const uint8_t* data, uint32_t size, uint64_t bytes)
+{
+	ujo_profile_dict* d = &p->dicts[table];
+	ujo_profile_item* item;
+	uint64_t          hash = _ujo_profile_hash(subtype, data, size);
+	uint32_t          namesize = size < UJO_PROFILE_NAME_SIZE ? size : UJO_PROFILE_NAME_SIZE;
+	size_t            slot;
+
+	for (slot = (size_t)hash & d->mask; d->slots[slot]; slot = (slot + 1) & d->mask)
+	{
+		item = &d->items[d->slots[slot]-1];
+		if (item->hash == hash && item->e.size == size && item->e.subtype == subtype &&
+			memcmp(item->e.name, data, namesize) == 0)
+		{
+			item->e.count++;
+			item->e.bytes += bytes;
+			return d->slots[slot];
+		}
+	}
+
+	if (d->count == p->maxentries)
+	{
+		p->summary.untracked[table]++;
+		return 0;
+	}
+
+	item = &d->items[d->count++];
+	memcpy(item->e.name, data, namesize);
+	item->e.namesize = namesize;
+	item->e.size     = size;
+	item->e.subtype  = subtype;
+	item->e.count    = 1;
+	item->e.bytes    = bytes;
+	item->hash       = hash;
+	d->slots[slot]   = (uint32_t)d->count;
+	p->summary.distinct[table]++;
+
+	return (uint32_t)d->count;
+}
+
+static ujoError _ujo_profile_push(ujo_profile* p, ujoTypeId type, uint64_t start)
+{
+	ujo_profile_frame* temp;
+	ujo_profile_frame* frame;
+
+	if (p->depth == p->size)
+	{
+		temp = (ujo_profile_frame*)ujo_realloc(p->frames, (p->size + 16) * sizeof(ujo_profile_frame));
+		report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+		memset(temp + p->size, 0, 16 * sizeof(ujo_profile_frame));
+		p->frames = temp;
+		p->size += 16;
+	}
+
+	frame = &p->frames[p->depth++];
+	frame->type    = type;
+	frame->start   = start;
+	frame->key     = ujoTrue;
+	frame->values  = ujoFalse;
+	frame->column  = 0;
+	frame->columns = 0;
+
+	return UJO_SUCCESS;
+}
+
+static ujoError _ujo_profile_add_column(ujo_profile_frame* frame, uint32_t name)
+{
+	uint32_t* temp;
+
+	if (frame->columns == frame->size)
+	{
+		temp = (uint32_t*)ujo_realloc(frame->names, (frame->size + 16) * sizeof(uint32_t));
+		report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+		frame->names = temp;
+		frame->size += 16;
+	}
+	frame->names[frame->columns++] = name;
+
+	return UJO_SUCCESS;
+}
+
+/* a value of the given size is complete, advance its container */
+static void _ujo_profile_complete(ujo_profile* p, uint64_t bytes)
+{
+	ujo_profile_frame* frame;
+	ujo_profile_item*  item;
+
+	if (p->depth == 0)
+		return;
+
+	frame = &p->frames[p->depth-1];
+	switch (frame->type)
+	{
+	case UJO_TYPE_MAP:
+		frame->key = (ujoBool)!frame->key;
+		break;
+	case UJO_TYPE_TABLE:
+		if (!frame->values || frame->columns == 0)
+			break;
+		if (frame->names[frame->column])
+		{
+			item = &p->dicts[UJO_PROFILE_COLUMNS].items[frame->names[frame->column]-1];
+			item->e.values++;
+			item->e.valuebytes += bytes;
+		}
+		frame->column = (frame->column + 1) % frame->columns;
+		break;
+	default:
+		break;
+	}
+}
+
+static ujoProfileRole _ujo_profile_role(ujo_profile* p)
+{
+	ujo_profile_frame* frame;
+
+	if (p->depth == 0)
+		return PROFILE_VALUE;
+
+	frame = &p->frames[p->depth-1];
+	if (frame->type == UJO_TYPE_MAP && frame->key)
+		return PROFILE_KEY;
+	if (frame->type == UJO_TYPE_TABLE && !frame->values)
+		return PROFILE_COLUMN;
+	return PROFILE_VALUE;
+}
+
+static ujoError _ujo_profile_string(ujo_profile* p, ujo_element* e, uint64_t bytes)
+{
+	ujoError  err;
+	ujoTypeId subtype;
+	char*     c_string;
+	uint8_t*  u8_string;
+	uint16_t* u16_string;
+	uint32_t* u32_string;
+	uint8_t*  data;
+	uint32_t  n;
+	uint32_t  size;
+	uint32_t  bucket;
+	uint32_t  name;
+
+	return_on_err(ujo_element_get_string_type(e, &subtype));
+
+	switch (subtype)
+	{
+	case UJO_SUB_STRING_C:
+		return_on_err(ujo_element_get_string_c(e, &c_string, &n));
+		data = (uint8_t*)c_string;
+		size = n;
+		break;
+	case UJO_SUB_STRING_U8:
+		return_on_err(ujo_element_get_string_u8(e, &u8_string, &n));
+		data = u8_string;
+		size = n;
+		break;
+	case UJO_SUB_STRING_U16:
+		return_on_err(ujo_element_get_string_u16(e, &u16_string, &n));
+		data = (uint8_t*)u16_string;
+		size = n * (uint32_t)sizeof(uint16_t);
+		break;
+	case UJO_SUB_STRING_U32:
+		return_on_err(ujo_element_get_string_u32(e, &u32_string, &n));
+		data = (uint8_t*)u32_string;
+		size = n * (uint32_t)sizeof(uint32_t);
+		break;
+	default:
+		report_error(0, "invalid string subtype", UJO_ERR_INVALID_DATA);
+	}
+
+	p->summary.strings[subtype]++;
+	p->summary.stringbytes[subtype] += bytes;
+	for (bucket = 0; bucket < UJO_PROFILE_LENGTHS - 1 && (size >> bucket) != 0; bucket++);
+	p->summary.lengths[bucket]++;
+
+	switch (_ujo_profile_role(p))
+	{
+	case PROFILE_KEY:
+		_ujo_profile_lookup(p, UJO_PROFILE_KEYS, subtype, data, size, bytes);
+		break;
+	case PROFILE_COLUMN:
+		name = _ujo_profile_lookup(p, UJO_PROFILE_COLUMNS, subtype, data, size, bytes);
+		return _ujo_profile_add_column(&p->frames[p->depth-1], name);
+	default:
+		_ujo_profile_lookup(p, UJO_PROFILE_STRINGS, subtype, data, size, bytes);
+		break;
+	}
+
+	_ujo_profile_complete(p, bytes);
+	return UJO_SUCCESS;
+}
+
+static __inline uint32_t _ujo_profile_int_size(int64_t value)
+{
+	if (value >= INT8_MIN && value <= INT8_MAX)
+		return 1;
+	if (value >= INT16_MIN && value <= INT16_MAX)
+		return 2;
+	if (value >= INT32_MIN && value <= INT32_MAX)
+		return 4;
+	return 8;
+}
+
+static __inline uint32_t _ujo_profile_uint_size(uint64_t value)
+{
+	if (value <= UINT8_MAX)
+		return 1;
+	if (value <= UINT16_MAX)
+		return 2;
+	if (value <= UINT32_MAX)
+		return 4;
+	return 8;
+}
+
+static __inline uint32_t _ujo_profile_float_size(float64_t value)
+{
+	switch (_ujo_writer_float_type(value))
+	{
+	case UJO_TYPE_FLOAT16:
+		return 2;
+	case UJO_TYPE_FLOAT32:
+		return 4;
+	default:
+		return 8;
+	}
+}
+
+/* octets saved by writing a number in its smallest lossless type */
+static ujoError _ujo_profile_narrowing(ujo_profile* p, ujo_element* e, ujoTypeId type)
+{
+	ujoError  err;
+	int64_t   i64;
+	int32_t   i32;
+	int16_t   i16;
+	uint64_t  u64;
+	uint32_t  u32;
+	uint16_t  u16;
+	float64_t f64;
+	float32_t f32;
+
+	switch (type)
+	{
+	case UJO_TYPE_INT64:
+		return_on_err(ujo_element_get_int64(e, &i64));
+		p->summary.narrowing += 8 - _ujo_profile_int_size(i64);
+		break;
+	case UJO_TYPE_INT32:
+		return_on_err(ujo_element_get_int32(e, &i32));
+		p->summary.narrowing += 4 - _ujo_profile_int_size(i32);
+		break;
+	case UJO_TYPE_INT16:
+		return_on_err(ujo_element_get_int16(e, &i16));
+		p->summary.narrowing += 2 - _ujo_profile_int_size(i16);
+		break;
+	case UJO_TYPE_UINT64:
+		return_on_err(ujo_element_get_uint64(e, &u64));
+		p->summary.narrowing += 8 - _ujo_profile_uint_size(u64);
+		break;
+	case UJO_TYPE_UINT32:
+		return_on_err(ujo_element_get_uint32(e, &u32));
+		p->summary.narrowing += 4 - _ujo_profile_uint_size(u32);
+		break;
+	case UJO_TYPE_UINT16:
+		return_on_err(ujo_element_get_uint16(e, &u16));
+		p->summary.narrowing += 2 - _ujo_profile_uint_size(u16);
+		break;
+	case UJO_TYPE_FLOAT64:
+		return_on_err(ujo_element_get_float64(e, &f64));
+		p->summary.narrowing += 8 - _ujo_profile_float_size(f64);
+		break;
+	case UJO_TYPE_FLOAT32:
+		return_on_err(ujo_element_get_float32(e, &f32));
+		p->summary.narrowing += 4 - _ujo_profile_float_size(f32);
+		break;
+	default:
+		break;
+	}
+
+	return UJO_SUCCESS;
+}
+
+/* the element was read from position start to end */
+static ujoError _ujo_profile_element(ujo_profile* p, ujo_element* e, uint64_t start, uint64_t end)
+{
+	ujoError           err;
+	ujoTypeId          type;
+	ujo_profile_frame* frame;
+	uint64_t           bytes = end - start;
+
+	return_on_err(ujo_element_get_type(e, &type));
+
+	p->summary.elements[type]++;
+	p->summary.typebytes[type] += bytes;
+
+	switch (type)
+	{
+	case UJO_TYPE_LIST:
+	case UJO_TYPE_MAP:
+	case UJO_TYPE_TABLE:
+		report_error(_ujo_profile_role(p) == PROFILE_VALUE, "container not allowed", UJO_ERR_INVALID_DATA);
+		return _ujo_profile_push(p, type, start);
+	case UJO_TERMINATOR:
+		report_error(p->depth > 0, "unexpected terminator", UJO_ERR_INVALID_DATA);
+		frame = &p->frames[p->depth-1];
+		if (frame->type == UJO_TYPE_TABLE && !frame->values)
+		{
+			frame->values = ujoTrue;
+			return UJO_SUCCESS;
+		}
+		p->depth--;
+		_ujo_profile_complete(p, end - frame->start);
+		return UJO_SUCCESS;
+	case UJO_TYPE_STRING:
+		return _ujo_profile_string(p, e, bytes);
+	default:
+		break;
+	}
+
+	return_on_err(_ujo_profile_narrowing(p, e, type));
+	if (_ujo_profile_role(p) == PROFILE_COLUMN)
+		return _ujo_profile_add_column(&p->frames[p->depth-1], 0);
+	_ujo_profile_complete(p, bytes);
+
+	return UJO_SUCCESS;
+}
+
+/* binary chunks are dropped, only the size of the element is profiled */
+static ujoError _ujo_profile_skip_binary(uint8_t type, const uint8_t* chunk, uint32_t n, uint32_t offset, uint32_t total, ujoPointer data)
+{
+	return UJO_SUCCESS;
+}
+
+/* octets saved by storing repeated strings once and referring to them by index */
+static uint64_t _ujo_profile_savings(ujo_profile_dict* d)
+{
+	ujo_profile_item* item;
+	uint64_t          reference;
+	uint64_t          cost;
+	uint64_t          savings = 0;
+	size_t            i;
+
+	// type id and the smallest unsigned index
+	reference = 1 + (d->count <= 0x100 ? 1 : d->count <= 0x10000 ? 2 : 4);
+
+	for (i = 0; i < d->count; i++)
+	{
+		item = &d->items[i];
+		cost = item->e.bytes / item->e.count + item->e.count * reference;
+		if (item->e.bytes > cost)
+			savings += item->e.bytes - cost;
+	}
+	return savings;
+}
+
+static const char* _ujo_profile_type_name(ujoTypeId type)
+{
+	switch (type & ~UJO_TYPE_NULL_FLAG)
+	{
+	case UJO_TERMINATOR:      return "terminator";
+	case UJO_TYPE_FLOAT64:    return "float64";
+	case UJO_TYPE_FLOAT32:    return "float32";
+	case UJO_TYPE_FLOAT16:    return "float16";
+	case UJO_TYPE_STRING:     return "string";
+	case UJO_TYPE_INT64:      return "int64";
+	case UJO_TYPE_INT32:      return "int32";
+	case UJO_TYPE_INT16:      return "int16";
+	case UJO_TYPE_INT8:       return "int8";
+	case UJO_TYPE_UINT64:     return "uint64";
+	case UJO_TYPE_UINT32:     return "uint32";
+	case UJO_TYPE_UINT16:     return "uint16";
+	case UJO_TYPE_UINT8:      return "uint8";
+	case UJO_TYPE_BOOL:       return "bool";
+	case UJO_TYPE_BIN:        return "binary";
+	case UJO_TYPE_NONE:       return "none";
+	case UJO_TYPE_UX_TIME:    return "uxtime";
+	case UJO_TYPE_DATE:       return "date";
+	case UJO_TYPE_TIME:       return "time";
+	case UJO_TYPE_TIMESTAMP:  return "timestamp";
+	case UJO_TYPE_LIST:       return "list";
+	case UJO_TYPE_MAP:        return "map";
+	case UJO_TYPE_TABLE:      return "table";
+	default:                  return "unknown";
+	}
+}
+
+/* print the known part of a string as JSON string */
+static void _ujo_profile_print_name(FILE* f, const ujoProfileEntry* entry)
+{
+	uint32_t width;
+	uint32_t unit;
+	uint32_t i;
+	uint16_t u16;
+
+	switch (entry->subtype)
+	{
+	case UJO_SUB_STRING_U16: width = sizeof(uint16_t); break;
+	case UJO_SUB_STRING_U32: width = sizeof(uint32_t); break;
+	default:                 width = sizeof(uint8_t); break;
+	}
+
+	fputc('"', f);
+	for (i = 0; i + width <= entry->namesize; i += width)
+	{
+		switch (width)
+		{
+		case sizeof(uint16_t): memcpy(&u16, entry->name + i, width); unit = u16; break;
+		case sizeof(uint32_t): memcpy(&unit, entry->name + i, width); break;
+		default:               unit = entry->name[i]; break;
+		}
+
+		if (unit == 0 && entry->subtype == UJO_SUB_STRING_C)
+			break;
+		if (unit == '"' || unit == '\\')
+			fprintf(f, "\\%c", (char)unit);
+		else if (unit >= 0x20 && unit < 0x7F)
+			fputc((int)unit, f);
+		else if (unit < 0x10000)
+			fprintf(f, "\\u%04x", unit);
+		else
+			fputc('?', f);
+	}
+	if (entry->namesize < entry->size)
+		fputs("...", f);
+	fputc('"', f);
+}
+
+static int _ujo_profile_compare(const void* a, const void* b)
+{
+	const ujo_profile_item* x = *(const ujo_profile_item* const*)a;
+	const ujo_profile_item* y = *(const ujo_profile_item* const*)b;
+
+	if (x->e.bytes + x->e.valuebytes != y->e.bytes + y->e.valuebytes)
+		return (x->e.bytes + x->e.valuebytes < y->e.bytes + y->e.valuebytes) ? 1 : -1;
+	return (x < y) ? -1 : (x > y);
+}
+
+/* print the top entries of a dictionary by octets */
+static ujoError _ujo_profile_print_table(ujo_profile* p, FILE* f, ujoProfileTable table, const char* label, size_t top)
+{
+	ujo_profile_dict*  d = &p->dicts[table];
+	ujo_profile_item** sorted;
+	size_t             i;
+
+	fprintf(f, "  \"%s\": {\"distinct\": %llu, \"untracked\": %llu, \"top\": [", label,
+		(unsigned long long)p->summary.distinct[table], (unsigned long long)p->summary.untracked[table]);
+
+	if (top > d->count)
+		top = d->count;
+	if (top > 0)
+	{
+		sorted = (ujo_profile_item**)ujo_calloc(d->count, sizeof(ujo_profile_item*));
+		report_error(sorted, "allocation failed", UJO_ERR_ALLOCATION);
+		for (i = 0; i < d->count; i++)
+			sorted[i] = &d->items[i];
+		qsort(sorted, d->count, sizeof(ujo_profile_item*), _ujo_profile_compare);
+
+		for (i = 0; i < top; i++)
+		{
+			fprintf(f, "%s\n    {\"name\": ", i ? "," : "");
+			_ujo_profile_print_name(f, &sorted[i]->e);
+			fprintf(f, ", \"count\": %llu, \"bytes\": %llu", 
+				(unsigned long long)sorted[i]->e.count, (unsigned long long)sorted[i]->e.bytes);
+			if (table == UJO_PROFILE_COLUMNS)
+				fprintf(f, ", \"values\": %llu, \"valuebytes\": %llu", 
+					(unsigned long long)sorted[i]->e.values, (unsigned long long)sorted[i]->e.valuebytes);
+			fputc('}', f);
+		}
+		ujo_free(sorted);
+	}
+	fprintf(f, "%s]},\n", top ? "\n  " : "");
+
+	return UJO_SUCCESS;
+}
+
+/**
+@endcond
+*/
+
+/** 
+ * \addtogroup ujo_profile
+ * @{
+ */
+
+/**
+ * @brief Create a profiler.
+ *
+ * The profiler collects where the octets of one or more documents are 
+ * spent. Map keys, table column names and string values are tracked up
+ * to maxentries distinct strings each, so the memory used does not depend
+ * on the size of the documents. Strings are identified by a 64 bit hash, 
+ * their length and their first octets.
+ *
+ * @param p          reference to the profiler handle
+ * @param maxentries distinct strings tracked per table, 0 for a default of 4096
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_free_profile, ujo_profile_read
+ */
+ujoError ujo_new_profile(ujo_profile** p, size_t maxentries)
+{
+	ujo_profile* newhdl;
+	size_t       slots;
+	int          i;
+
+	report_error(p, "invalid handle reference", UJO_ERR_INVALID_DATA);
+	report_error(maxentries < UINT32_MAX / 2, "too many entries", UJO_ERR_INVALID_DATA);
+
+	if (maxentries == 0)
+		maxentries = UJO_PROFILE_DEFAULT_ENTRIES;
+	for (slots = 16; slots < 2 * maxentries; slots <<= 1);
+
+	newhdl = (ujo_profile*)ujo_calloc(1, sizeof(ujo_profile));
+	report_error(newhdl, "allocation failed", UJO_ERR_ALLOCATION);
+	newhdl->maxentries = maxentries;
+
+	for (i = 0; i < 3; i++)
+	{
+		newhdl->dicts[i].items = (ujo_profile_item*)ujo_calloc(maxentries, sizeof(ujo_profile_item));
+		newhdl->dicts[i].slots = (uint32_t*)ujo_calloc(slots, sizeof(uint32_t));
+		newhdl->dicts[i].mask  = slots - 1;
+		if (newhdl->dicts[i].items == NULL || newhdl->dicts[i].slots == NULL)
+		{
+			ujo_free_profile(newhdl);
+			report_error(ujoFalse, "allocation failed", UJO_ERR_ALLOCATION);
+		}
+	}
+
+	*p = newhdl;
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Dispose a profiler.
+ *
+ * @param p    profiler handle
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_new_profile
+ */
+ujoError ujo_free_profile(ujo_profile* p)
+{
+	size_t i;
+
+	report_error(p, "invalid handle", UJO_ERR_INVALID_DATA);
+
+	for (i = 0; i < 3; i++)
+	{
+		ujo_free(p->dicts[i].items);
+		ujo_free(p->dicts[i].slots);
+	}
+	for (i = 0; i < p->size; i++)
+		ujo_free(p->frames[i].names);
+	ujo_free(p->frames);
+	ujo_free(p);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Profile a document.
+ *
+ * All elements of the document are read one by one from the reader and
+ * added to the profile. Repeated calls accumulate the results of several
+ * documents. Binary values are skipped in chunks unless an onBinaryChunk
+ * callback is already set, so they are never held in memory at once.
+ * Strings are still read whole.
+ *
+ * @param p    profiler handle
+ * @param r    ujo reader handle positioned at the start of a document
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_profile_read_file, ujo_profile_get_summary
+ */
+ujoError ujo_profile_read(ujo_profile* p, ujo_reader* r)
+{
+	ujoError     err;
+	ujo_element* e;
+	ujoBool      eod;
+	ujoBool      skip;
+	uint64_t     begin;
+	uint64_t     start;
+	uint64_t     end;
+
+	report_error(p, "invalid handle", UJO_ERR_INVALID_DATA);
+	report_error(r, "invalid reader handle", UJO_ERR_INVALID_DATA);
+
+	/* binary sizes are taken from the reader position, the data is not needed */
+	skip = !_ujo_reader_streams_binary(r);
+	if (skip)
+	{
+		return_on_err(ujo_reader_set_on_binary_chunk(r, _ujo_profile_skip_binary, NULL, 0));
+	}
+
+	p->depth = 0;
+	begin = _ujo_reader_get_position(r);
+	start = begin + UJO_HEADER_SIZE;
+
+	err = ujo_reader_get_first(r, &e, &eod);
+
+	while (err == UJO_SUCCESS && !eod)
+	{
+		end = _ujo_reader_get_position(r);
+		err = _ujo_profile_element(p, e, start, end);
+		ujo_free_element(e);
+		start = end;
+
+		if (err == UJO_SUCCESS)
+			err = ujo_reader_get_next(r, &e, &eod);
+	}
+	if (skip)
+		ujo_reader_set_on_binary_chunk(r, NULL, NULL, 0);
+	return_on_err(err);
+
+	p->summary.documents++;
+	p->summary.bytes += _ujo_reader_get_position(r) - begin;
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Profile an UJO file.
+ *
+ * The file is read with a file reader and added to the profile using 
+ * ujo_profile_read().
+ *
+ * @param p         profiler handle
+ * @param filename  path of the UJO file to read
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_profile_read
+ */
+ujoError ujo_profile_read_file(ujo_profile* p, const char* filename)
+{
+	ujoError    err;
+	ujo_reader* r;
+
+	report_error(p, "invalid handle", UJO_ERR_INVALID_DATA);
+
+	return_on_err(ujo_new_file_reader(&r, filename));
+
+	err = ujo_profile_read(p, r);
+
+	ujo_free_reader(r);
+
+	return err;
+};
+
+/**
+ * @brief Get the results of the profiled documents.
+ *
+ * The savings are estimated from the tracked strings. A repeated string
+ * is assumed to be stored once and referred to by its index, written
+ * with a type id and the smallest unsigned integer.
+ *
+ * @param p        profiler handle
+ * @param summary  reference to the results
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_profile_get_entry, ujo_profile_print
+ */
+ujoError ujo_profile_get_summary(ujo_profile* p, ujoProfileSummary* summary)
+{
+	report_error(p, "invalid handle", UJO_ERR_INVALID_DATA);
+	report_error(summary, "invalid summary", UJO_ERR_INVALID_DATA);
+
+	*summary = p->summary;
+	summary->dictionary = _ujo_profile_savings(&p->dicts[UJO_PROFILE_STRINGS]);
+	summary->interning  = _ujo_profile_savings(&p->dicts[UJO_PROFILE_KEYS]) + 
+		_ujo_profile_savings(&p->dicts[UJO_PROFILE_COLUMNS]);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Get a tracked string.
+ *
+ * The entries of a table are numbered in the order of their first 
+ * occurrence, the number of entries is found in the distinct member of
+ * the summary.
+ *
+ * @param p      profiler handle
+ * @param table  keys, column names or string values
+ * @param index  number of the entry
+ * @param entry  reference to the entry
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_profile_get_summary
+ */
+ujoError ujo_profile_get_entry(ujo_profile* p, ujoProfileTable table, size_t index, ujoProfileEntry* entry)
+{
+	report_error(p, "invalid handle", UJO_ERR_INVALID_DATA);
+	report_error(table >= UJO_PROFILE_KEYS && table <= UJO_PROFILE_STRINGS, "invalid table", UJO_ERR_INVALID_DATA);
+	report_error(entry, "invalid entry", UJO_ERR_INVALID_DATA);
+	report_error(index < p->dicts[table].count, "invalid index", UJO_ERR_INVALID_DATA);
+
+	*entry = p->dicts[table].items[index].e;
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Print the results as JSON.
+ *
+ * The report lists the octets per type id, string subtype and string 
+ * length, the top keys, column names and string values by octets and
+ * the estimated savings.
+ *
+ * @param p    profiler handle
+ * @param f    output stream
+ * @param top  number of strings listed per table
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_profile_get_summary
+ */
+ujoError ujo_profile_print(ujo_profile* p, FILE* f, size_t top)
+{
+	ujoError          err;
+	ujoProfileSummary s;
+	const char*       sep = "";
+	int               i;
+
+	static const char* subtypes[4] = { "c", "u8", "u16", "u32" };
+
+	report_error(f, "invalid stream", UJO_ERR_INVALID_DATA);
+	return_on_err(ujo_profile_get_summary(p, &s));
+
+	fprintf(f, "{\n  \"documents\": %llu,\n  \"bytes\": %llu,\n  \"types\": [",
+		(unsigned long long)s.documents, (unsigned long long)s.bytes);
+	for (i = 0; i < 256; i++)
+	{
+		if (s.elements[i] == 0)
+			continue;
+		fprintf(f, "%s\n    {\"type\": \"%s\", \"null\": %s, \"count\": %llu, \"bytes\": %llu}", sep,
+			_ujo_profile_type_name((ujoTypeId)i), (i & UJO_TYPE_NULL_FLAG) ? "true" : "false",
+			(unsigned long long)s.elements[i], (unsigned long long)s.typebytes[i]);
+		sep = ",";
+	}
+
+	fprintf(f, "\n  ],\n  \"strings\": [");
+	for (i = 0, sep = ""; i < 4; i++)
+	{
+		if (s.strings[i] == 0)
+			continue;
+		fprintf(f, "%s\n    {\"subtype\": \"%s\", \"count\": %llu, \"bytes\": %llu}", sep, subtypes[i],
+			(unsigned long long)s.strings[i], (unsigned long long)s.stringbytes[i]);
+		sep = ",";
+	}
+
+	fprintf(f, "\n  ],\n  \"lengths\": [");
+	for (i = 0, sep = ""; i < UJO_PROFILE_LENGTHS; i++)
+	{
+		if (s.lengths[i] == 0)
+			continue;
+		fprintf(f, "%s\n    {\"below\": %llu, \"count\": %llu}", sep, 
+			(unsigned long long)1 << i, (unsigned long long)s.lengths[i]);
+		sep = ",";
+	}
+	fprintf(f, "\n  ],\n");
+
+	return_on_err(_ujo_profile_print_table(p, f, UJO_PROFILE_KEYS, "keys", top));
+	return_on_err(_ujo_profile_print_table(p, f, UJO_PROFILE_COLUMNS, "columns", top));
+	return_on_err(_ujo_profile_print_table(p, f, UJO_PROFILE_STRINGS, "values", top));
+
+	fprintf(f, "  \"savings\": {\"narrowing\": %llu, \"dictionary\": %llu, \"interning\": %llu}\n}\n",
+		(unsigned long long)s.narrowing, (unsigned long long)s.dictionary, (unsigned long long)s.interning);
+
+	return UJO_SUCCESS;
+};
+
+/* @} */
@@ -0,0 +1,137 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ */
+
+#ifndef __UJO_PROFILE_H__
+#define __UJO_PROFILE_H__
+
+#include <stdio.h>
+#include "ujo_reader.h"
+
+BEGIN_C_DECLS
+
+/** 
+ * \addtogroup ujo_profile
+ * @{
+ */
+
+/** number of string length buckets, bucket i > 0 counts lengths from 2^(i-1) to 2^i-1 */
+#define UJO_PROFILE_LENGTHS    33
+
+/** octets of a string kept for the report */
+#define UJO_PROFILE_NAME_SIZE  32
+
+/**
+ * @brief Profiler handle.
+ */
+typedef struct _ujo_profile ujo_profile;
+
+/**
+ * @brief Strings tracked by the profiler.
+ */
+typedef enum { 
+	/** map keys */
+	UJO_PROFILE_KEYS, 
+	/** column names of tables */
+	UJO_PROFILE_COLUMNS,
+	/** string values */
+	UJO_PROFILE_STRINGS
+} ujoProfileTable;
+
+/**
+ * @brief Where the octets of the profiled documents are spent.
+ *
+ * All sizes are encoded octets including type ids and length fields.
+ * The savings are estimates for the same documents written with the
+ * given technique.
+ */
+typedef struct {
+	/** documents profiled */
+	uint64_t  documents;
+	/** octets of all documents, including the headers */
+	uint64_t  bytes;
+	/** elements per type id, null values are counted with their null type id */
+	uint64_t  elements[256];
+	/** octets per type id */
+	uint64_t  typebytes[256];
+	/** strings per subtype */
+	uint64_t  strings[4];
+	/** octets of strings per subtype */
+	uint64_t  stringbytes[4];
+	/** strings by length of their data in octets, bucket 0 counts empty strings */
+	uint64_t  lengths[UJO_PROFILE_LENGTHS];
+	/** distinct strings per table */
+	uint64_t  distinct[3];
+	/** occurrences not tracked because a table was full */
+	uint64_t  untracked[3];
+	/** octets saved by writing numbers in their smallest lossless type */
+	uint64_t  narrowing;
+	/** octets saved by replacing repeated string values with an index */
+	uint64_t  dictionary;
+	/** octets saved by replacing repeated keys and column names with an index */
+	uint64_t  interning;
+} ujoProfileSummary;
+
+/**
+ * @brief Profile of a map key, table column or string value.
+ */
+typedef struct {
+	/** first octets of the string data */
+	uint8_t   name[UJO_PROFILE_NAME_SIZE];
+	/** number of octets in name */
+	uint32_t  namesize;
+	/** octets of the complete string data */
+	uint32_t  size;
+	/** string subtype */
+	ujoTypeId subtype;
+	/** occurrences */
+	uint64_t  count;
+	/** octets of all occurrences */
+	uint64_t  bytes;
+	/** values in the column of a table */
+	uint64_t  values;
+	/** octets of the values in the column */
+	uint64_t  valuebytes;
+} ujoProfileEntry;
+
+	ujoError ujo_new_profile(ujo_profile** p, size_t maxentries);
+
+	ujoError ujo_free_profile(ujo_profile* p);
+
+	ujoError ujo_profile_read(ujo_profile* p, ujo_reader* r);
+
+	ujoError ujo_profile_read_file(ujo_profile* p, const char* filename);
+
+	ujoError ujo_profile_get_summary(ujo_profile* p, ujoProfileSummary* summary);
+
+	ujoError ujo_profile_get_entry(ujo_profile* p, ujoProfileTable table, size_t index, ujoProfileEntry* entry);
+
+	ujoError ujo_profile_print(ujo_profile* p, FILE* f, size_t top);
+
+/* @} */
+
+END_C_DECLS
+
+#endif
@@ -26,6 +26,7 @@
 
 #include "ujo_reader.h"
 #include "ujo_stack.h"
+#include "ujo_arena.h"
 #include "ujo_int.h"
 #include "ujo_errors.h"
 #include "ujo_macros.h"
@@ -44,6 +45,13 @@ struct _ujo_reader {
 	ujoStack*		state_stack;
 	ujo_state*		state;
 
+	// NULL for the default allocation functions
+	const ujoAllocator* allocator;
+
+	// elements are allocated from an arena if set
+	ujoArena*           arena;
+	const ujoAllocator* element_allocator;
+
 	// header
 	struct  {
 		char            magic[4];
@@ -53,18 +61,40 @@ struct _ujo_reader {
 
 	// memory reader
 	size_t			buffersize;
+	size_t			buffercapacity;
 	ujoByte*		buffer;
+	// octets read, also counted for files
 	size_t			parsed;
 
+	// scattered memory reader, the segments are owned by the caller
+	const ujoIovec*	iovecs;
+	size_t			iovcount;
+	size_t			iovindex;		// current segment
+	size_t			iovstart;		// position of the current segment
+	size_t			iovend;			// position after the current segment
+
 	// file reader
 	FILE*           file;
 
 	ujoOnElementFunc  onElement;
 	ujoPointer        onElementData;
+
+	// binary data is delivered in chunks if set
+	ujoOnBinaryChunkFunc  onBinaryChunk;
+	ujoPointer            onBinaryChunkData;
+	size_t                chunksize;
+	ujoByte*              chunk;
+
+	// statistics
+	ujoStats        stats;
+	uint32_t        depth;
 };
 
 struct _ujo_element {
 	ujoTypeId type;
+	const ujoAllocator* allocator;
+	// string or binary data refers to the input segment
+	ujoBool   view;
 	union {
 		int8_t  int8val;
 		int16_t int16val;
@@ -112,19 +142,28 @@ struct _ujo_element {
 @cond INTERNAL_DOCS
 */
 
-static __inline ujoError _ujo_new_reader(ujo_reader** r)
+static __inline ujoError _ujo_new_reader(ujo_reader** r, const ujoAllocator* allocator)
 {
 	ujo_reader*  newr;
 
-	newr = (ujo_reader*)ujo_new(ujo_reader, 1); 
+	newr = ujo_new_ex(allocator, ujo_reader, 1); 
 
 	report_error(newr, "allocation failed", UJO_ERR_ALLOCATION);
+	newr->allocator = allocator;
+	newr->element_allocator = allocator;
 	
-	newr->state = (ujo_state*)ujo_new(ujo_state,1);
-	newr->state->state = STATE_ROOT;
-
+	newr->state = ujo_new_ex(allocator, ujo_state, 1);
 	/* initialize stack */
-	newr->state_stack = ujo_new_stack(ujo_free);
+	newr->state_stack = ujo_new_stack_ex(NULL, allocator);
+	if (newr->state == NULL || newr->state_stack == NULL)
+	{
+		if (newr->state_stack)
+			ujo_free_stack(newr->state_stack);
+		ujo_allocator_free(allocator, newr->state);
+		ujo_allocator_free(allocator, newr);
+		report_error(ujoFalse, "allocation failed", UJO_ERR_ALLOCATION);
+	}
+	newr->state->state = STATE_ROOT;
 
 	*r = newr;
 
@@ -144,14 +183,31 @@ static __inline ujoError _ujo_new_reader(ujo_reader** r)
  * @param r    reference to a reader
  *
  * @return UJO error code or UJO_SUCCESS
- * @sa ujo_free_reader
+ * @sa ujo_free_reader, ujo_new_memory_reader_ex
  */
 ujoError ujo_new_memory_reader(ujo_reader** r)
+{
+	return ujo_new_memory_reader_ex(r, NULL);
+};
+
+/**
+ * @brief Create a new memory reader with a custom allocator.
+ *
+ * All memory of the reader, including the elements, strings and
+ * binary data it returns, is allocated by the given allocator.
+ * 
+ * @param r         reference to a reader
+ * @param allocator custom allocator or NULL for the default allocation
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_free_reader, ujo_new_memory_reader
+ */
+ujoError ujo_new_memory_reader_ex(ujo_reader** r, const ujoAllocator* allocator)
 {
 	ujoError err;
 	ujo_reader*  newr;
 
-	err = _ujo_new_reader(&newr);
+	err = _ujo_new_reader(&newr, allocator);
 	if (err != UJO_SUCCESS)
 	{
 		return err;
@@ -173,8 +229,27 @@ ujoError ujo_new_memory_reader(ujo_reader** r)
  * @param filename  full path of the UJO file
  *
  * @return UJO error code or UJO_SUCCESS
- * @sa ujo_free_reader
- */ujoError ujo_new_file_reader(ujo_reader** r, const char* filename)
+ * @sa ujo_free_reader, ujo_new_file_reader_ex
+ */
+ujoError ujo_new_file_reader(ujo_reader** r, const char* filename)
+{
+	return ujo_new_file_reader_ex(r, filename, NULL);
+}
+
+/**
+ * @brief Create a new file reader with a custom allocator.
+ *
+ * All memory of the reader, including the elements, strings and
+ * binary data it returns, is allocated by the given allocator.
+ * 
+ * @param r         reference to a reader
+ * @param filename  full path of the UJO file
+ * @param allocator custom allocator or NULL for the default allocation
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_free_reader, ujo_new_file_reader
+ */
+ujoError ujo_new_file_reader_ex(ujo_reader** r, const char* filename, const ujoAllocator* allocator)
 {
 	ujoError     err;
 	ujo_reader*  newr;
@@ -182,7 +257,12 @@ ujoError ujo_new_memory_reader(ujo_reader** r)
 
 	filehandle = fopen(filename, "rb"); 
     report_error(filehandle != NULL, "cannot open file", UJO_ERR_FILE);	
-	return_on_err(_ujo_new_reader(&newr));
+	err = _ujo_new_reader(&newr, allocator);
+	if (err != UJO_SUCCESS)
+	{
+		fclose(filehandle);
+		return err;
+	}
 	
 	newr->type = UJO_FILE;
 	newr->file = filehandle;
@@ -221,6 +301,107 @@ ujoError ujo_reader_set_on_element(ujo_reader* r, ujoOnElementFunc f, ujoPointer
 	return UJO_SUCCESS;
 };
 
+/**
+ * @brief Set onBinaryChunk callback.
+ *
+ * Binary data is not collected in the element but delivered to the
+ * callback in chunks of at most chunksize octets, so very large binary
+ * values can be processed without holding them in memory at once. The
+ * chunks of a binary value are delivered before the element is returned.
+ * The element carries the type and the total size, but no data.
+ *
+ * @param r         reader object
+ * @param f         callback function or NULL to collect binary data in the element again
+ * @param data      a pointer to custom data or NULL;
+ * @param chunksize maximum size of a chunk, 0 for the default size
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_binary_begin
+ */
+ujoError ujo_reader_set_on_binary_chunk(ujo_reader* r, ujoOnBinaryChunkFunc f, ujoPointer data, size_t chunksize)
+{
+	report_error(r, "invalid handle", UJO_ERR_INVALID_DATA);
+
+	if (chunksize == 0)
+		chunksize = UJO_DEFAULT_BUFSIZE;
+
+	ujo_allocator_free(r->allocator, r->chunk);
+	r->chunk = NULL;
+	r->onBinaryChunk = NULL;
+	r->onBinaryChunkData = NULL;
+
+	if (f)
+	{
+		/* memory buffers are delivered without copy */
+		if (r->type != UJO_MEMORY)
+		{
+			r->chunk = ujo_new_ex(r->allocator, ujoByte, chunksize);
+			report_error(r->chunk, "allocation failed", UJO_ERR_ALLOCATION);
+		}
+		r->onBinaryChunk = f;
+		r->onBinaryChunkData = data;
+		r->chunksize = chunksize;
+	}
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Allocate elements from an arena.
+ *
+ * In arena mode all elements returned by the reader, including their
+ * strings and binary data, are allocated from large blocks owned by the
+ * reader. ujo_free_element() does not release anything. All elements are 
+ * released at once by ujo_reader_reset_arena(). The blocks are kept and 
+ * reused for the next document.
+ *
+ * \code{.c}
+ *   ujo_reader_use_arena(r, 0);
+ *   while (next_message(&buffer, &bytes)) {
+ *     ujo_reader_set_buffer(r, buffer, bytes);
+ *     // ... ujo_reader_get_first, ujo_reader_get_next
+ *     ujo_reader_reset_arena(r);
+ *   }
+ * \endcode
+ *
+ * @param r         ujo reader handle
+ * @param blocksize size of an arena block, 0 for the default size
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_reader_reset_arena
+ */
+ujoError ujo_reader_use_arena(ujo_reader* r, size_t blocksize)
+{
+	report_error(r, "invalid handle", UJO_ERR_INVALID_DATA);
+	report_error(r->arena == NULL, "arena already in use", UJO_ERR_INVALID_OBJECT);
+
+	r->arena = ujo_new_arena(blocksize, r->allocator);
+	report_error(r->arena, "allocation failed", UJO_ERR_ALLOCATION);
+	r->element_allocator = ujo_arena_get_allocator(r->arena);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Release all elements of an arena reader.
+ *
+ * All elements returned by the reader since the last reset become 
+ * invalid. The arena memory is kept for the next elements.
+ *
+ * @param r    ujo reader handle
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_reader_use_arena
+ */
+ujoError ujo_reader_reset_arena(ujo_reader* r)
+{
+	report_error(r, "invalid handle", UJO_ERR_INVALID_DATA);
+	report_error(r->arena, "no arena in use", UJO_ERR_INVALID_OBJECT);
+
+	ujo_arena_reset(r->arena);
+
+	return UJO_SUCCESS;
+};
+
 /**
  * @brief Dispose UJO reader.
  *
@@ -236,12 +417,16 @@ ujoError ujo_free_reader(ujo_reader* r)
 {
 	report_error(r, "invalid handle", UJO_ERR_INVALID_DATA);	
 	
+	ujo_state_clear(r->state_stack);
 	ujo_free_stack(r->state_stack);	
-	ujo_free(r->state);
+	ujo_allocator_free(r->allocator, r->state);
+	if (r->arena)
+		ujo_free_arena(r->arena);
+	ujo_allocator_free(r->allocator, r->chunk);
 	
 	switch(r->type) {
 	case UJO_MEMORY:
-		ujo_free(r->buffer);
+		ujo_allocator_free(r->allocator, r->buffer);
 		break;
 	case UJO_FILE:
 		fclose(r->file);
@@ -250,7 +435,7 @@ ujoError ujo_free_reader(ujo_reader* r)
 		break;
 	}
 	
-	ujo_free(r);
+	ujo_allocator_free(r->allocator, r);
 
 	return UJO_SUCCESS;
 };
@@ -273,6 +458,33 @@ ujoError ujo_reader_get_type(ujo_reader* r, ujoAccessType* type)
 	return UJO_SUCCESS;
 };
 
+/**
+ * @brief Get the statistics of a reader.
+ *
+ * The counters cover all documents read since the reader was created,
+ * a reset does not clear them. Octets of strings and binary data returned
+ * as views are counted as read but not as allocated.
+ *
+ * @param r     ujo reader handle
+ * @param stats reference to the statistics
+ *
+ * @return UJO error code or UJO_SUCCESS, UJO_ERR_NOT_IMPLEMENTED if the
+ * library is built without UJO_ENABLE_STATS
+ * @sa ujo_writer_get_stats
+ */
+ujoError ujo_reader_get_stats(ujo_reader* r, ujoStats* stats)
+{
+	report_error(r, "invalid handle", UJO_ERR_INVALID_DATA);	
+	report_error(stats, "invalid statistics", UJO_ERR_INVALID_DATA);	
+
+#ifdef UJO_ENABLE_STATS
+	*stats = r->stats;
+	return UJO_SUCCESS;
+#else
+	return UJO_ERR_NOT_IMPLEMENTED;
+#endif
+};
+
 static __inline ujoError _ujo_reader_parse_header(ujo_reader *r)
 {
 	ujoError err;
@@ -292,6 +504,74 @@ static __inline ujoError _ujo_reader_parse_header(ujo_reader *r)
 	return UJO_SUCCESS;
 }
 
+static ujoBool _ujo_reader_get_view(ujo_reader* r, uint8_t** data, uint32_t n, ujoTypeId subtype);
+
+/* a length field of a memory buffer does not exceed the buffer */
+static __inline ujoBool _ujo_reader_available(ujo_reader* r, uint64_t bytes)
+{
+	if (r->type != UJO_MEMORY || r->iovecs)
+		return ujoTrue;
+	return (ujoBool)(bytes <= r->buffersize - r->parsed);
+}
+static ujoError _ujo_reader_next_iovec(ujo_reader* r);
+
+/* deliver binary data to the chunk callback */
+static ujoError _ujo_reader_stream_binary(ujo_reader *r, ujo_element *v)
+{
+	ujoError  err;
+	uint32_t  offset;
+	uint32_t  count;
+	uint8_t*  chunk;
+
+	for (offset = 0; offset < v->binary.n; offset += count)
+	{
+		count = v->binary.n - offset;
+		if (count > r->chunksize)
+			count = (uint32_t)r->chunksize;
+
+		if (r->type == UJO_MEMORY && r->iovecs == NULL)
+		{
+			report_error(count <= r->buffersize - r->parsed, "unexpected end of data", UJO_ERR_INVALID_DATA);
+			chunk = r->buffer + r->parsed;
+			r->parsed += count;
+			ujo_stats_add(r->stats, bytes, count);
+		}
+		else if (r->type == UJO_MEMORY)
+		{
+			/* a chunk ends at a segment boundary */
+			return_on_err(_ujo_reader_next_iovec(r));
+			if (count > r->iovend - r->parsed)
+				count = (uint32_t)(r->iovend - r->parsed);
+			chunk = r->iovecs[r->iovindex].base + (r->parsed - r->iovstart);
+			r->parsed += count;
+			ujo_stats_add(r->stats, bytes, count);
+		}
+		else
+		{
+			chunk = r->chunk;
+			return_on_err(_ujo_reader_get_data(r, chunk, count));
+		}
+
+		return_on_err(r->onBinaryChunk(v->binary.type, chunk, count, offset, v->binary.n, r->onBinaryChunkData));
+	}
+
+	return UJO_SUCCESS;
+}
+
+/* count an element, a terminator has already left its container */
+static __inline void _ujo_reader_count(ujo_reader* r, ujoTypeId type)
+{
+#ifdef UJO_ENABLE_STATS
+	r->stats.elements[type]++;
+	if (type == UJO_TYPE_LIST || type == UJO_TYPE_MAP || type == UJO_TYPE_TABLE)
+	{
+		r->stats.containers++;
+		if (++r->depth > r->stats.maxdepth)
+			r->stats.maxdepth = r->depth;
+	}
+#endif
+}
+
 static __inline ujoError _ujo_reader_open_list(ujo_reader *r, /*@unused@*/ ujo_element *v)
 {
 	r->state = ujo_state_next(STATE_LIST, r->state, r->state_stack);
@@ -446,6 +726,17 @@ static __inline ujoError _ujo_reader_parse_none(ujo_reader *r, /*@unused@*/ ujo_
 	return UJO_SUCCESS;
 };
 
+/* a null has no payload, nothing is read or allocated beyond the element itself */
+static __inline ujoError _ujo_reader_parse_null(ujo_reader *r, ujo_element *v)
+{
+	ujoTypeId type = v->type & ~UJO_TYPE_NULL_FLAG;
+
+	report_error(type >= UJO_TYPE_FLOAT64 && type <= UJO_TYPE_TIMESTAMP, "invalid null type", UJO_ERR_INVALID_DATA);
+	r->state = ujo_state_switch(ATOMIC_FOUND, r->state, r->state_stack);
+
+	return UJO_SUCCESS;
+};
+
 static __inline ujoError _ujo_reader_close_container(ujo_reader *r, /*@unused@*/ ujo_element *v)
 {
 	r->state = ujo_state_prev(r->state, r->state_stack);
@@ -516,29 +807,48 @@ static __inline ujoError _ujo_reader_parse_timestamp(ujo_reader *r, ujo_element
 static __inline ujoError _ujo_reader_parse_string(ujo_reader *r, ujo_element *v)
 {
 	ujoError err;
+	uint64_t bytes;
 
 	return_on_err(_ujo_reader_get_data(r, &v->string.type, sizeof(ujoTypeId)));
 	return_on_err(_ujo_reader_get_data(r,&v->string.n, sizeof(uint32_t)));
+
+	/* n counts units of the subtype */
+	bytes = v->string.n;
+	if (v->string.type == UJO_SUB_STRING_U16)
+		bytes *= sizeof(uint16_t);
+	else if (v->string.type == UJO_SUB_STRING_U32)
+		bytes *= sizeof(uint32_t);
+	report_error(_ujo_reader_available(r, bytes), "unexpected end of data", UJO_ERR_INVALID_DATA);
+	if (r->iovecs && _ujo_reader_get_view(r, &v->string.u8_string, v->string.n, v->string.type))
+	{
+		v->view = ujoTrue;
+		r->state = ujo_state_switch(ATOMIC_FOUND, r->state, r->state_stack);
+		return UJO_SUCCESS;
+	}
 	switch (v->string.type)
 	{
 	case UJO_SUB_STRING_C:
-		v->string.c_string = (char*)ujo_calloc(v->string.n, sizeof(char));
+		v->string.c_string = ujo_new_ex(v->allocator, char, v->string.n);
 		report_error(v->string.c_string, "allocation failed", UJO_ERR_ALLOCATION);
+		ujo_stats_add(r->stats, heapbytes, v->string.n*sizeof(char));
 		return_on_err(_ujo_reader_get_data(r,v->string.c_string, v->string.n*sizeof(char)));
 		break;
 	case UJO_SUB_STRING_U8:
-		v->string.u8_string = (uint8_t*)ujo_calloc(v->string.n, sizeof(uint8_t));
+		v->string.u8_string = ujo_new_ex(v->allocator, uint8_t, v->string.n);
 		report_error(v->string.u8_string, "allocation failed", UJO_ERR_ALLOCATION);
+		ujo_stats_add(r->stats, heapbytes, v->string.n*sizeof(uint8_t));
 		return_on_err(_ujo_reader_get_data(r,v->string.u8_string, v->string.n*sizeof(uint8_t)));
 		break;
 	case UJO_SUB_STRING_U16:
-		v->string.u16_string = (uint16_t*)ujo_calloc(v->string.n, sizeof(uint16_t));
+		v->string.u16_string = ujo_new_ex(v->allocator, uint16_t, v->string.n);
 		report_error(v->string.u16_string, "allocation failed", UJO_ERR_ALLOCATION);
+		ujo_stats_add(r->stats, heapbytes, v->string.n*sizeof(uint16_t));
 		return_on_err(_ujo_reader_get_data(r,v->string.u16_string, v->string.n*sizeof(uint16_t)));
 		break;
 	case UJO_SUB_STRING_U32:
-		v->string.u32_string = (uint32_t*)ujo_calloc(v->string.n, sizeof(uint32_t));
+		v->string.u32_string = ujo_new_ex(v->allocator, uint32_t, v->string.n);
 		report_error(v->string.u32_string, "allocation failed", UJO_ERR_ALLOCATION);
+		ujo_stats_add(r->stats, heapbytes, v->string.n*sizeof(uint32_t));
 		return_on_err(_ujo_reader_get_data(r,v->string.u32_string, v->string.n*sizeof(uint32_t)));
 		break;
 	default:
@@ -556,9 +866,25 @@ static __inline ujoError _ujo_reader_parse_binary(ujo_reader *r, ujo_element *v)
 
 	return_on_err(_ujo_reader_get_data(r, &v->binary.type, sizeof(ujoTypeId)));
 	return_on_err(_ujo_reader_get_data(r,&v->binary.n, sizeof(uint32_t)));
+	report_error(_ujo_reader_available(r, v->binary.n), "unexpected end of data", UJO_ERR_INVALID_DATA);
+
+	if (r->onBinaryChunk)
+	{
+		return_on_err(_ujo_reader_stream_binary(r, v));
+		r->state = ujo_state_switch(ATOMIC_FOUND, r->state, r->state_stack);
+		return UJO_SUCCESS;
+	}
 
-	v->binary.data = (uint8_t*)ujo_calloc(v->binary.n, 1);
+	if (r->iovecs && _ujo_reader_get_view(r, &v->binary.data, v->binary.n, UJO_SUB_STRING_U8))
+	{
+		v->view = ujoTrue;
+		r->state = ujo_state_switch(ATOMIC_FOUND, r->state, r->state_stack);
+		return UJO_SUCCESS;
+	}
+
+	v->binary.data = ujo_new_ex(v->allocator, uint8_t, v->binary.n);
 	report_error(v->binary.data, "allocation failed", UJO_ERR_ALLOCATION);
+	ujo_stats_add(r->stats, heapbytes, v->binary.n);
 	return_on_err(_ujo_reader_get_data(r,v->binary.data, v->binary.n));
 
 	r->state = ujo_state_switch(ATOMIC_FOUND, r->state, r->state_stack);
@@ -569,16 +895,95 @@ static __inline ujoError _ujo_reader_parse_binary(ujo_reader *r, ujo_element *v)
 static __inline ujoError _ujo_reader_get_memory_data(ujo_reader* r, void* sequence, size_t bytes) 
 {
 	ujoByte *cursor = r->buffer + r->parsed;
+
+	report_error(bytes <= r->buffersize - r->parsed, "unexpected end of data", UJO_ERR_INVALID_DATA);
 	memcpy(sequence,cursor,bytes);
 	r->parsed += bytes;
 
 	return UJO_SUCCESS;
 }
 
+/* move to the segment holding the current position */
+static ujoError _ujo_reader_next_iovec(ujo_reader* r) 
+{
+	while (r->parsed >= r->iovend)
+	{
+		report_error(r->iovindex + 1 < r->iovcount, "end of segments", UJO_ERR_INVALID_DATA);
+		r->iovindex++;
+		r->iovstart = r->iovend;
+		r->iovend  += r->iovecs[r->iovindex].len;
+	}
+	return UJO_SUCCESS;
+}
+
+static __inline ujoError _ujo_reader_get_iovec_data(ujo_reader* r, void* sequence, size_t bytes) 
+{
+	ujoError  err;
+	ujoByte*  target = (ujoByte*)sequence;
+	size_t    count;
+
+	/* fast path inside the current segment */
+	if (r->parsed + bytes <= r->iovend)
+	{
+		memcpy(target, r->iovecs[r->iovindex].base + (r->parsed - r->iovstart), bytes);
+		r->parsed += bytes;
+		return UJO_SUCCESS;
+	}
+
+	/* the value straddles segments */
+	while (bytes > 0)
+	{
+		return_on_err(_ujo_reader_next_iovec(r));
+		count = r->iovend - r->parsed;
+		if (count > bytes)
+			count = bytes;
+		memcpy(target, r->iovecs[r->iovindex].base + (r->parsed - r->iovstart), count);
+		r->parsed += count;
+		target += count;
+		bytes -= count;
+	}
+
+	return UJO_SUCCESS;
+}
+
+/* refer to data inside one segment instead of copying it */
+static ujoBool _ujo_reader_get_view(ujo_reader* r, uint8_t** data, uint32_t n, ujoTypeId subtype) 
+{
+	size_t    width;
+	ujoByte*  start;
+
+	switch (subtype)
+	{
+	case UJO_SUB_STRING_U16:
+		width = sizeof(uint16_t); break;
+	case UJO_SUB_STRING_U32:
+		width = sizeof(uint32_t); break;
+	case UJO_SUB_STRING_C:
+	case UJO_SUB_STRING_U8:
+		width = sizeof(uint8_t); break;
+	default:
+		return ujoFalse;
+	}
+
+	if (n == 0 || _ujo_reader_next_iovec(r) != UJO_SUCCESS || r->parsed + n*width > r->iovend)
+		return ujoFalse;
+
+	start = r->iovecs[r->iovindex].base + (r->parsed - r->iovstart);
+	if (((uintptr_t)start % width) != 0)
+		return ujoFalse;
+
+	*data = start;
+	r->parsed += n*width;
+	ujo_stats_add(r->stats, bytes, n*width);
+	return ujoTrue;
+}
+
 static __inline ujoError _ujo_reader_get_file_data(ujo_reader* r, void* sequence, size_t bytes) 
 {
 	report_error(fread(sequence, 1, bytes, r->file) == bytes,
 		"read from file failed", UJO_ERR_FILE);
+	r->parsed += bytes;
+	ujo_stats_add(r->stats, iocalls, 1);
 
 	return UJO_SUCCESS;
 }
@@ -590,7 +995,10 @@ ujoError _ujo_reader_get_data(ujo_reader* r, void* sequence, size_t bytes)
 	switch(r->type)
 	{
 	case UJO_MEMORY:
-		err = _ujo_reader_get_memory_data(r, sequence, bytes);
+		if (r->iovecs)
+			err = _ujo_reader_get_iovec_data(r, sequence, bytes);
+		else
+			err = _ujo_reader_get_memory_data(r, sequence, bytes);
 		break;
 	case UJO_FILE:
 		err = _ujo_reader_get_file_data(r, sequence, bytes);
@@ -598,38 +1006,189 @@ ujoError _ujo_reader_get_data(ujo_reader* r, void* sequence, size_t bytes)
 	default:
 		break;
 	}
+	if (err == UJO_SUCCESS)
+		ujo_stats_add(r->stats, bytes, bytes);
 	return err;
 }
 
+size_t _ujo_reader_get_position(ujo_reader* r)
+{
+	return r->parsed;
+}
+
+ujoBool _ujo_reader_streams_binary(ujo_reader* r)
+{
+	return r->onBinaryChunk != NULL;
+}
+
+ujoBool _ujo_element_equal(ujo_element* a, ujo_element* b)
+{
+	size_t width;
+
+	if (a->type != b->type)
+		return ujoFalse;
+
+	switch (a->type)
+	{
+	case UJO_TYPE_INT64:
+	case UJO_TYPE_UINT64:
+	case UJO_TYPE_UX_TIME:
+		return (ujoBool)(a->uint64val == b->uint64val);
+	case UJO_TYPE_INT32:
+	case UJO_TYPE_UINT32:
+		return (ujoBool)(a->uint32val == b->uint32val);
+	case UJO_TYPE_INT16:
+	case UJO_TYPE_UINT16:
+	case UJO_TYPE_FLOAT16:
+		return (ujoBool)(a->uint16val == b->uint16val);
+	case UJO_TYPE_INT8:
+	case UJO_TYPE_UINT8:
+	case UJO_TYPE_BOOL:
+		return (ujoBool)(a->uint8val == b->uint8val);
+	case UJO_TYPE_FLOAT32:
+		return (ujoBool)(memcmp(&a->float32val, &b->float32val, sizeof(float32_t)) == 0);
+	case UJO_TYPE_FLOAT64:
+		return (ujoBool)(memcmp(&a->float64val, &b->float64val, sizeof(float64_t)) == 0);
+	case UJO_TYPE_DATE:
+	case UJO_TYPE_TIME:
+	case UJO_TYPE_TIMESTAMP:
+		return (ujoBool)(a->datetime.year == b->datetime.year &&
+			a->datetime.month == b->datetime.month &&
+			a->datetime.day == b->datetime.day &&
+			a->datetime.hour == b->datetime.hour &&
+			a->datetime.minute == b->datetime.minute &&
+			a->datetime.second == b->datetime.second &&
+			a->datetime.millisecond == b->datetime.millisecond);
+	case UJO_TYPE_STRING:
+		if (a->string.type != b->string.type || a->string.n != b->string.n)
+			return ujoFalse;
+		switch (a->string.type)
+		{
+		case UJO_SUB_STRING_U16:
+			width = sizeof(uint16_t); break;
+		case UJO_SUB_STRING_U32:
+			width = sizeof(uint32_t); break;
+		default:
+			width = sizeof(uint8_t); break;
+		}
+		return (ujoBool)(memcmp(a->string.u8_string, b->string.u8_string, a->string.n*width) == 0);
+	case UJO_TYPE_BIN:
+		return (ujoBool)(a->binary.type == b->binary.type && a->binary.n == b->binary.n &&
+			memcmp(a->binary.data, b->binary.data, a->binary.n) == 0);
+	default:
+		// containers, terminators, none and null values
+		return ujoTrue;
+	}
+}
+
 /**
  * @brief Assign a buffer to the reader.
  *
  * A memory reader operated on a buffer containing an UJO document as
  * a sequence of octets. This functions copies the content of an existing
- * buffer to the reader buffer to prepare the scanning.
+ * buffer to the reader buffer to prepare the scanning. The reader buffer
+ * is reused for the next document and only grows if a larger document is 
+ * assigned.
  *
  * @param r    ujo reader handle
  * @param buffer a pointer to an UJO document in memory
  * @param bytes the number of octets in the buffer
  *
  * @return UJO error code or UJO_SUCCESS
- * @sa ujo_reader_parse, ujo_reader_get_first, ujo_reader_get_next
+ * @sa ujo_reader_parse, ujo_reader_get_first, ujo_reader_get_next, ujo_reader_reset
  */
 ujoError ujo_reader_set_buffer(ujo_reader *r, ujoByte* buffer, size_t bytes)
 {	
+	ujoByte* temp;
+
 	report_error(r, "invalid handle", UJO_ERR_INVALID_DATA);	
 	report_error(buffer, "invalid buffer", UJO_ERR_INVALID_DATA);	
+	report_error(r->type == UJO_MEMORY, "buffer requires a memory reader", UJO_ERR_INVALID_OBJECT);
 
-
-	r->buffer = ujo_new(ujoByte, bytes);
+	if (r->buffer == NULL || bytes > r->buffercapacity)
+	{
+		temp = (ujoByte*)ujo_allocator_realloc(r->allocator, r->buffer, r->buffercapacity, bytes ? bytes : 1);
+		report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+		r->buffer = temp;
+		r->buffercapacity = bytes ? bytes : 1;
+	}
 	r->buffersize = bytes;
-	r->parsed = 0;
-	ujo_clear_stack(r->state_stack);
-
-	r->state->state = STATE_ROOT;
+	r->iovecs = NULL;
 
 	memcpy(r->buffer, buffer, bytes);
 
+	return ujo_reader_reset(r);
+};
+
+/**
+ * @brief Assign scattered buffers to the reader.
+ *
+ * The document is read from a sequence of segments, e.g. the buffers
+ * of a network receive path, without joining them first. The segments 
+ * are not copied and have to stay valid while the document is read. 
+ * Values crossing a segment boundary are assembled by the reader. Strings
+ * and binary data inside one segment are returned as views on the segment,
+ * so they are only valid as long as the segments are.
+ *
+ * @param r       ujo reader handle
+ * @param iovecs  array of segments
+ * @param count   number of segments
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_reader_set_buffer, ujo_writer_get_iovecs
+ */
+ujoError ujo_reader_set_iovecs(ujo_reader *r, const ujoIovec* iovecs, size_t count)
+{	
+	report_error(r, "invalid handle", UJO_ERR_INVALID_DATA);	
+	report_error(iovecs && count > 0, "invalid segments", UJO_ERR_INVALID_DATA);	
+	report_error(r->type == UJO_MEMORY, "segments require a memory reader", UJO_ERR_INVALID_OBJECT);
+
+	r->iovecs   = iovecs;
+	r->iovcount = count;
+
+	return ujo_reader_reset(r);
+};
+
+/**
+ * @brief Reset a reader.
+ *
+ * The document state is cleared and the reader starts again at the 
+ * beginning of the document with the next call to ujo_reader_get_first().
+ * All internal structures are kept, so consecutive documents are read 
+ * without allocation. Elements of an arena reader are not released, this
+ * is done by ujo_reader_reset_arena().
+ *
+ * @param r    ujo reader handle
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_reader_set_buffer, ujo_reader_reset_arena
+ */
+ujoError ujo_reader_reset(ujo_reader *r)
+{
+	report_error(r, "invalid handle", UJO_ERR_INVALID_DATA);	
+
+	r->state = ujo_state_rewind(r->state, r->state_stack);
+	r->depth = 0;
+
+	switch(r->type)
+	{
+	case UJO_MEMORY:
+		r->parsed = 0;
+		if (r->iovecs)
+		{
+			r->iovindex = 0;
+			r->iovstart = 0;
+			r->iovend   = r->iovecs[0].len;
+		}
+		break;
+	case UJO_FILE:
+		report_error(fseek(r->file, 0, SEEK_SET) == 0, "cannot rewind file", UJO_ERR_FILE);
+		r->parsed = 0;
+		break;
+	default:
+		break;
+	}
+
 	return UJO_SUCCESS;
 };
 
@@ -658,7 +1217,7 @@ ujoError ujo_reader_parse(ujo_reader *r)
 		if (r->onElement) {
 			err = r->onElement(ujoval, r->onElementData);
 		}
-		ujo_free(ujoval);
+		ujo_free_element(ujoval);
 		if (err != UJO_SUCCESS) return err;
 
 		err = ujo_reader_get_next(r, &ujoval, &eod);
@@ -725,8 +1284,16 @@ ujoError ujo_reader_get_next(ujo_reader *r, ujo_element** v, ujoBool *eod)
 		*eod = ujoFalse;
 	}
 
-	value = ujo_new(ujo_element,1);
-	return_on_err(_ujo_reader_get_data(r,&(value->type), sizeof(uint8_t)));
+	value = ujo_new_ex(r->element_allocator, ujo_element, 1);
+	report_error(value, "allocation failed", UJO_ERR_ALLOCATION);
+	ujo_stats_add(r->stats, heapbytes, sizeof(ujo_element));
+	value->allocator = r->element_allocator;
+	err = _ujo_reader_get_data(r,&(value->type), sizeof(uint8_t));
+	if (err != UJO_SUCCESS)
+	{
+		ujo_free_element(value);
+		return err;
+	}
 
 	switch(value->type)
 	{
@@ -741,8 +1308,12 @@ ujoError ujo_reader_get_next(ujo_reader *r, ujo_element** v, ujoBool *eod)
 		{
 			r->state->state = STATE_TABLE_VALUES;
 			err = UJO_SUCCESS;
-		} else
+		} else {
 			err = _ujo_reader_close_container(r, value); 
+#ifdef UJO_ENABLE_STATS
+			r->depth--;
+#endif
+		}
 		break;
 	case UJO_TYPE_INT64: 
 		err = _ujo_reader_parse_int64(r, value); break;
@@ -783,11 +1354,15 @@ ujoError ujo_reader_get_next(ujo_reader *r, ujo_element** v, ujoBool *eod)
 	case UJO_TYPE_BIN: 
 		err = _ujo_reader_parse_binary(r, value); break;
 	default:  
-		err = UJO_ERR_INVALID_DATA;
+		if (value->type & UJO_TYPE_NULL_FLAG)
+			err = _ujo_reader_parse_null(r, value);
+		else
+			err = UJO_ERR_INVALID_DATA;
 	}
 
 	if (err == UJO_SUCCESS)
 	{
+		_ujo_reader_count(r, value->type);
 		*v = value;
 		return UJO_SUCCESS;
 	}
@@ -806,6 +1381,8 @@ ujoError ujo_reader_get_next(ujo_reader *r, ujo_element** v, ujoBool *eod)
  * and ujo_reader_get_next(), each element has to be disposed 
  * to release the allocated memory. The ujo_reader_parse() method 
  * automatically disposes the element after the handler function returns.
+ * Elements of a reader in arena mode are released by ujo_reader_reset_arena(),
+ * disposing them does nothing.
  *
  * @param e    ujo element handle
  *
@@ -813,28 +1390,34 @@ ujoError ujo_reader_get_next(ujo_reader *r, ujo_element** v, ujoBool *eod)
  */
 ujoError ujo_free_element(ujo_element* e)
 {
+	if (e->view)
+	{
+		ujo_allocator_free(e->allocator, e);
+		return UJO_SUCCESS;
+	}
+
 	switch (e->type)
 	{
 	case UJO_TYPE_STRING:
 		switch (e->string.type)
 		{
 		case UJO_SUB_STRING_C:
-			ujo_free(e->string.c_string);
+			ujo_allocator_free(e->allocator, e->string.c_string);
 			break;
 		case UJO_SUB_STRING_U8:
-			ujo_free(e->string.u8_string);
+			ujo_allocator_free(e->allocator, e->string.u8_string);
 			break;
 		case UJO_SUB_STRING_U16:
-			ujo_free(e->string.u16_string);
+			ujo_allocator_free(e->allocator, e->string.u16_string);
 			break;
 		case UJO_SUB_STRING_U32:
-			ujo_free(e->string.u32_string);
+			ujo_allocator_free(e->allocator, e->string.u32_string);
 			break;
 		}; break;
 	case UJO_TYPE_BIN:
-		ujo_free(e->binary.data);
+		ujo_allocator_free(e->allocator, e->binary.data);
 	};
-	ujo_free(e);
+	ujo_allocator_free(e->allocator, e);
 	return UJO_SUCCESS;
 };
 
@@ -1020,6 +1603,16 @@ ujoError ujo_element_get_float16(ujo_element* e, float32_t* value)
 	return UJO_SUCCESS;
 };
 
+/* the bits of a half precision value, NaN and infinity are kept */
+ujoError _ujo_element_get_float16_raw(ujo_element* e, uint16_t* value)
+{
+	report_error(e, "invalid handle", UJO_ERR_INVALID_DATA);
+	report_error(e->type == UJO_TYPE_FLOAT16, "element type mismatch", UJO_ERR_INVALID_DATA);
+
+	*value = e->float16val;
+	return UJO_SUCCESS;
+};
+
 /**
  * @brief Get a 32bit float value (single precision)
  *
@@ -1102,6 +1695,28 @@ ujoError ujo_element_get_type(ujo_element* e, ujoTypeId* value)
 	return UJO_SUCCESS;
 };
 
+/**
+ * @brief Get the type of a Null value.
+ *
+ * A Null value has no data but a known type. If the element is
+ * a Null value, which means the UJO_TYPE_NULL_FLAG bit of the element
+ * type is set, this function returns the type of the value.
+ *
+ * @param e    ujo element handle
+ * @param value   reference to a variable to hold the type id
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_add_null, ujo_writer_add_nulls
+ */
+ujoError ujo_element_get_null_type(ujo_element* e, ujoTypeId* value)
+{
+	report_error(e, "invalid handle", UJO_ERR_INVALID_DATA);
+	report_error(e->type & UJO_TYPE_NULL_FLAG, "element is not null", UJO_ERR_INVALID_DATA);
+
+	*value = e->type & ~UJO_TYPE_NULL_FLAG;
+	return UJO_SUCCESS;
+};
+
 /**
  * @brief Get a unix time.
  *
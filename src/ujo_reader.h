@@ -55,6 +55,41 @@ typedef struct _ujo_element ujo_element;
  */
 typedef ujoError (*ujoOnElementFunc)(ujo_element* element, ujoPointer data);
 
+/**
+ * @brief On binary data chunk.
+ * @ingroup ujo_reader_callbacks
+ *
+ * A callback function to deliver binary data in chunks while reading a 
+ * binary element.
+ *
+ * @param type    binary data type
+ * @param chunk   the data of the chunk, only valid during the call
+ * @param n       number of octets in the chunk
+ * @param offset  position of the chunk in the binary data
+ * @param total   total number of octets of the binary data
+ * @param data    A pointer to custom data. 
+ *
+ * @return UJO error code or UJO_SUCCESS
+ */
+typedef ujoError (*ujoOnBinaryChunkFunc)(uint8_t type, const uint8_t* chunk, uint32_t n, uint32_t offset, uint32_t total, ujoPointer data);
+
+/**
+ * @brief Result of a document validation.
+ * @ingroup ujo_reader
+ */
+typedef struct {
+	/** octets of the document, including the header */
+	size_t       bytes;
+	/** elements found */
+	uint64_t     elements;
+	/** deepest nesting of containers */
+	uint32_t     maxdepth;
+	/** offset of the element where the validation failed */
+	size_t       offset;
+	/** reason of the failure, NULL for a valid document */
+	const char*  message;
+} ujoValidateReport;
+
 
 BEGIN_C_DECLS
 
@@ -67,15 +102,33 @@ BEGIN_C_DECLS
 
 	ujoError ujo_new_file_reader(ujo_reader** r, const char* filename);
 
+	ujoError ujo_new_memory_reader_ex(ujo_reader** r, const ujoAllocator* allocator);
+
+	ujoError ujo_new_file_reader_ex(ujo_reader** r, const char* filename, const ujoAllocator* allocator);
+
 
 	ujoError ujo_free_reader(ujo_reader* r);
 
 	ujoError ujo_reader_get_type(ujo_reader* r, ujoAccessType* type);
 
+	ujoError ujo_reader_get_stats(ujo_reader* r, ujoStats* stats);
+
+	ujoError ujo_validate(const ujoByte* buffer, size_t bytes, ujoValidateReport* report);
+
 	ujoError ujo_reader_set_on_element(ujo_reader* r, ujoOnElementFunc f, ujoPointer data);
 
+	ujoError ujo_reader_set_on_binary_chunk(ujo_reader* r, ujoOnBinaryChunkFunc f, ujoPointer data, size_t chunksize);
+
+	ujoError ujo_reader_use_arena(ujo_reader* r, size_t blocksize);
+
+	ujoError ujo_reader_reset_arena(ujo_reader* r);
+
 	ujoError ujo_reader_set_buffer(ujo_reader* r, ujoByte* buffer, size_t bytes);
 
+	ujoError ujo_reader_set_iovecs(ujo_reader* r, const ujoIovec* iovecs, size_t count);
+
+	ujoError ujo_reader_reset(ujo_reader* r);
+
 	ujoError ujo_reader_parse(ujo_reader* r);
 
 	ujoError ujo_reader_get_first(ujo_reader *r, ujo_element** v, ujoBool *eod);
@@ -106,6 +159,7 @@ BEGIN_C_DECLS
 	ujoError ujo_element_get_bool(ujo_element* e, ujoBool* value);
 
 	ujoError ujo_element_get_type(ujo_element* e, ujoTypeId* value);
+	ujoError ujo_element_get_null_type(ujo_element* e, ujoTypeId* value);
 
 	ujoError ujo_element_get_uxtime(ujo_element* e, int64_t* value);
 	ujoError ujo_element_get_date(ujo_element* e, ujoDateTime* value);
@@ -126,6 +180,10 @@ BEGIN_C_DECLS
 @cond INTERNAL_DOCS
 */
 	ujoError _ujo_reader_get_data(ujo_reader* r, void* sequence, size_t bytes);
+	size_t   _ujo_reader_get_position(ujo_reader* r);
+	ujoBool  _ujo_reader_streams_binary(ujo_reader* r);
+	ujoBool  _ujo_element_equal(ujo_element* a, ujo_element* b);
+	ujoError _ujo_element_get_float16_raw(ujo_element* e, uint16_t* value);
 
 /**
 @endcond
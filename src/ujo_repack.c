@@ -0,0 +1,349 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ */
+
+#include "ujo_repack.h"
+#include "ujo_errors.h"
+#include "ujo_log.h"
+#include "ujo_macros.h"
+#include "ujo_constants.h"
+#include <string.h>
+
+/** 
+@cond INTERNAL_DOCS
+*/
+
+/* container marker for the value section of a table */
+#define REPACK_TABLE_VALUES ((uint8_t)0xFF)
+
+typedef struct {
+	ujo_reader*  r;
+	ujo_writer*  w;
+
+	// open containers
+	uint8_t*     containers;
+	size_t       depth;
+	size_t       size;
+
+	// conversion buffer for strings
+	uint8_t*     scratch;
+	size_t       scratchsize;
+} ujo_repack_ctx;
+
+static __inline ujoError _ujo_repack_push(ujo_repack_ctx* ctx, uint8_t type)
+{
+	uint8_t* temp;
+
+	if (ctx->depth == ctx->size)
+	{
+		temp = (uint8_t*)ujo_realloc(ctx->containers, ctx->size + 16);
+		report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+		ctx->containers = temp;
+		ctx->size += 16;
+	}
+	ctx->containers[ctx->depth++] = type;
+
+	return UJO_SUCCESS;
+}
+
+static __inline ujoError _ujo_repack_terminator(ujo_repack_ctx* ctx)
+{
+	report_error(ctx->depth > 0, "unexpected terminator", UJO_ERR_INVALID_DATA);
+
+	switch (ctx->containers[ctx->depth-1])
+	{
+	case UJO_TYPE_LIST:
+		ctx->depth--;
+		return ujo_writer_list_close(ctx->w);
+	case UJO_TYPE_MAP:
+		ctx->depth--;
+		return ujo_writer_map_close(ctx->w);
+	case UJO_TYPE_TABLE:
+		ctx->containers[ctx->depth-1] = REPACK_TABLE_VALUES;
+		return ujo_writer_table_end_columns(ctx->w);
+	default:
+		ctx->depth--;
+		return ujo_writer_table_close(ctx->w);
+	}
+}
+
+static __inline ujoError _ujo_repack_reserve(ujo_repack_ctx* ctx, size_t bytes)
+{
+	uint8_t* temp;
+
+	if (bytes > ctx->scratchsize)
+	{
+		temp = (uint8_t*)ujo_realloc(ctx->scratch, bytes);
+		report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+		ctx->scratch = temp;
+		ctx->scratchsize = bytes;
+	}
+	return UJO_SUCCESS;
+}
+
+static ujoError _ujo_repack_string(ujo_repack_ctx* ctx, ujo_element* e)
+{
+	ujoError  err;
+	ujoTypeId stype;
+	char*     c_string;
+	uint8_t*  u8_string;
+	uint16_t* u16_string;
+	uint32_t* u32_string;
+	uint32_t  n;
+	uint32_t  i;
+
+	return_on_err(ujo_element_get_string_type(e, &stype));
+
+	switch (stype)
+	{
+	case UJO_SUB_STRING_C:
+		return_on_err(ujo_element_get_string_c(e, &c_string, &n));
+		return ujo_writer_add_string_c(ctx->w, c_string, n);
+	case UJO_SUB_STRING_U8:
+		return_on_err(ujo_element_get_string_u8(e, &u8_string, &n));
+		return ujo_writer_add_string_u8(ctx->w, u8_string, n);
+	case UJO_SUB_STRING_U16:
+		return_on_err(ujo_element_get_string_u16(e, &u16_string, &n));
+		for (i = 0; i < n && u16_string[i] < 0x80; i++);
+		if (i < n)
+			return ujo_writer_add_string_u16(ctx->w, u16_string, n);
+
+		/* pure ASCII is stored with one octet per character */
+		return_on_err(_ujo_repack_reserve(ctx, n));
+		for (i = 0; i < n; i++)
+			ctx->scratch[i] = (uint8_t)u16_string[i];
+		return ujo_writer_add_string_u8(ctx->w, ctx->scratch, n);
+	case UJO_SUB_STRING_U32:
+		return_on_err(ujo_element_get_string_u32(e, &u32_string, &n));
+		for (i = 0; i < n && u32_string[i] < 0x80; i++);
+		if (i < n)
+			return ujo_writer_add_string_u32(ctx->w, u32_string, n);
+
+		return_on_err(_ujo_repack_reserve(ctx, n));
+		for (i = 0; i < n; i++)
+			ctx->scratch[i] = (uint8_t)u32_string[i];
+		return ujo_writer_add_string_u8(ctx->w, ctx->scratch, n);
+	default:
+		report_error(0, "invalid string subtype", UJO_ERR_INVALID_DATA);
+	}
+}
+
+static ujoError _ujo_repack_element(ujo_repack_ctx* ctx, ujo_element* e)
+{
+	ujoError    err;
+	ujoTypeId   type;
+	int8_t      i8;
+	int16_t     i16;
+	int32_t     i32;
+	int64_t     i64;
+	uint8_t     u8;
+	uint16_t    u16;
+	uint32_t    u32;
+	uint64_t    u64;
+	float32_t   f32;
+	float64_t   f64;
+	ujoBool     b;
+	ujoDateTime dt;
+	uint8_t*    data;
+	uint32_t    n;
+
+	return_on_err(ujo_element_get_type(e, &type));
+
+	switch (type)
+	{
+	case UJO_TYPE_LIST:
+		return_on_err(_ujo_repack_push(ctx, type));
+		return ujo_writer_list_open(ctx->w);
+	case UJO_TYPE_MAP:
+		return_on_err(_ujo_repack_push(ctx, type));
+		return ujo_writer_map_open(ctx->w);
+	case UJO_TYPE_TABLE:
+		return_on_err(_ujo_repack_push(ctx, type));
+		return ujo_writer_table_open(ctx->w);
+	case UJO_TERMINATOR:
+		return _ujo_repack_terminator(ctx);
+
+	case UJO_TYPE_INT64:
+		return_on_err(ujo_element_get_int64(e, &i64));
+		return ujo_writer_add_int_auto(ctx->w, i64);
+	case UJO_TYPE_INT32:
+		return_on_err(ujo_element_get_int32(e, &i32));
+		return ujo_writer_add_int_auto(ctx->w, i32);
+	case UJO_TYPE_INT16:
+		return_on_err(ujo_element_get_int16(e, &i16));
+		return ujo_writer_add_int_auto(ctx->w, i16);
+	case UJO_TYPE_INT8:
+		return_on_err(ujo_element_get_int8(e, &i8));
+		return ujo_writer_add_int8(ctx->w, i8);
+
+	case UJO_TYPE_UINT64:
+		return_on_err(ujo_element_get_uint64(e, &u64));
+		return ujo_writer_add_uint_auto(ctx->w, u64);
+	case UJO_TYPE_UINT32:
+		return_on_err(ujo_element_get_uint32(e, &u32));
+		return ujo_writer_add_uint_auto(ctx->w, u32);
+	case UJO_TYPE_UINT16:
+		return_on_err(ujo_element_get_uint16(e, &u16));
+		return ujo_writer_add_uint_auto(ctx->w, u16);
+	case UJO_TYPE_UINT8:
+		return_on_err(ujo_element_get_uint8(e, &u8));
+		return ujo_writer_add_uint8(ctx->w, u8);
+
+	case UJO_TYPE_FLOAT64:
+		return_on_err(ujo_element_get_float64(e, &f64));
+		return ujo_writer_add_float_auto(ctx->w, f64);
+	case UJO_TYPE_FLOAT32:
+		return_on_err(ujo_element_get_float32(e, &f32));
+		return ujo_writer_add_float_auto(ctx->w, f32);
+	case UJO_TYPE_FLOAT16:
+		// half precision is the smallest float, NaN and infinity are copied as they are
+		return_on_err(_ujo_element_get_float16_raw(e, &u16));
+		return _ujo_writer_add_float16_raw(ctx->w, u16);
+
+	case UJO_TYPE_BOOL:
+		return_on_err(ujo_element_get_bool(e, &b));
+		return ujo_writer_add_bool(ctx->w, b);
+	case UJO_TYPE_NONE:
+		return ujo_writer_add_none(ctx->w);
+
+	case UJO_TYPE_UX_TIME:
+		return_on_err(ujo_element_get_uxtime(e, &i64));
+		return ujo_writer_add_uxtime(ctx->w, i64);
+	case UJO_TYPE_DATE:
+		return_on_err(ujo_element_get_date(e, &dt));
+		return ujo_writer_add_date(ctx->w, dt);
+	case UJO_TYPE_TIME:
+		return_on_err(ujo_element_get_time(e, &dt));
+		return ujo_writer_add_time(ctx->w, dt);
+	case UJO_TYPE_TIMESTAMP:
+		return_on_err(ujo_element_get_timestamp(e, &dt));
+		return ujo_writer_add_timestamp(ctx->w, dt);
+
+	case UJO_TYPE_STRING:
+		return _ujo_repack_string(ctx, e);
+	case UJO_TYPE_BIN:
+		return_on_err(ujo_element_get_binary(e, &u8, &data, &n));
+		return ujo_writer_add_binary(ctx->w, u8, data, n);
+
+	default:
+		return_on_err(ujo_element_get_null_type(e, &type));
+		return ujo_writer_add_null(ctx->w, type);
+	}
+}
+
+/**
+@endcond
+*/
+
+/** 
+ * \addtogroup ujo_repack
+ * @{
+ */
+
+/**
+ * @brief Rewrite an UJO document in its smallest form.
+ *
+ * All elements of the document are read one by one from the reader and
+ * written to the writer. Numeric values are narrowed to the smallest type
+ * representing the same value and UTF-16 or UTF-32 strings containing only
+ * ASCII characters are converted to UTF-8. The structure of the document
+ * is not changed.
+ *
+ * The memory used does not depend on the document size, apart from the
+ * largest single value. The same input always results in the same output.
+ *
+ * @param r    ujo reader handle positioned at the start of a document
+ * @param w    ujo writer handle of a new document
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_repack_file, ujo_writer_add_int_auto, ujo_writer_add_float_auto
+ */
+ujoError ujo_repack(ujo_reader* r, ujo_writer* w)
+{
+	ujoError       err;
+	ujo_repack_ctx ctx;
+	ujo_element*   e;
+	ujoBool        eod;
+
+	report_error(r, "invalid reader handle", UJO_ERR_INVALID_DATA);
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.r = r;
+	ctx.w = w;
+
+	err = ujo_reader_get_first(r, &e, &eod);
+
+	while (err == UJO_SUCCESS && !eod)
+	{
+		err = _ujo_repack_element(&ctx, e);
+		ujo_free_element(e);
+
+		if (err == UJO_SUCCESS)
+			err = ujo_reader_get_next(r, &e, &eod);
+	}
+
+	ujo_free(ctx.containers);
+	ujo_free(ctx.scratch);
+
+	return err;
+};
+
+/**
+ * @brief Rewrite an UJO file in its smallest form.
+ *
+ * The source file is read with a file reader and the result is written
+ * to the destination file using ujo_repack().
+ *
+ * @param source       path of the UJO file to read
+ * @param destination  path of the UJO file to create
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_repack
+ */
+ujoError ujo_repack_file(const char* source, const char* destination)
+{
+	ujoError    err;
+	ujo_reader* r;
+	ujo_writer* w;
+
+	return_on_err(ujo_new_file_reader(&r, source));
+
+	err = ujo_new_file_writer(&w, destination);
+	if (err != UJO_SUCCESS)
+	{
+		ujo_free_reader(r);
+		return err;
+	}
+
+	err = ujo_repack(r, w);
+
+	ujo_free_writer(w);
+	ujo_free_reader(r);
+
+	return err;
+};
+
+/* @} */
@@ -38,20 +38,37 @@ struct _ujoStack {
 	int            size;
 	int            items;
 	ujoDestroyFunc destroy;
+	const ujoAllocator* allocator;
+
+	// pool of spare items for reuse
+	ujoPointer     *spare;
+	int            sparesize;
+	int            spares;
 };
 
 ujoStack* ujo_new_stack(ujoDestroyFunc destroy_data)
+{
+	return ujo_new_stack_ex(destroy_data, NULL);
+};
+
+ujoStack* ujo_new_stack_ex(ujoDestroyFunc destroy_data, const ujoAllocator* allocator)
 {
 	ujoStack *stack;
 
-	stack = ujo_new(ujoStack, 1);
+	stack = ujo_new_ex(allocator, ujoStack, 1);
 	if (stack == NULL)
 		return NULL;
 	stack->destroy = destroy_data;
+	stack->allocator = allocator;
 
 	return stack;
 };
 
+const ujoAllocator* ujo_stack_get_allocator(ujoStack* stack)
+{
+	return stack->allocator;
+};
+
 ujoBool ujo_stack_is_empty(ujoStack* stack) 
 {
 	return_val_if_fail(stack,"invalid pointer",ujoFalse);
@@ -77,10 +94,11 @@ void ujo_free_stack(ujoStack* stack)
 	ujo_clear_stack(stack);
 
 	/* free stack array */
-	if (stack->stack) ujo_free(stack->stack);
+	if (stack->stack) ujo_allocator_free(stack->allocator, stack->stack);
+	if (stack->spare) ujo_allocator_free(stack->allocator, stack->spare);
 
 	/* free stack */
-	ujo_free(stack);
+	ujo_allocator_free(stack->allocator, stack);
 
 	return;
 };
@@ -94,11 +112,12 @@ void ujo_stack_push(ujoStack* stack, ujoPointer data)
 
 	if (stack->size == stack->items) {
 		if (!stack->stack) {
-			stack->stack = ujo_new(ujoPointer, 1);
+			stack->stack = ujo_new_ex(stack->allocator, ujoPointer, 1);
 			return_if_fail(stack->stack, "stack not allocated");
 		} else {
 			temp = stack->stack;
-			stack->stack = (ujoPointer*)realloc(stack->stack, sizeof(ujoPointer)*(stack->size +1));
+			stack->stack = (ujoPointer*)ujo_allocator_realloc(stack->allocator, stack->stack, 
+				sizeof(ujoPointer)*stack->size, sizeof(ujoPointer)*(stack->size +1));
 			if (stack->stack == NULL) {
 				stack->stack = temp;
 				return_if_fail(ujoFalse, "resize stack failed");
@@ -130,6 +149,35 @@ ujoPointer ujo_stack_pop(ujoStack* stack)
 	return pointer;
 };
 
+ujoBool ujo_stack_recycle(ujoStack* stack, ujoPointer data)
+{
+	ujoPointer *temp;
+
+	return_val_if_fail(stack, "invalid stack", ujoFalse);
+
+	if (stack->sparesize == stack->spares) {
+		temp = (ujoPointer*)ujo_allocator_realloc(stack->allocator, stack->spare, 
+			sizeof(ujoPointer)*stack->sparesize, sizeof(ujoPointer)*(stack->sparesize + 4));
+		if (temp == NULL)
+			return ujoFalse;
+		stack->spare = temp;
+		stack->sparesize += 4;
+	}
+	stack->spare[stack->spares++] = data;
+
+	return ujoTrue;
+};
+
+ujoPointer ujo_stack_reuse(ujoStack* stack)
+{
+	return_val_if_fail(stack, "invalid stack", NULL);
+
+	if (stack->spares == 0)
+		return NULL;
+
+	return stack->spare[--stack->spares];
+};
+
 /** 
 @endcond
 */
@@ -37,6 +37,10 @@ BEGIN_C_DECLS
 
 ujoStack* ujo_new_stack(ujoDestroyFunc destroy_data);
 
+ujoStack* ujo_new_stack_ex(ujoDestroyFunc destroy_data, const ujoAllocator* allocator);
+
+const ujoAllocator* ujo_stack_get_allocator(ujoStack* stack);
+
 void ujo_free_stack(ujoStack* stack);
 
 void ujo_clear_stack(ujoStack* stack);
@@ -47,6 +51,10 @@ ujoPointer ujo_stack_pop(ujoStack* stack);
 
 ujoBool ujo_stack_is_empty(ujoStack* stack);
 
+ujoBool ujo_stack_recycle(ujoStack* stack, ujoPointer data);
+
+ujoPointer ujo_stack_reuse(ujoStack* stack);
+
 END_C_DECLS
 
 #endif
\ No newline at end of file
@@ -26,6 +26,7 @@
 
 #include "ujo_state.h"
 #include "ujo_macros.h"
+#include <string.h>
 
 ujoBool ujo_state_allow_atomic(ujoDocState s)
 {
@@ -51,7 +52,13 @@ ujoBool ujo_state_allow_string(ujoDocState s)
 
 ujo_state* ujo_state_next(ujoDocState s, ujo_state* c, ujoStack *stack)
 {
-	ujo_state *pstate = ujo_new(ujo_state, 1);
+	ujo_state *pstate = (ujo_state*)ujo_stack_reuse(stack);
+
+	/* states of closed containers are reused */
+	if (pstate == NULL)
+		pstate = ujo_new_ex(ujo_stack_get_allocator(stack), ujo_state, 1);
+	else
+		memset(pstate, 0, sizeof(ujo_state));
 	pstate->state = s;
 
 	ujo_stack_push(stack, c);
@@ -62,7 +69,8 @@ ujo_state* ujo_state_prev(ujo_state* o, ujoStack *stack)
 {
 	ujo_state* pstate = (ujo_state*)ujo_stack_pop(stack);
 
-	ujo_free(o);
+	if (!ujo_stack_recycle(stack, o))
+		ujo_allocator_free(ujo_stack_get_allocator(stack), o);
 	
 	/* if we are in root again, the document is closed */
 	if (pstate->state == STATE_ROOT) {
@@ -71,6 +79,31 @@ ujo_state* ujo_state_prev(ujo_state* o, ujoStack *stack)
 	return pstate;
 };
 
+void ujo_state_clear(ujoStack *stack)
+{
+	ujoPointer s;
+
+	while (!ujo_stack_is_empty(stack))
+		ujo_allocator_free(ujo_stack_get_allocator(stack), ujo_stack_pop(stack));
+	while ((s = ujo_stack_reuse(stack)) != NULL)
+		ujo_allocator_free(ujo_stack_get_allocator(stack), s);
+};
+
+ujo_state* ujo_state_rewind(ujo_state* s, ujoStack *stack)
+{
+	/* the bottom of the stack is the root state */
+	while (!ujo_stack_is_empty(stack))
+	{
+		if (!ujo_stack_recycle(stack, s))
+			ujo_allocator_free(ujo_stack_get_allocator(stack), s);
+		s = (ujo_state*)ujo_stack_pop(stack);
+	}
+	memset(s, 0, sizeof(ujo_state));
+	s->state = STATE_ROOT;
+
+	return s;
+};
+
 ujo_state* ujo_state_switch(ujoDocEvent e, ujo_state* s, ujoStack *stack) 
 {
 	switch (e) {
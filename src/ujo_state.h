@@ -38,7 +38,8 @@ typedef enum {
 	STATE_DICT_VALUE,
 	STATE_CLOSED,
 	STATE_TABLE_COLUMNS,
-	STATE_TABLE_VALUES
+	STATE_TABLE_VALUES,
+	STATE_BINARY
 } ujoDocState;
 
 /* UJO writer state structure */
@@ -66,6 +67,8 @@ ujoBool ujo_state_allow_string(ujoDocState s);
 
 ujo_state* ujo_state_next(ujoDocState s, ujo_state* c, ujoStack *stack);
 ujo_state* ujo_state_prev(ujo_state* o, ujoStack *stack);
+void       ujo_state_clear(ujoStack *stack);
+ujo_state* ujo_state_rewind(ujo_state* s, ujoStack *stack);
 
 ujo_state* ujo_state_switch(ujoDocEvent e, ujo_state* s, ujoStack *stack);
 
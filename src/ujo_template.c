@@ -0,0 +1,1078 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ */
+
+#include "ujo_template.h"
+#include "ujo_reader.h"
+#include "ujo_errors.h"
+#include "ujo_log.h"
+#include "ujo_macros.h"
+#include "ujo_constants.h"
+#include "ujo_endian.h"
+#include <string.h>
+
+/** 
+@cond INTERNAL_DOCS
+*/
+
+typedef struct {
+	ujoTypeId   type;
+	uint32_t    offset;     // offset of the value octets in the image
+	uint32_t    width;      // number of value octets
+
+	// struct field for ujo_template_match()
+	ujoBool     bound;
+	size_t      field;
+} ujo_template_slot;
+
+struct _ujo_template {
+	// writer used to build the template, NULL after ujo_template_finish()
+	ujo_writer*         w;
+
+	ujo_template_slot*  slots;
+	uint32_t            count;
+	uint32_t            size;
+
+	// encoded document
+	ujoByte*            image;
+	size_t              bytes;
+
+	// 0xFF for the octets of the document skeleton, 0x00 for slot values
+	ujoByte*            mask;
+	uint32_t            bound;
+
+	// arena readers of the element by element match, created on first use
+	ujo_reader*         tr;
+	ujo_reader*         dr;
+	ujoIovec            tvec;
+	ujoIovec            dvec;
+};
+
+static __inline ujoError _ujo_template_get_slot(ujo_template* t, ujoSlot slot, ujo_template_slot** s)
+{
+	report_error(t, "invalid template handle", UJO_ERR_INVALID_DATA);
+	report_error(t->image, "template not finished", UJO_ERR_INVALID_OBJECT);
+	report_error(slot < t->count, "invalid slot", UJO_ERR_INVALID_DATA);
+
+	*s = &t->slots[slot];
+
+	return UJO_SUCCESS;
+}
+
+static __inline uint32_t _ujo_template_slot_width(ujoTypeId type)
+{
+	switch (type)
+	{
+	case UJO_TYPE_INT64:
+	case UJO_TYPE_UINT64:
+	case UJO_TYPE_FLOAT64:
+	case UJO_TYPE_UX_TIME:
+		return 8;
+	case UJO_TYPE_INT32:
+	case UJO_TYPE_UINT32:
+	case UJO_TYPE_FLOAT32:
+	case UJO_TYPE_DATE:
+		return 4;
+	case UJO_TYPE_INT16:
+	case UJO_TYPE_UINT16:
+	case UJO_TYPE_FLOAT16:
+		return 2;
+	case UJO_TYPE_TIME:
+		return 3;
+	case UJO_TYPE_TIMESTAMP:
+		return 9;
+	default:
+		return 1;
+	}
+}
+
+/* compare the skeleton of two documents of equal size one word at a time,
+   the loop has no data dependent branches and is vectorized by the compiler */
+static __inline ujoBool _ujo_template_skeleton_equal(const ujoByte* a, const ujoByte* b, const ujoByte* mask, size_t bytes)
+{
+	uint64_t x, y, m;
+	uint64_t diff = 0;
+	size_t   i;
+
+	for (i = 0; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t))
+	{
+		memcpy(&x, a+i, sizeof(uint64_t));
+		memcpy(&y, b+i, sizeof(uint64_t));
+		memcpy(&m, mask+i, sizeof(uint64_t));
+		diff |= (x ^ y) & m;
+	}
+	for (; i < bytes; i++)
+		diff |= (uint64_t)((a[i] ^ b[i]) & mask[i]);
+
+	return (ujoBool)(diff == 0);
+}
+
+/* decode a slot value at its fixed offset into a struct field */
+static __inline void _ujo_template_load(const ujo_template_slot* s, const ujoByte* p, ujoByte* dst)
+{
+	uint64_t    u64;
+	uint32_t    u32;
+	uint16_t    u16;
+	float64_t   f64;
+	float32_t   f32;
+	int16_t     i16;
+	ujoDateTime dt;
+
+	switch (s->type)
+	{
+	case UJO_TYPE_INT64:
+	case UJO_TYPE_UINT64:
+	case UJO_TYPE_UX_TIME:
+		memcpy(&u64, p, sizeof(uint64_t));
+		u64 = UJO_UINT64_SWAP(u64);
+		memcpy(dst, &u64, sizeof(uint64_t));
+		break;
+	case UJO_TYPE_FLOAT64:
+		memcpy(&f64, p, sizeof(float64_t));
+		f64 = (float64_t)UJO_FLOAT64_SWAP(f64);
+		memcpy(dst, &f64, sizeof(float64_t));
+		break;
+	case UJO_TYPE_INT32:
+	case UJO_TYPE_UINT32:
+		memcpy(&u32, p, sizeof(uint32_t));
+		u32 = UJO_UINT32_SWAP(u32);
+		memcpy(dst, &u32, sizeof(uint32_t));
+		break;
+	case UJO_TYPE_FLOAT32:
+		memcpy(&f32, p, sizeof(float32_t));
+		f32 = (float32_t)UJO_FLOAT32_SWAP(f32);
+		memcpy(dst, &f32, sizeof(float32_t));
+		break;
+	case UJO_TYPE_INT16:
+	case UJO_TYPE_UINT16:
+		memcpy(&u16, p, sizeof(uint16_t));
+		u16 = UJO_UINT16_SWAP(u16);
+		memcpy(dst, &u16, sizeof(uint16_t));
+		break;
+	case UJO_TYPE_FLOAT16:
+		memcpy(&u16, p, sizeof(uint16_t));
+		f32 = half_to_float((float16_t)UJO_UINT16_SWAP(u16));
+		memcpy(dst, &f32, sizeof(float32_t));
+		break;
+	case UJO_TYPE_BOOL:
+		*dst = p[0] ? ujoTrue : ujoFalse;
+		break;
+	case UJO_TYPE_DATE:
+	case UJO_TYPE_TIME:
+	case UJO_TYPE_TIMESTAMP:
+		memset(&dt, 0, sizeof(ujoDateTime));
+		if (s->type == UJO_TYPE_TIME)
+		{
+			dt.hour   = p[0];
+			dt.minute = p[1];
+			dt.second = p[2];
+		}
+		else
+		{
+			memcpy(&i16, p, sizeof(int16_t));
+			dt.year  = (int16_t)UJO_UINT16_SWAP(i16);
+			dt.month = p[2];
+			dt.day   = p[3];
+			if (s->type == UJO_TYPE_TIMESTAMP)
+			{
+				dt.hour   = p[4];
+				dt.minute = p[5];
+				dt.second = p[6];
+				memcpy(&i16, p+7, sizeof(int16_t));
+				dt.millisecond = (uint16_t)UJO_UINT16_SWAP(i16);
+			}
+		}
+		memcpy(dst, &dt, sizeof(ujoDateTime));
+		break;
+	default:
+		*dst = *p;
+		break;
+	}
+}
+
+static __inline ujoError _ujo_template_store_int(ujoTypeId type, int64_t value, ujoByte* dst)
+{
+	int32_t i32;
+	int16_t i16;
+	int8_t  i8;
+
+	switch (type)
+	{
+	case UJO_TYPE_INT64:
+		if (dst) memcpy(dst, &value, sizeof(int64_t));
+		break;
+	case UJO_TYPE_INT32:
+		report_error(value >= INT32_MIN && value <= INT32_MAX, "value out of slot range", UJO_ERR_TEMPLATE_MISMATCH);
+		i32 = (int32_t)value;
+		if (dst) memcpy(dst, &i32, sizeof(int32_t));
+		break;
+	case UJO_TYPE_INT16:
+		report_error(value >= INT16_MIN && value <= INT16_MAX, "value out of slot range", UJO_ERR_TEMPLATE_MISMATCH);
+		i16 = (int16_t)value;
+		if (dst) memcpy(dst, &i16, sizeof(int16_t));
+		break;
+	default:
+		report_error(value >= INT8_MIN && value <= INT8_MAX, "value out of slot range", UJO_ERR_TEMPLATE_MISMATCH);
+		i8 = (int8_t)value;
+		if (dst) memcpy(dst, &i8, sizeof(int8_t));
+		break;
+	}
+	return UJO_SUCCESS;
+}
+
+static __inline ujoError _ujo_template_store_uint(ujoTypeId type, uint64_t value, ujoByte* dst)
+{
+	uint32_t u32;
+	uint16_t u16;
+
+	switch (type)
+	{
+	case UJO_TYPE_UINT64:
+		if (dst) memcpy(dst, &value, sizeof(uint64_t));
+		break;
+	case UJO_TYPE_UINT32:
+		report_error(value <= UINT32_MAX, "value out of slot range", UJO_ERR_TEMPLATE_MISMATCH);
+		u32 = (uint32_t)value;
+		if (dst) memcpy(dst, &u32, sizeof(uint32_t));
+		break;
+	case UJO_TYPE_UINT16:
+		report_error(value <= UINT16_MAX, "value out of slot range", UJO_ERR_TEMPLATE_MISMATCH);
+		u16 = (uint16_t)value;
+		if (dst) memcpy(dst, &u16, sizeof(uint16_t));
+		break;
+	default:
+		report_error(value <= UINT8_MAX, "value out of slot range", UJO_ERR_TEMPLATE_MISMATCH);
+		if (dst) *dst = (uint8_t)value;
+		break;
+	}
+	return UJO_SUCCESS;
+}
+
+/* convert an element of the same type family as the slot into a struct field */
+static ujoError _ujo_template_load_element(const ujo_template_slot* s, ujo_element* e, ujoByte* dst)
+{
+	ujoError    err;
+	ujoTypeId   type;
+	int64_t     i64;
+	int32_t     i32;
+	int16_t     i16;
+	int8_t      i8;
+	uint64_t    u64;
+	uint32_t    u32;
+	uint16_t    u16;
+	uint8_t     u8;
+	float64_t   f64;
+	float32_t   f32;
+	ujoBool     b;
+	ujoDateTime dt;
+
+	return_on_err(ujo_element_get_type(e, &type));
+
+	switch (s->type)
+	{
+	case UJO_TYPE_INT64:
+	case UJO_TYPE_INT32:
+	case UJO_TYPE_INT16:
+	case UJO_TYPE_INT8:
+		switch (type)
+		{
+		case UJO_TYPE_INT64:
+			return_on_err(ujo_element_get_int64(e, &i64)); break;
+		case UJO_TYPE_INT32:
+			return_on_err(ujo_element_get_int32(e, &i32)); i64 = i32; break;
+		case UJO_TYPE_INT16:
+			return_on_err(ujo_element_get_int16(e, &i16)); i64 = i16; break;
+		case UJO_TYPE_INT8:
+			return_on_err(ujo_element_get_int8(e, &i8)); i64 = i8; break;
+		default:
+			report_error(ujoFalse, "slot type mismatch", UJO_ERR_TEMPLATE_MISMATCH);
+		}
+		return _ujo_template_store_int(s->type, i64, dst);
+	case UJO_TYPE_UINT64:
+	case UJO_TYPE_UINT32:
+	case UJO_TYPE_UINT16:
+	case UJO_TYPE_UINT8:
+		switch (type)
+		{
+		case UJO_TYPE_UINT64:
+			return_on_err(ujo_element_get_uint64(e, &u64)); break;
+		case UJO_TYPE_UINT32:
+			return_on_err(ujo_element_get_uint32(e, &u32)); u64 = u32; break;
+		case UJO_TYPE_UINT16:
+			return_on_err(ujo_element_get_uint16(e, &u16)); u64 = u16; break;
+		case UJO_TYPE_UINT8:
+			return_on_err(ujo_element_get_uint8(e, &u8)); u64 = u8; break;
+		default:
+			report_error(ujoFalse, "slot type mismatch", UJO_ERR_TEMPLATE_MISMATCH);
+		}
+		return _ujo_template_store_uint(s->type, u64, dst);
+	case UJO_TYPE_FLOAT64:
+	case UJO_TYPE_FLOAT32:
+	case UJO_TYPE_FLOAT16:
+		switch (type)
+		{
+		case UJO_TYPE_FLOAT64:
+			return_on_err(ujo_element_get_float64(e, &f64)); break;
+		case UJO_TYPE_FLOAT32:
+			return_on_err(ujo_element_get_float32(e, &f32)); f64 = f32; break;
+		case UJO_TYPE_FLOAT16:
+			return_on_err(ujo_element_get_float16(e, &f32)); f64 = f32; break;
+		default:
+			report_error(ujoFalse, "slot type mismatch", UJO_ERR_TEMPLATE_MISMATCH);
+		}
+		if (dst == NULL)
+			break;
+		if (s->type == UJO_TYPE_FLOAT64)
+		{
+			memcpy(dst, &f64, sizeof(float64_t));
+		}
+		else
+		{
+			f32 = (float32_t)f64;
+			memcpy(dst, &f32, sizeof(float32_t));
+		}
+		break;
+	case UJO_TYPE_BOOL:
+		report_error(type == s->type, "slot type mismatch", UJO_ERR_TEMPLATE_MISMATCH);
+		return_on_err(ujo_element_get_bool(e, &b));
+		if (dst) *dst = b;
+		break;
+	case UJO_TYPE_UX_TIME:
+		report_error(type == s->type, "slot type mismatch", UJO_ERR_TEMPLATE_MISMATCH);
+		return_on_err(ujo_element_get_uxtime(e, &i64));
+		if (dst) memcpy(dst, &i64, sizeof(int64_t));
+		break;
+	default:
+		report_error(type == s->type, "slot type mismatch", UJO_ERR_TEMPLATE_MISMATCH);
+		memset(&dt, 0, sizeof(ujoDateTime));
+		if (type == UJO_TYPE_DATE) {
+			return_on_err(ujo_element_get_date(e, &dt));
+		} else if (type == UJO_TYPE_TIME) {
+			return_on_err(ujo_element_get_time(e, &dt));
+		} else {
+			return_on_err(ujo_element_get_timestamp(e, &dt));
+		}
+		if (dst) memcpy(dst, &dt, sizeof(ujoDateTime));
+		break;
+	}
+	return UJO_SUCCESS;
+}
+
+/* the readers are kept with the template, elements are taken from their arenas */
+static ujoError _ujo_template_new_reader(ujo_reader** r)
+{
+	ujoError err;
+
+	return_on_err(ujo_new_memory_reader(r));
+	err = ujo_reader_use_arena(*r, 0);
+	if (err != UJO_SUCCESS)
+	{
+		ujo_free_reader(*r);
+		*r = NULL;
+	}
+	return err;
+}
+
+/* walk the template and the document in lockstep with the generic reader */
+static ujoError _ujo_template_match_elements(ujo_template* t, const ujoByte* buffer, size_t bytes, ujoByte* out)
+{
+	ujoError           err;
+	ujo_reader*        tr;
+	ujo_reader*        dr;
+	ujo_element*       te = NULL;
+	ujo_element*       de = NULL;
+	ujoBool            teod = ujoFalse;
+	ujoBool            deod = ujoFalse;
+	ujo_template_slot* s;
+	uint32_t           slot = 0;
+
+	if (t->tr == NULL)
+	{
+		return_on_err(_ujo_template_new_reader(&t->tr));
+	}
+	if (t->dr == NULL)
+	{
+		return_on_err(_ujo_template_new_reader(&t->dr));
+	}
+	tr = t->tr;
+	dr = t->dr;
+
+	/* both documents are read in place */
+	t->tvec.base = t->image;
+	t->tvec.len  = t->bytes;
+	t->dvec.base = (ujoByte*)buffer;
+	t->dvec.len  = bytes;
+	ujo_reader_reset_arena(tr);
+	ujo_reader_reset_arena(dr);
+
+	err = ujo_reader_set_iovecs(tr, &t->tvec, 1);
+	if (err == UJO_SUCCESS)
+		err = ujo_reader_set_iovecs(dr, &t->dvec, 1);
+	if (err == UJO_SUCCESS)
+		err = ujo_reader_get_first(tr, &te, &teod);
+	if (err == UJO_SUCCESS)
+		err = ujo_reader_get_first(dr, &de, &deod);
+
+	while (err == UJO_SUCCESS && !teod && !deod)
+	{
+		s = (slot < t->count) ? &t->slots[slot] : NULL;
+		if (s != NULL && _ujo_reader_get_position(tr) == (size_t)s->offset + s->width)
+		{
+			err = _ujo_template_load_element(s, de, s->bound ? out + s->field : NULL);
+			slot++;
+		}
+		else if (!_ujo_element_equal(te, de))
+		{
+			err = UJO_ERR_TEMPLATE_MISMATCH;
+		}
+
+		ujo_free_element(te);
+		ujo_free_element(de);
+		te = NULL;
+		de = NULL;
+
+		if (err == UJO_SUCCESS)
+			err = ujo_reader_get_next(tr, &te, &teod);
+		if (err == UJO_SUCCESS)
+			err = ujo_reader_get_next(dr, &de, &deod);
+	}
+	if (err == UJO_SUCCESS && teod != deod)
+		err = UJO_ERR_TEMPLATE_MISMATCH;
+
+	if (te != NULL)
+		ujo_free_element(te);
+	if (de != NULL)
+		ujo_free_element(de);
+
+	return err;
+}
+
+static __inline ujoError _ujo_template_add_placeholder(ujo_writer* w, ujoTypeId type)
+{
+	ujoDateTime dt = { 1970, 1, 1, 0, 0, 0, 0 };
+
+	switch (type)
+	{
+	case UJO_TYPE_INT64:
+		return ujo_writer_add_int64(w, 0);
+	case UJO_TYPE_INT32:
+		return ujo_writer_add_int32(w, 0);
+	case UJO_TYPE_INT16:
+		return ujo_writer_add_int16(w, 0);
+	case UJO_TYPE_INT8:
+		return ujo_writer_add_int8(w, 0);
+	case UJO_TYPE_UINT64:
+		return ujo_writer_add_uint64(w, 0);
+	case UJO_TYPE_UINT32:
+		return ujo_writer_add_uint32(w, 0);
+	case UJO_TYPE_UINT16:
+		return ujo_writer_add_uint16(w, 0);
+	case UJO_TYPE_UINT8:
+		return ujo_writer_add_uint8(w, 0);
+	case UJO_TYPE_FLOAT64:
+		return ujo_writer_add_float64(w, 0.0);
+	case UJO_TYPE_FLOAT32:
+		return ujo_writer_add_float32(w, 0.0f);
+	case UJO_TYPE_FLOAT16:
+		return ujo_writer_add_float16(w, 0.0f);
+	case UJO_TYPE_BOOL:
+		return ujo_writer_add_bool(w, ujoFalse);
+	case UJO_TYPE_UX_TIME:
+		return ujo_writer_add_uxtime(w, 0);
+	case UJO_TYPE_DATE:
+		return ujo_writer_add_date(w, dt);
+	case UJO_TYPE_TIME:
+		return ujo_writer_add_time(w, dt);
+	case UJO_TYPE_TIMESTAMP:
+		return ujo_writer_add_timestamp(w, dt);
+	default:
+		report_error(ujoFalse, "type has no fixed size", UJO_ERR_INVALID_DATA);
+	}
+}
+
+/** 
+@endcond
+*/
+
+/** 
+ * \addtogroup ujo_template
+ * @{
+ */
+
+/**
+ * @brief Create a new template.
+ *
+ * A template is a pre-encoded document with a fixed structure. Only
+ * the values in the slots of the template change from one message to the
+ * next. The values are patched directly into the encoded document, so 
+ * no state validation and no buffer management is needed to produce a message.
+ *
+ * The template is built with the writer returned by ujo_template_get_writer().
+ * Values that change are added as slots with ujo_template_add_slot(). After
+ * closing the document ujo_template_finish() freezes the template.
+ *
+ * \code{.c}
+ *   ujo_new_template(&tpl);
+ *   ujo_template_get_writer(tpl, &w);
+ *   ujo_writer_map_open(w);
+ *     ujo_writer_add_string_c(w, "temp", 4);
+ *     ujo_template_add_slot(tpl, UJO_TYPE_FLOAT32, &temp);
+ *   ujo_writer_map_close(w);
+ *   ujo_template_finish(tpl);
+ *
+ *   ujo_template_set_float(tpl, temp, 21.5);
+ *   ujo_template_get_buffer(tpl, &buffer, &bytes);
+ * \endcode
+ *
+ * @param t    reference to a template
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_free_template
+ */
+ujoError ujo_new_template(ujo_template** t)
+{
+	ujoError      err;
+	ujo_template* newhdl;
+
+	newhdl = ujo_new(ujo_template, 1);
+	report_error(newhdl, "allocation failed", UJO_ERR_ALLOCATION);
+
+	err = ujo_new_memory_writer(&newhdl->w);
+	if (err != UJO_SUCCESS)
+	{
+		ujo_free(newhdl);
+		return err;
+	}
+
+	*t = newhdl;
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Dispose a template.
+ *
+ * @param t    ujo template handle
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_new_template
+ */
+ujoError ujo_free_template(ujo_template* t)
+{
+	report_error(t, "invalid template handle", UJO_ERR_INVALID_DATA);
+
+	if (t->w != NULL)
+		ujo_free_writer(t->w);
+	if (t->tr != NULL)
+		ujo_free_reader(t->tr);
+	if (t->dr != NULL)
+		ujo_free_reader(t->dr);
+	ujo_free(t->slots);
+	ujo_free(t->image);
+	ujo_free(t->mask);
+	ujo_free(t);
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Get the writer to build a template.
+ *
+ * The writer is used like any other memory writer to build the fixed 
+ * part of the document. It is owned by the template and is no longer
+ * valid after ujo_template_finish().
+ *
+ * @param t    ujo template handle
+ * @param w    reference to a writer
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_add_slot, ujo_template_finish
+ */
+ujoError ujo_template_get_writer(ujo_template* t, ujo_writer** w)
+{
+	report_error(t, "invalid template handle", UJO_ERR_INVALID_DATA);
+	report_error(t->w, "template already finished", UJO_ERR_INVALID_OBJECT);
+
+	*w = t->w;
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Add a value slot to a template.
+ *
+ * A slot is a placeholder for a value of fixed size. It is written at 
+ * the current position of the template writer. Slots can be added
+ * for integer, float, bool, unix time, date, time and timestamp types.
+ * The slot is initialized to zero.
+ *
+ * @param t    ujo template handle
+ * @param type type of the slot value
+ * @param slot reference to the slot index
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_set_int, ujo_template_set_uint, ujo_template_set_float,
+ * ujo_template_set_bool, ujo_template_set_uxtime, ujo_template_set_datetime
+ */
+ujoError ujo_template_add_slot(ujo_template* t, ujoTypeId type, ujoSlot* slot)
+{
+	ujoError           err;
+	ujoByte*           buffer;
+	size_t             bytes;
+	ujo_template_slot* temp;
+
+	report_error(t, "invalid template handle", UJO_ERR_INVALID_DATA);
+	report_error(t->w, "template already finished", UJO_ERR_INVALID_OBJECT);
+
+	return_on_err(ujo_writer_get_buffer(t->w, &buffer, &bytes));
+	return_on_err(_ujo_template_add_placeholder(t->w, type));
+
+	if (t->count == t->size)
+	{
+		temp = (ujo_template_slot*)ujo_realloc(t->slots, (t->size + 16) * sizeof(ujo_template_slot));
+		report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+		t->slots = temp;
+		t->size += 16;
+	}
+
+	// the value follows the type octet
+	t->slots[t->count].type   = type;
+	t->slots[t->count].offset = (uint32_t)bytes + 1;
+	t->slots[t->count].width  = _ujo_template_slot_width(type);
+	t->slots[t->count].bound  = ujoFalse;
+	*slot = t->count++;
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Finish a template.
+ *
+ * The document of the template has to be closed. The encoded document 
+ * is kept as template image and the writer is released. Slot values can
+ * be set after the template is finished.
+ *
+ * @param t    ujo template handle
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_get_buffer
+ */
+ujoError ujo_template_finish(ujo_template* t)
+{
+	ujoError err;
+	ujoByte* buffer;
+	ujoByte* mask;
+	ujoByte* image;
+	size_t   bytes;
+	uint32_t i;
+
+	report_error(t, "invalid template handle", UJO_ERR_INVALID_DATA);
+	report_error(t->w, "template already finished", UJO_ERR_INVALID_OBJECT);
+	report_error(_ujo_writer_is_closed(t->w), "document not closed", UJO_ERR_INVALID_OBJECT);
+
+	return_on_err(ujo_writer_get_buffer(t->w, &buffer, &bytes));
+
+	/* both buffers are allocated before either is kept, a failed finish can be repeated */
+	mask = ujo_new(ujoByte, bytes);
+	report_error(mask, "allocation failed", UJO_ERR_ALLOCATION);
+	image = ujo_new(ujoByte, bytes);
+	if (!image)
+	{
+		ujo_free(mask);
+		report_error(0, "allocation failed", UJO_ERR_ALLOCATION);
+	}
+
+	memset(mask, 0xFF, bytes);
+	for (i = 0; i < t->count; i++)
+		memset(mask + t->slots[i].offset, 0, t->slots[i].width);
+	memcpy(image, buffer, bytes);
+
+	t->mask  = mask;
+	t->image = image;
+	t->bytes = bytes;
+
+	ujo_free_writer(t->w);
+	t->w = NULL;
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Set a signed integer slot.
+ *
+ * The slot has to be of a signed integer type and the value
+ * has to fit into the slot type.
+ *
+ * @param t     ujo template handle
+ * @param slot  slot index
+ * @param value signed integer value
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_add_slot
+ */
+ujoError ujo_template_set_int(ujo_template* t, ujoSlot slot, int64_t value)
+{
+	ujoError           err;
+	ujo_template_slot* s;
+	ujoByte*           p;
+	int32_t            i32;
+	int16_t            i16;
+	int8_t             i8;
+
+	return_on_err(_ujo_template_get_slot(t, slot, &s));
+	p = t->image + s->offset;
+
+	switch (s->type)
+	{
+	case UJO_TYPE_INT64:
+		value = (int64_t)UJO_UINT64_SWAP(value);
+		memcpy(p, &value, sizeof(int64_t));
+		break;
+	case UJO_TYPE_INT32:
+		report_error(value >= INT32_MIN && value <= INT32_MAX, "value out of range", UJO_ERR_INVALID_DATA);
+		i32 = (int32_t)UJO_UINT32_SWAP((int32_t)value);
+		memcpy(p, &i32, sizeof(int32_t));
+		break;
+	case UJO_TYPE_INT16:
+		report_error(value >= INT16_MIN && value <= INT16_MAX, "value out of range", UJO_ERR_INVALID_DATA);
+		i16 = (int16_t)UJO_UINT16_SWAP((int16_t)value);
+		memcpy(p, &i16, sizeof(int16_t));
+		break;
+	case UJO_TYPE_INT8:
+		report_error(value >= INT8_MIN && value <= INT8_MAX, "value out of range", UJO_ERR_INVALID_DATA);
+		i8 = (int8_t)value;
+		memcpy(p, &i8, sizeof(int8_t));
+		break;
+	default:
+		report_error(ujoFalse, "slot is not a signed integer", UJO_ERR_TYPE_MISPLACED);
+	}
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Set an unsigned integer slot.
+ *
+ * The slot has to be of an unsigned integer type and the value
+ * has to fit into the slot type.
+ *
+ * @param t     ujo template handle
+ * @param slot  slot index
+ * @param value unsigned integer value
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_add_slot
+ */
+ujoError ujo_template_set_uint(ujo_template* t, ujoSlot slot, uint64_t value)
+{
+	ujoError           err;
+	ujo_template_slot* s;
+	ujoByte*           p;
+	uint32_t           u32;
+	uint16_t           u16;
+
+	return_on_err(_ujo_template_get_slot(t, slot, &s));
+	p = t->image + s->offset;
+
+	switch (s->type)
+	{
+	case UJO_TYPE_UINT64:
+		value = UJO_UINT64_SWAP(value);
+		memcpy(p, &value, sizeof(uint64_t));
+		break;
+	case UJO_TYPE_UINT32:
+		report_error(value <= UINT32_MAX, "value out of range", UJO_ERR_INVALID_DATA);
+		u32 = UJO_UINT32_SWAP((uint32_t)value);
+		memcpy(p, &u32, sizeof(uint32_t));
+		break;
+	case UJO_TYPE_UINT16:
+		report_error(value <= UINT16_MAX, "value out of range", UJO_ERR_INVALID_DATA);
+		u16 = UJO_UINT16_SWAP((uint16_t)value);
+		memcpy(p, &u16, sizeof(uint16_t));
+		break;
+	case UJO_TYPE_UINT8:
+		report_error(value <= UINT8_MAX, "value out of range", UJO_ERR_INVALID_DATA);
+		*p = (uint8_t)value;
+		break;
+	default:
+		report_error(ujoFalse, "slot is not an unsigned integer", UJO_ERR_TYPE_MISPLACED);
+	}
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Set a float slot.
+ *
+ * The value is converted to the float type of the slot. A half precision
+ * slot does not accept values that are NaN or out of range.
+ *
+ * @param t     ujo template handle
+ * @param slot  slot index
+ * @param value float value
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_add_slot
+ */
+ujoError ujo_template_set_float(ujo_template* t, ujoSlot slot, float64_t value)
+{
+	ujoError           err;
+	ujo_template_slot* s;
+	ujoByte*           p;
+	float32_t          f32;
+	float16_t          f16;
+
+	return_on_err(_ujo_template_get_slot(t, slot, &s));
+	p = t->image + s->offset;
+
+	switch (s->type)
+	{
+	case UJO_TYPE_FLOAT64:
+		value = (float64_t)UJO_FLOAT64_SWAP(value);
+		memcpy(p, &value, sizeof(float64_t));
+		break;
+	case UJO_TYPE_FLOAT32:
+		f32 = (float32_t)value;
+		f32 = (float32_t)UJO_FLOAT32_SWAP(f32);
+		memcpy(p, &f32, sizeof(float32_t));
+		break;
+	case UJO_TYPE_FLOAT16:
+		f16 = float_to_half((float32_t)value);
+		report_error(isnan_float16(f16) == 0, "value is NaN", UJO_ERR_INVALID_DATA);
+		report_error(isinf_float16(f16) == 0, "value is out of range", UJO_ERR_INVALID_DATA);
+		f16 = (float16_t)UJO_UINT16_SWAP(f16);
+		memcpy(p, &f16, sizeof(float16_t));
+		break;
+	default:
+		report_error(ujoFalse, "slot is not a float", UJO_ERR_TYPE_MISPLACED);
+	}
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Set a bool slot.
+ *
+ * @param t     ujo template handle
+ * @param slot  slot index
+ * @param value bool value
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_add_slot
+ */
+ujoError ujo_template_set_bool(ujo_template* t, ujoSlot slot, ujoBool value)
+{
+	ujoError           err;
+	ujo_template_slot* s;
+
+	return_on_err(_ujo_template_get_slot(t, slot, &s));
+	report_error(s->type == UJO_TYPE_BOOL, "slot is not a bool", UJO_ERR_TYPE_MISPLACED);
+
+	t->image[s->offset] = value ? ujoTrue : ujoFalse;
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Set a unix time slot.
+ *
+ * @param t     ujo template handle
+ * @param slot  slot index
+ * @param value unix time
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_add_slot
+ */
+ujoError ujo_template_set_uxtime(ujo_template* t, ujoSlot slot, int64_t value)
+{
+	ujoError           err;
+	ujo_template_slot* s;
+
+	return_on_err(_ujo_template_get_slot(t, slot, &s));
+	report_error(s->type == UJO_TYPE_UX_TIME, "slot is not a unix time", UJO_ERR_TYPE_MISPLACED);
+
+	value = (int64_t)UJO_UINT64_SWAP(value);
+	memcpy(t->image + s->offset, &value, sizeof(int64_t));
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Set a date, time or timestamp slot.
+ *
+ * Only the fields used by the type of the slot are written.
+ *
+ * @param t     ujo template handle
+ * @param slot  slot index
+ * @param dt    structure with date and time
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_add_slot
+ */
+ujoError ujo_template_set_datetime(ujo_template* t, ujoSlot slot, const ujoDateTime dt)
+{
+	ujoError           err;
+	ujo_template_slot* s;
+	ujoByte*           p;
+	int16_t            i16;
+
+	return_on_err(_ujo_template_get_slot(t, slot, &s));
+	p = t->image + s->offset;
+
+	switch (s->type)
+	{
+	case UJO_TYPE_DATE:
+	case UJO_TYPE_TIMESTAMP:
+		i16 = (int16_t)UJO_UINT16_SWAP(dt.year);
+		memcpy(p, &i16, sizeof(int16_t));
+		p[2] = dt.month;
+		p[3] = dt.day;
+		if (s->type == UJO_TYPE_DATE)
+			break;
+		p[4] = dt.hour;
+		p[5] = dt.minute;
+		p[6] = dt.second;
+		i16 = (int16_t)UJO_UINT16_SWAP(dt.millisecond);
+		memcpy(p+7, &i16, sizeof(int16_t));
+		break;
+	case UJO_TYPE_TIME:
+		p[0] = dt.hour;
+		p[1] = dt.minute;
+		p[2] = dt.second;
+		break;
+	default:
+		report_error(ujoFalse, "slot is not a date or time", UJO_ERR_TYPE_MISPLACED);
+	}
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Bind a slot to a struct field.
+ *
+ * ujo_template_match() stores the value of a bound slot in the field at 
+ * the given offset of the output structure. The field type follows the slot
+ * type: intN_t and uintN_t for integers, float64_t for double, float32_t for
+ * single and half precision, ujoBool for bool, int64_t for unix time and 
+ * ujoDateTime for date, time and timestamp slots.
+ *
+ * \code{.c}
+ *   ujo_template_bind_field(tpl, temp, offsetof(telemetry, temp));
+ * \endcode
+ *
+ * @param t      ujo template handle
+ * @param slot   slot index
+ * @param offset offset of the field in the output structure
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_match
+ */
+ujoError ujo_template_bind_field(ujo_template* t, ujoSlot slot, size_t offset)
+{
+	report_error(t, "invalid template handle", UJO_ERR_INVALID_DATA);
+	report_error(slot < t->count, "invalid slot", UJO_ERR_INVALID_DATA);
+
+	if (!t->slots[slot].bound)
+		t->bound++;
+	t->slots[slot].bound = ujoTrue;
+	t->slots[slot].field = offset;
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Decode a document with the structure of a template.
+ *
+ * If the document has exactly the octets of the template outside of the
+ * slots, the values are taken from the fixed slot offsets. This check is
+ * done in a single pass over the document. Otherwise the document is 
+ * traversed element by element. It still matches, if all elements outside
+ * of the slots are equal to the template and each slot holds a value of
+ * the same type family that fits into the slot type, e.g. an UJO_TYPE_INT8
+ * for an UJO_TYPE_INT32 slot. The readers of this traversal are kept with
+ * the template and read both documents in place, so repeated matches do 
+ * not allocate once the readers exist.
+ *
+ * The values of bound slots are stored in the output structure. If the 
+ * document does not match, the content of the output structure is undefined.
+ *
+ * @param t      ujo template handle
+ * @param buffer a pointer to an UJO document in memory
+ * @param bytes  the number of octets in the buffer
+ * @param out    output structure, may be NULL if no slot is bound
+ *
+ * @return UJO_SUCCESS, UJO_ERR_TEMPLATE_MISMATCH or another UJO error code
+ * @sa ujo_template_bind_field
+ */
+ujoError ujo_template_match(ujo_template* t, const ujoByte* buffer, size_t bytes, ujoPointer out)
+{
+	ujo_template_slot* s;
+	uint32_t           i;
+
+	report_error(t, "invalid template handle", UJO_ERR_INVALID_DATA);
+	report_error(t->image, "template not finished", UJO_ERR_INVALID_OBJECT);
+	report_error(buffer, "invalid buffer", UJO_ERR_INVALID_DATA);
+	report_error(out || t->bound == 0, "invalid output structure", UJO_ERR_INVALID_DATA);
+
+	if (bytes != t->bytes || !_ujo_template_skeleton_equal(t->image, buffer, t->mask, bytes))
+		return _ujo_template_match_elements(t, buffer, bytes, (ujoByte*)out);
+
+	for (i = 0; i < t->count; i++)
+	{
+		s = &t->slots[i];
+		if (s->bound)
+			_ujo_template_load(s, buffer + s->offset, (ujoByte*)out + s->field);
+	}
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Access the encoded document of a template.
+ *
+ * The buffer holds a complete UJO document with the current slot values.
+ * It stays valid as long as the template exists. Setting a slot value
+ * changes the buffer in place, so the buffer has to be copied if a message
+ * is needed after the next value was set.
+ *
+ * @param t      ujo template handle
+ * @param buffer reference to a pointer indicating the start of the buffer.
+ * @param bytes  reference to the size of the buffer.
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_template_finish
+ */
+ujoError ujo_template_get_buffer(ujo_template* t, ujoByte** buffer, size_t* bytes)
+{
+	report_error(t, "invalid template handle", UJO_ERR_INVALID_DATA);
+	report_error(t->image, "template not finished", UJO_ERR_INVALID_OBJECT);
+
+	*buffer = t->image;
+	*bytes  = t->bytes;
+
+	return UJO_SUCCESS;
+}
+
+/* @} */
@@ -0,0 +1,73 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ */
+
+#ifndef __UJO_TEMPLATE_H__
+#define __UJO_TEMPLATE_H__
+
+#include "ujo_writer.h"
+
+typedef struct _ujo_template ujo_template;
+
+/**
+ * @brief Index of a value slot in a template.
+ * @ingroup ujo_template
+ */
+typedef uint32_t ujoSlot;
+
+BEGIN_C_DECLS
+
+/** 
+ * \addtogroup ujo_template
+ * @{
+ */
+
+	ujoError ujo_new_template(ujo_template** t);
+	ujoError ujo_free_template(ujo_template* t);
+
+	// build the template
+	ujoError ujo_template_get_writer(ujo_template* t, ujo_writer** w);
+	ujoError ujo_template_add_slot(ujo_template* t, ujoTypeId type, ujoSlot* slot);
+	ujoError ujo_template_finish(ujo_template* t);
+
+	// patch slot values
+	ujoError ujo_template_set_int(ujo_template* t, ujoSlot slot, int64_t value);
+	ujoError ujo_template_set_uint(ujo_template* t, ujoSlot slot, uint64_t value);
+	ujoError ujo_template_set_float(ujo_template* t, ujoSlot slot, float64_t value);
+	ujoError ujo_template_set_bool(ujo_template* t, ujoSlot slot, ujoBool value);
+	ujoError ujo_template_set_uxtime(ujo_template* t, ujoSlot slot, int64_t value);
+	ujoError ujo_template_set_datetime(ujo_template* t, ujoSlot slot, const ujoDateTime dt);
+
+	ujoError ujo_template_get_buffer(ujo_template* t, ujoByte** buffer, size_t* bytes);
+
+	// decode documents with the template structure
+	ujoError ujo_template_bind_field(ujo_template* t, ujoSlot slot, size_t offset);
+	ujoError ujo_template_match(ujo_template* t, const ujoByte* buffer, size_t bytes, ujoPointer out);
+
+/* @} */
+
+END_C_DECLS
+
+#endif
@@ -68,11 +68,47 @@ typedef enum {
 	UJO_STREAM  = 0x102, 
 } ujoAccessType; 
 
+/**
+ * @brief A contiguous piece of a buffer.
+ *
+ * The layout matches struct iovec on POSIX systems, so an array can be 
+ * passed to writev() or sendmsg() directly.
+ */
+typedef struct {
+	/** start of the piece */
+	ujoByte*  base;
+	/** number of octets */
+	size_t    len;
+} ujoIovec;
+
 /**
  * @brief UJO type id
  */
 typedef uint8_t ujoTypeId;
 
+/**
+ * @brief Statistics of a reader or writer.
+ *
+ * The counters are maintained if the library is built with
+ * UJO_ENABLE_STATS and accumulate over the lifetime of the object.
+ */
+typedef struct {
+	/** octets written or read, including the header */
+	uint64_t  bytes;
+	/** elements per type id, null values are counted with their null type id */
+	uint64_t  elements[256];
+	/** lists, maps and tables opened */
+	uint64_t  containers;
+	/** deepest nesting of containers */
+	uint32_t  maxdepth;
+	/** buffer enlargements */
+	uint64_t  reallocs;
+	/** octets allocated for buffers, elements and their data */
+	uint64_t  heapbytes;
+	/** calls to read or write a file */
+	uint64_t  iocalls;
+} ujoStats;
+
 /**
  * @brief UJO datetime
  */
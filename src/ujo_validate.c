@@ -0,0 +1,329 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ */
+
+#include "ujo_reader.h"
+#include "ujo_errors.h"
+#include "ujo_log.h"
+#include "ujo_macros.h"
+#include "ujo_constants.h"
+#include "ujo_endian.h"
+#include <string.h>
+
+/** 
+@cond INTERNAL_DOCS
+*/
+
+/* containers checked without allocation */
+#define UJO_VALIDATE_DEPTH 64
+
+/* open container */
+typedef struct {
+	ujoTypeId  type;
+	// map: the next element is a key
+	ujoBool    key;
+	// table: the column names are complete
+	ujoBool    values;
+	uint32_t   columns;
+	uint32_t   column;
+} ujo_validate_frame;
+
+typedef struct {
+	ujo_validate_frame*  frames;
+	size_t               depth;
+	size_t               size;
+	ujo_validate_frame   local[UJO_VALIDATE_DEPTH];
+} ujo_validate_ctx;
+
+#define validate_check(expr, msg) \
+	if (!(expr)) {report->offset = start; report->elements = elements; report->message = msg; return UJO_ERR_INVALID_DATA;}
+
+static ujoError _ujo_validate_push(ujo_validate_ctx* ctx, ujoTypeId type)
+{
+	ujo_validate_frame* temp;
+
+	if (ctx->depth == ctx->size)
+	{
+		if (ctx->frames == ctx->local)
+		{
+			temp = (ujo_validate_frame*)ujo_calloc(2 * ctx->size, sizeof(ujo_validate_frame));
+			report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+			memcpy(temp, ctx->local, sizeof(ctx->local));
+		}
+		else
+		{
+			temp = (ujo_validate_frame*)ujo_realloc(ctx->frames, 2 * ctx->size * sizeof(ujo_validate_frame));
+			report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+		}
+		ctx->frames = temp;
+		ctx->size  *= 2;
+	}
+
+	ctx->frames[ctx->depth].type    = type;
+	ctx->frames[ctx->depth].key     = ujoTrue;
+	ctx->frames[ctx->depth].values  = ujoFalse;
+	ctx->frames[ctx->depth].columns = 0;
+	ctx->frames[ctx->depth].column  = 0;
+	ctx->depth++;
+
+	return UJO_SUCCESS;
+}
+
+/* a value is complete, advance its container */
+static __inline ujoBool _ujo_validate_complete(ujo_validate_frame* frame)
+{
+	switch (frame->type)
+	{
+	case UJO_TYPE_MAP:
+		frame->key = (ujoBool)!frame->key;
+		return ujoTrue;
+	case UJO_TYPE_TABLE:
+		if (!frame->values)
+		{
+			frame->columns++;
+			return ujoTrue;
+		}
+		if (frame->columns == 0)
+			return ujoFalse;
+		if (++frame->column == frame->columns)
+			frame->column = 0;
+		return ujoTrue;
+	default:
+		return ujoTrue;
+	}
+}
+
+/* payload octets of the fixed size types, -1 for all others */
+static const int8_t _ujo_validate_payload[UJO_TYPE_TIMESTAMP + 1] = {
+	-1,		// terminator
+	8,		// float64
+	4,		// float32
+	2,		// float16
+	-1,		// string
+	8,		// int64
+	4,		// int32
+	2,		// int16
+	1,		// int8
+	8,		// uint64
+	4,		// uint32
+	2,		// uint16
+	1,		// uint8
+	1,		// bool
+	-1,		// binary
+	0,		// none
+	8,		// unix time
+	4,		// date
+	3,		// time
+	9		// timestamp
+};
+
+static ujoError _ujo_validate_document(ujo_validate_ctx* ctx, const ujoByte* buffer, size_t bytes, ujoValidateReport* report)
+{
+	ujoError            err;
+	ujo_validate_frame* frame = NULL;
+	ujoTypeId           type;
+	ujoTypeId           subtype;
+	uint16_t            version;
+	uint32_t            n;
+	uint64_t            size;
+	uint64_t            elements = 0;
+	size_t              pos = 0;
+	size_t              start = 0;
+
+	validate_check(bytes >= UJO_HEADER_SIZE, "no ujo header found");
+	validate_check(memcmp(buffer, UJO_MAGIC, 4) == 0, "no ujo header found");
+	memcpy(&version, buffer + 4, sizeof(uint16_t));
+	validate_check(UJO_UINT16_SWAP(version) == 1, "unsupported UJO version");
+	validate_check(buffer[6] == 0, "unsupported compression");
+	pos = UJO_HEADER_SIZE;
+
+	// the root container
+	start = pos;
+	validate_check(pos < bytes, "unexpected end of data");
+	type = buffer[pos++];
+	validate_check(type == UJO_TYPE_LIST || type == UJO_TYPE_MAP || type == UJO_TYPE_TABLE, "container expected");
+	return_on_err(_ujo_validate_push(ctx, type));
+	frame = ctx->frames;
+	elements = 1;
+	report->maxdepth = 1;
+
+	while (ctx->depth > 0)
+	{
+		start = pos;
+		validate_check(pos < bytes, "unexpected end of data");
+		type = buffer[pos++];
+		elements++;
+
+		// fixed size values
+		if (type <= UJO_TYPE_TIMESTAMP && _ujo_validate_payload[type] >= 0)
+		{
+			validate_check(frame->type != UJO_TYPE_TABLE || frame->values, "value not allowed");
+			validate_check(bytes - pos >= (size_t)_ujo_validate_payload[type], "unexpected end of data");
+			pos += (size_t)_ujo_validate_payload[type];
+			validate_check(_ujo_validate_complete(frame), "table value without columns");
+			continue;
+		}
+
+		switch (type)
+		{
+		case UJO_TYPE_LIST:
+		case UJO_TYPE_MAP:
+		case UJO_TYPE_TABLE:
+			validate_check(frame->type == UJO_TYPE_LIST || (frame->type == UJO_TYPE_MAP && !frame->key) ||
+				(frame->type == UJO_TYPE_TABLE && frame->values), "container not allowed");
+			return_on_err(_ujo_validate_push(ctx, type));
+			frame = &ctx->frames[ctx->depth-1];
+			if (ctx->depth > report->maxdepth)
+				report->maxdepth = (uint32_t)ctx->depth;
+			break;
+
+		case UJO_TERMINATOR:
+			if (frame->type == UJO_TYPE_TABLE && !frame->values)
+			{
+				frame->values = ujoTrue;
+				break;
+			}
+			validate_check(frame->type != UJO_TYPE_MAP || frame->key, "map value missing");
+			validate_check(frame->type != UJO_TYPE_TABLE || frame->column == 0, "incomplete table row");
+			if (--ctx->depth == 0)
+				break;
+			frame = &ctx->frames[ctx->depth-1];
+			validate_check(_ujo_validate_complete(frame), "table value without columns");
+			break;
+
+		case UJO_TYPE_STRING:
+		case UJO_TYPE_BIN:
+			// strings are also allowed as column names
+			validate_check(type == UJO_TYPE_STRING || frame->type != UJO_TYPE_TABLE || frame->values, "value not allowed");
+			validate_check(bytes - pos >= 1 + sizeof(uint32_t), "unexpected end of data");
+			subtype = buffer[pos];
+			memcpy(&n, buffer + pos + 1, sizeof(uint32_t));
+			pos += 1 + sizeof(uint32_t);
+
+			size = n;
+			if (type == UJO_TYPE_STRING)
+			{
+				switch (subtype)
+				{
+				case UJO_SUB_STRING_C:
+					validate_check(n > 0 && (uint64_t)(bytes - pos) >= n && buffer[pos + n - 1] == 0, 
+						"c string not terminated");
+					break;
+				case UJO_SUB_STRING_U8:
+					break;
+				case UJO_SUB_STRING_U16:
+					size *= sizeof(uint16_t);
+					break;
+				case UJO_SUB_STRING_U32:
+					size *= sizeof(uint32_t);
+					break;
+				default:
+					validate_check(0, "invalid string subtype");
+				}
+			}
+
+			validate_check((uint64_t)(bytes - pos) >= size, "length exceeds the buffer");
+			pos += (size_t)size;
+			validate_check(_ujo_validate_complete(frame), "table value without columns");
+			break;
+
+		default:
+			validate_check((type & UJO_TYPE_NULL_FLAG) && (type & ~UJO_TYPE_NULL_FLAG) >= UJO_TYPE_FLOAT64 &&
+				(type & ~UJO_TYPE_NULL_FLAG) <= UJO_TYPE_TIMESTAMP, "unknown type id");
+			validate_check(frame->type != UJO_TYPE_TABLE || frame->values, "value not allowed");
+			validate_check(_ujo_validate_complete(frame), "table value without columns");
+			break;
+		}
+	}
+
+	start = pos;
+	report->bytes = pos;
+	validate_check(pos == bytes, "data after the end of the document");
+	report->offset   = pos;
+	report->elements = elements;
+
+	return UJO_SUCCESS;
+}
+
+/**
+@endcond
+*/
+
+/** 
+ * \addtogroup ujo_reader
+ * @{
+ */
+
+/**
+ * @brief Check that a buffer holds a well-formed UJO document.
+ *
+ * The buffer is checked in a single pass without creating elements or 
+ * copying data: the header, the type ids, the containers and their nesting,
+ * pairs of keys and values in maps, complete rows in tables and that all 
+ * length fields stay inside the buffer. The buffer has to hold exactly one
+ * document. Containers nested deeper than 64 levels are the only case 
+ * that allocates memory.
+ *
+ * Untrusted input can be checked before it is passed to a reader.
+ *
+ * \code{.c}
+ *   ujoValidateReport report;
+ *
+ *   if (ujo_validate(data, size, &report) != UJO_SUCCESS)
+ *     printf("invalid document at offset %zu: %s\n", report.offset, report.message);
+ * \endcode
+ *
+ * @param buffer  document to check
+ * @param bytes   size of the buffer in octets
+ * @param report  reference to the result or NULL
+ *
+ * @return UJO_SUCCESS for a valid document, UJO_ERR_INVALID_DATA otherwise
+ * @sa ujo_reader_set_buffer
+ */
+ujoError ujo_validate(const ujoByte* buffer, size_t bytes, ujoValidateReport* report)
+{
+	ujoError          err;
+	ujoValidateReport local;
+	ujo_validate_ctx  ctx;
+
+	report_error(buffer, "invalid buffer", UJO_ERR_INVALID_DATA);
+
+	if (report == NULL)
+		report = &local;
+	memset(report, 0, sizeof(ujoValidateReport));
+
+	ctx.frames = ctx.local;
+	ctx.depth  = 0;
+	ctx.size   = UJO_VALIDATE_DEPTH;
+
+	err = _ujo_validate_document(&ctx, buffer, bytes, report);
+
+	if (ctx.frames != ctx.local)
+		ujo_free(ctx.frames);
+
+	return err;
+};
+
+/* @} */
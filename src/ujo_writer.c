@@ -26,6 +26,7 @@
 
 /* global includes */
 #include "ujo_writer.h"
+#include "ujo_reader.h"
 #include "ujo_log.h"
 #include "ujo_stack.h"
 #include "ujo_constants.h"
@@ -36,6 +37,7 @@
 #include <assert.h>
 #include <string.h>
 #include <stdio.h>
+#include <float.h>
 
 
 /** 
@@ -46,34 +48,276 @@ struct _ujo_writer {
 	ujoAccessType	type;
 	ujoStack*		state_stack;
 	ujo_state*		state;
+
+	// NULL for the default allocation functions
+	const ujoAllocator* allocator;
     
 	// memory writer
 	size_t			buffersize;
 	ujoByte*		buffer;
 	size_t			bytes;
 
+	// fixed memory writer, the buffer is owned by the caller
+	ujoBool			fixed;
+	size_t			committed;
+
+	// segmented memory writer, buffer is the current segment
+	ujoBool			segmented;
+	size_t			segmentsize;
+	ujoIovec*		segments;		// allocated segment memory
+	size_t			segmentcount;	// segments in use
+	size_t			segmentspare;	// segments allocated
+	size_t			segmentslots;	// size of the segment array
+	ujoIovec*		iovecs;			// pieces of the document
+	size_t			iovcount;
+	size_t			iovslots;
+	size_t			piecestart;		// start of the open piece in the current segment
+	uint64_t		piecebytes;		// size of the closed pieces
+	ujoIovec		single;
+
+	// octets missing in a binary written in chunks
+	uint32_t		binaryleft;
+
+	// the document state is not maintained, only open containers are counted
+	ujoBool			unchecked;
+	uint32_t		open;
+
 	// file writer
 	FILE*           file;
+	uint64_t        filebytes;
+
+	// statistics, the type of the value being written is counted on commit
+	ujoStats        stats;
+	uint16_t        pending;
+	uint32_t        depth;
 };
 
-static __inline ujoError _ujo_new_writer(ujo_writer** w)
+#define UJO_NO_TYPE  0x100
+
+static __inline ujoError _ujo_new_writer(ujo_writer** w, const ujoAllocator* allocator)
 {
 	ujo_writer*     newhdl;
 
-	newhdl = (ujo_writer*)ujo_new(ujo_writer, 1); 
+	newhdl = ujo_new_ex(allocator, ujo_writer, 1); 
 	report_error(newhdl, "allocation failed", UJO_ERR_ALLOCATION);
+	newhdl->allocator = allocator;
 	
-	newhdl->state = (ujo_state*)ujo_new(ujo_state, 1);
-	newhdl->state->state = STATE_ROOT;
-
+	newhdl->state = ujo_new_ex(allocator, ujo_state, 1);
 	/* initialize stack */
-	newhdl->state_stack = ujo_new_stack(ujo_free);
+	newhdl->state_stack = ujo_new_stack_ex(NULL, allocator);
+	if (newhdl->state == NULL || newhdl->state_stack == NULL)
+	{
+		if (newhdl->state_stack)
+			ujo_free_stack(newhdl->state_stack);
+		ujo_allocator_free(allocator, newhdl->state);
+		ujo_allocator_free(allocator, newhdl);
+		report_error(ujoFalse, "allocation failed", UJO_ERR_ALLOCATION);
+	}
+	newhdl->state->state = STATE_ROOT;
+	newhdl->pending = UJO_NO_TYPE;
 
 	*w = newhdl;
 
 	return UJO_SUCCESS;
 };
 
+static ujoError _ujo_writer_grow_iovecs(ujo_writer* w, ujoIovec** array, size_t* slots, size_t needed)
+{
+	ujoIovec*  temp;
+	size_t     newslots;
+
+	if (needed <= *slots)
+		return UJO_SUCCESS;
+
+	newslots = *slots ? *slots * 2 : 8;
+	while (newslots < needed)
+		newslots *= 2;
+	temp = (ujoIovec*)ujo_allocator_realloc(w->allocator, *array, 
+		*slots * sizeof(ujoIovec), newslots * sizeof(ujoIovec));
+	report_error(temp, "allocation failed", UJO_ERR_ALLOCATION);
+	*array = temp;
+	*slots = newslots;
+
+	return UJO_SUCCESS;
+}
+
+/* close the open piece, an empty piece is dropped */
+static __inline void _ujo_writer_close_piece(ujo_writer* w)
+{
+	w->iovecs[w->iovcount-1].len = w->bytes - w->piecestart;
+	w->piecebytes += w->iovecs[w->iovcount-1].len;
+	if (w->iovecs[w->iovcount-1].len == 0)
+		w->iovcount--;
+}
+
+/* open a piece at the current position, room has been reserved */
+static __inline void _ujo_writer_open_piece(ujo_writer* w)
+{
+	w->iovecs[w->iovcount].base = w->buffer + w->bytes;
+	w->iovecs[w->iovcount].len  = 0;
+	w->iovcount++;
+	w->piecestart = w->bytes;
+}
+
+/* move to the next segment, a spare segment is reused */
+static ujoError _ujo_writer_next_segment(ujo_writer* w)
+{
+	ujoError   err;
+
+	return_on_err(_ujo_writer_grow_iovecs(w, &w->iovecs, &w->iovslots, w->iovcount + 1));
+
+	if (w->segmentcount == w->segmentspare)
+	{
+		return_on_err(_ujo_writer_grow_iovecs(w, &w->segments, &w->segmentslots, w->segmentspare + 1));
+		w->segments[w->segmentspare].base = ujo_new_ex(w->allocator, ujoByte, w->segmentsize);
+		report_error(w->segments[w->segmentspare].base, "allocation failed", UJO_ERR_ALLOCATION);
+		w->segments[w->segmentspare].len = w->segmentsize;
+		w->segmentspare++;
+		ujo_stats_add(w->stats, reallocs, 1);
+		ujo_stats_add(w->stats, heapbytes, w->segmentsize);
+	}
+
+	if (w->iovcount > 0)
+		_ujo_writer_close_piece(w);
+
+	w->buffer     = w->segments[w->segmentcount].base;
+	w->buffersize = w->segments[w->segmentcount].len;
+	w->bytes      = 0;
+	w->segmentcount++;
+	_ujo_writer_open_piece(w);
+
+	return UJO_SUCCESS;
+}
+
+/* the end of the last complete value, a fixed writer rolls back to it */
+static __inline void _ujo_writer_commit(ujo_writer* w)
+{
+	w->committed = w->bytes;
+
+#ifdef UJO_ENABLE_STATS
+	if (w->pending == UJO_NO_TYPE)
+		return;
+
+	w->stats.elements[w->pending]++;
+	switch (w->pending)
+	{
+	case UJO_TYPE_LIST:
+	case UJO_TYPE_MAP:
+	case UJO_TYPE_TABLE:
+		w->stats.containers++;
+		if (++w->depth > w->stats.maxdepth)
+			w->stats.maxdepth = w->depth;
+		break;
+	case UJO_TERMINATOR:
+		w->depth--;
+		break;
+	default:
+		break;
+	}
+	w->pending = UJO_NO_TYPE;
+#endif
+}
+
+/* change the document state, unchecked writers skip the state machine */
+static __inline void _ujo_writer_switch(ujo_writer* w, ujoDocEvent e)
+{
+	if (!w->unchecked)
+		w->state = ujo_state_switch(e, w->state, w->state_stack);
+}
+
+static __inline void _ujo_writer_open(ujo_writer* w, ujoDocState s)
+{
+	if (w->unchecked)
+		w->open++;
+	else
+		w->state = ujo_state_next(s, w->state, w->state_stack);
+}
+
+static __inline void _ujo_writer_close(ujo_writer* w)
+{
+	if (w->unchecked)
+	{
+		w->open--;
+		return;
+	}
+	w->state = ujo_state_prev(w->state, w->state_stack);
+	w->state = ujo_state_switch(CONTAINER_CLOSED, w->state, w->state_stack);
+}
+
+/* write the type id of a value */
+static __inline ujoError _ujo_writer_put_type(ujo_writer* w, ujoTypeId type)
+{
+#ifdef UJO_ENABLE_STATS
+	w->pending = type;
+#endif
+	return _ujo_writer_put_uint8(w, type);
+}
+
+/* largest encoded atomic value, a timestamp uses 10 octets */
+#define UJO_VALUE_MAXSIZE   16
+/* type, subtype and number of units of a string or binary */
+#define UJO_SEQUENCE_HEADER 6
+
+/* room for a value: the buffer if the value fits, the scratch memory otherwise */
+static __inline ujoByte* _ujo_writer_reserve(ujo_writer* w, ujoTypeId type, size_t bytes, ujoByte* scratch)
+{
+#ifdef UJO_ENABLE_STATS
+	w->pending = type;
+#endif
+	if (w->type == UJO_MEMORY && w->bytes + bytes <= w->buffersize)
+		return w->buffer + w->bytes;
+	return scratch;
+}
+
+/* complete a reserved value, scratch memory is written with a single put */
+static __inline ujoError _ujo_writer_store(ujo_writer* w, const ujoByte* p, const ujoByte* scratch, size_t bytes)
+{
+	if (p == scratch)
+		return _ujo_writer_put(w, scratch, bytes);
+	w->bytes += bytes;
+	ujo_stats_add(w->stats, bytes, bytes);
+	return UJO_SUCCESS;
+}
+
+/* write type id and payload of an atomic value, the payload is already swapped */
+static __inline ujoError _ujo_writer_put_atomic(ujo_writer* w, ujoTypeId type, const void* value, size_t size)
+{
+	ujoByte  scratch[UJO_VALUE_MAXSIZE];
+	ujoByte* p = _ujo_writer_reserve(w, type, size + 1, scratch);
+
+	p[0] = (ujoByte)type;
+	memcpy(p + 1, value, size);
+	return _ujo_writer_store(w, p, scratch, size + 1);
+}
+
+/* write header and data of a string or binary, optionally followed by \x00 */
+static __inline ujoError _ujo_writer_put_sequence(ujo_writer* w, ujoTypeId type, uint8_t subtype, 
+	uint32_t units, const void* data, size_t bytes, ujoBool terminate)
+{
+	ujoError err;
+	ujoByte  scratch[UJO_SEQUENCE_HEADER];
+	size_t   total = UJO_SEQUENCE_HEADER + bytes + (terminate ? 1 : 0);
+	ujoByte* p = _ujo_writer_reserve(w, type, total, scratch);
+
+	p[0] = (ujoByte)type;
+	p[1] = subtype;
+	memcpy(p + 2, &units, sizeof(uint32_t));
+	if (p != scratch)
+	{
+		memcpy(p + UJO_SEQUENCE_HEADER, data, bytes);
+		if (terminate)
+			p[total - 1] = 0;
+		return _ujo_writer_store(w, p, scratch, total);
+	}
+
+	/* the value does not fit, the put grows the buffer */
+	return_on_err(_ujo_writer_put(w, scratch, UJO_SEQUENCE_HEADER));
+	return_on_err(_ujo_writer_put(w, data, bytes));
+	if (terminate)
+		return _ujo_writer_put_uint8(w, 0);
+	return UJO_SUCCESS;
+}
+
 /** 
 @endcond
 */
@@ -93,24 +337,144 @@ static __inline ujoError _ujo_new_writer(ujo_writer** w)
  * @param w    reference to a writer
  *
  * @return UJO error code or UJO_SUCCESS
- * @sa ujo_free_writer
+ * @sa ujo_free_writer, ujo_new_memory_writer_ex
  */
 ujoError ujo_new_memory_writer(ujo_writer** w) 
+{
+	return ujo_new_memory_writer_ex(w, NULL);
+}
+
+/**
+ * @brief Create a new memory writer with a custom allocator.
+ *
+ * All memory of the writer, including the buffer, is allocated
+ * by the given allocator. 
+ * 
+ * @param w         reference to a writer
+ * @param allocator custom allocator or NULL for the default allocation
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_free_writer, ujo_new_memory_writer
+ */
+ujoError ujo_new_memory_writer_ex(ujo_writer** w, const ujoAllocator* allocator) 
 {
 	ujo_writer*     newhdl;
 	ujoError        err;
 
-	return_on_err(_ujo_new_writer(&newhdl));
+	return_on_err(_ujo_new_writer(&newhdl, allocator));
 
 	newhdl->type = UJO_MEMORY; 
 
 	newhdl->bytes = 0;
-	newhdl->buffer = ujo_new(ujoByte, UJO_DEFAULT_BUFSIZE);
+	newhdl->buffer = ujo_new_ex(allocator, ujoByte, UJO_DEFAULT_BUFSIZE);
+	if (newhdl->buffer == NULL)
+	{
+		ujo_free_writer(newhdl);
+		report_error(ujoFalse, "allocation failed", UJO_ERR_ALLOCATION);
+	}
+	ujo_stats_add(newhdl->stats, heapbytes, UJO_DEFAULT_BUFSIZE);
 	newhdl->buffersize = UJO_DEFAULT_BUFSIZE;
 
 	return_on_err(_ujo_writer_put(newhdl, UJO_MAGIC, strnlen(UJO_MAGIC, sizeof(UJO_MAGIC))));
 	return_on_err(_ujo_writer_put_uint16(newhdl, UJO_DATA_VERSION));
 	return_on_err(_ujo_writer_put_uint8(newhdl, UJO_COMPRESS_NONE));
+	_ujo_writer_commit(newhdl);
+
+	*w = newhdl;
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Create a new memory writer on a caller owned buffer.
+ *
+ * The writer encodes straight into the given memory, e.g. a network
+ * buffer, a shared memory slot or a stack array. The buffer is never 
+ * reallocated or released by the writer. If a value does not fit into the
+ * remaining space the write function returns UJO_ERR_BUFFER_FULL and the
+ * incomplete value is dropped. The document stays valid up to the last
+ * complete value, so the caller can close it, or flush the buffer and
+ * continue with ujo_writer_reset().
+ *
+ * Once the writer is created, writing a document does not allocate memory
+ * unless containers are nested deeper than in any previous document.
+ * 
+ * @param w         reference to a writer
+ * @param buffer    caller owned output buffer
+ * @param capacity  size of the buffer in octets
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_free_writer, ujo_writer_reset, ujo_new_memory_writer
+ */
+ujoError ujo_new_fixed_writer(ujo_writer** w, ujoByte* buffer, size_t capacity) 
+{
+	ujo_writer*     newhdl;
+	ujoError        err;
+
+	report_error(buffer, "invalid buffer", UJO_ERR_INVALID_DATA);
+	report_error(capacity >= UJO_HEADER_SIZE, "buffer too small for header", UJO_ERR_BUFFER_FULL);
+
+	return_on_err(_ujo_new_writer(&newhdl, NULL));
+
+	newhdl->type = UJO_MEMORY; 
+	newhdl->fixed = ujoTrue;
+
+	newhdl->bytes = 0;
+	newhdl->buffer = buffer;
+	newhdl->buffersize = capacity;
+
+	return_on_err(_ujo_writer_put(newhdl, UJO_MAGIC, strnlen(UJO_MAGIC, sizeof(UJO_MAGIC))));
+	return_on_err(_ujo_writer_put_uint16(newhdl, UJO_DATA_VERSION));
+	return_on_err(_ujo_writer_put_uint8(newhdl, UJO_COMPRESS_NONE));
+	_ujo_writer_commit(newhdl);
+
+	*w = newhdl;
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Create a new segmented memory writer.
+ *
+ * The writer appends fixed size segments to a chain instead of growing
+ * one contiguous buffer. Written data is never moved, so even very large
+ * documents grow without copying and without twice the memory at peak.
+ * The document is accessed with ujo_writer_get_iovecs(), e.g. to send it 
+ * with writev(), or joined with ujo_writer_flatten().
+ * 
+ * @param w            reference to a writer
+ * @param segmentsize  size of a segment in octets, 0 for the default size
+ * @param allocator    custom allocator or NULL for the default allocation
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_free_writer, ujo_writer_get_iovecs, ujo_writer_flatten
+ */
+ujoError ujo_new_segmented_writer(ujo_writer** w, size_t segmentsize, const ujoAllocator* allocator) 
+{
+	ujo_writer*     newhdl;
+	ujoError        err;
+
+	if (segmentsize == 0)
+		segmentsize = UJO_DEFAULT_BUFSIZE;
+	report_error(segmentsize >= UJO_HEADER_SIZE, "segment too small for header", UJO_ERR_INVALID_DATA);
+
+	return_on_err(_ujo_new_writer(&newhdl, allocator));
+
+	newhdl->type = UJO_MEMORY; 
+	newhdl->segmented = ujoTrue;
+	newhdl->segmentsize = segmentsize;
+
+	err = _ujo_writer_next_segment(newhdl);
+	if (err != UJO_SUCCESS)
+	{
+		ujo_free_writer(newhdl);
+		return err;
+	}
+
+	return_on_err(_ujo_writer_put(newhdl, UJO_MAGIC, strnlen(UJO_MAGIC, sizeof(UJO_MAGIC))));
+	return_on_err(_ujo_writer_put_uint16(newhdl, UJO_DATA_VERSION));
+	return_on_err(_ujo_writer_put_uint8(newhdl, UJO_COMPRESS_NONE));
+	_ujo_writer_commit(newhdl);
 
 	*w = newhdl;
 
@@ -127,9 +491,26 @@ ujoError ujo_new_memory_writer(ujo_writer** w)
  * @param filename  path of the file
  *
  * @return UJO error code or UJO_SUCCESS
- * @sa ujo_free_writer
+ * @sa ujo_free_writer, ujo_new_file_writer_ex
  */
 ujoError ujo_new_file_writer(ujo_writer** w, const char* filename)
+{
+	return ujo_new_file_writer_ex(w, filename, NULL);
+}
+
+/**
+ * @brief Create a new file writer with a custom allocator.
+ *
+ * All memory of the writer is allocated by the given allocator.
+ * 
+ * @param w         reference to a writer
+ * @param filename  path of the file
+ * @param allocator custom allocator or NULL for the default allocation
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_free_writer, ujo_new_file_writer
+ */
+ujoError ujo_new_file_writer_ex(ujo_writer** w, const char* filename, const ujoAllocator* allocator)
 {
 	ujo_writer*     newhdl;
 	ujoError        err;
@@ -138,7 +519,12 @@ ujoError ujo_new_file_writer(ujo_writer** w, const char* filename)
 	filehandle = fopen(filename, "wb"); 
     report_error(filehandle != NULL, "cannot open file", UJO_ERR_FILE);	
 
-	return_on_err(_ujo_new_writer(&newhdl));
+	err = _ujo_new_writer(&newhdl, allocator);
+	if (err != UJO_SUCCESS)
+	{
+		fclose(filehandle);
+		return err;
+	}
 
 	newhdl->type = UJO_FILE; 
 	newhdl-> file = filehandle;
@@ -167,12 +553,21 @@ ujoError ujo_free_writer(ujo_writer* w)
 {
 	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);	
 	
+	ujo_state_clear(w->state_stack);
 	ujo_free_stack(w->state_stack);
-	ujo_free(w->state);
+	ujo_allocator_free(w->allocator, w->state);
 	
 	switch(w->type) {
 	case UJO_MEMORY:
-		ujo_free(w->buffer);
+		if (w->segmented)
+		{
+			while (w->segmentspare > 0)
+				ujo_allocator_free(w->allocator, w->segments[--w->segmentspare].base);
+			ujo_allocator_free(w->allocator, w->segments);
+			ujo_allocator_free(w->allocator, w->iovecs);
+		}
+		else if (!w->fixed)
+			ujo_allocator_free(w->allocator, w->buffer);
 		break;
 	case UJO_FILE:
 		fclose(w->file);
@@ -181,7 +576,54 @@ ujoError ujo_free_writer(ujo_writer* w)
 		break;
 	}
 
-	ujo_free(w);
+	ujo_allocator_free(w->allocator, w);
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Reset a memory writer.
+ *
+ * The writer is prepared to write a new document. The document state is 
+ * cleared and the buffer is rewound to the end of the document header.
+ * The buffer capacity and all internal structures are kept, so a writer 
+ * can be reused for a stream of documents without any allocation. 
+ * A document can be reset before it is complete.
+ *
+ * \code{.c}
+ *   ujo_new_memory_writer(&w);
+ *   while (more_messages()) {
+ *     ujo_writer_reset(w);
+ *     // ... write and send the document
+ *   }
+ * \endcode
+ *
+ * @param w    ujo writer handle
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_new_memory_writer
+ */
+ujoError ujo_writer_reset(ujo_writer* w)
+{
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);	
+	report_error(w->type == UJO_MEMORY, "reset requires a memory writer", UJO_ERR_INVALID_OBJECT);
+
+	w->state = ujo_state_rewind(w->state, w->state_stack);
+	if (w->segmented)
+	{
+		/* the header is in the first segment */
+		w->segmentcount = 1;
+		w->iovcount     = 1;
+		w->piecestart   = 0;
+		w->piecebytes   = 0;
+		w->buffer     = w->segments[0].base;
+		w->buffersize = w->segments[0].len;
+	}
+	w->bytes = UJO_HEADER_SIZE;
+	w->pending = UJO_NO_TYPE;
+	w->depth = 0;
+	w->open = 0;
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 }
@@ -204,6 +646,105 @@ ujoError ujo_writer_get_type(ujo_writer* w, ujoAccessType* type)
 	return UJO_SUCCESS;
 }
 
+/**
+ * @brief Get the statistics of a writer.
+ *
+ * The counters cover all documents written since the writer was created,
+ * a reset does not clear them. Values dropped by a full fixed writer are 
+ * not counted. 
+ *
+ * @param w     ujo writer handle
+ * @param stats reference to the statistics
+ *
+ * @return UJO error code or UJO_SUCCESS, UJO_ERR_NOT_IMPLEMENTED if the
+ * library is built without UJO_ENABLE_STATS
+ * @sa ujo_reader_get_stats
+ */
+ujoError ujo_writer_get_stats(ujo_writer* w, ujoStats* stats)
+{
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);	
+	report_error(stats, "invalid statistics", UJO_ERR_INVALID_DATA);	
+
+#ifdef UJO_ENABLE_STATS
+	*stats = w->stats;
+	return UJO_SUCCESS;
+#else
+	return UJO_ERR_NOT_IMPLEMENTED;
+#endif
+}
+
+/**
+ * @brief Switch the structural checks of a writer on or off.
+ *
+ * An unchecked writer does not track the document state: values are
+ * encoded without asking whether they are allowed at the current position
+ * and containers are only counted. This removes the state machine from
+ * the hot path of producers that are known to emit valid documents.
+ * Misplaced values are not reported by the write calls anymore, 
+ * ujo_writer_finish catches them once the document is complete.
+ *
+ * The mode can only be changed before the first element is written,
+ * a reset keeps it.
+ *
+ * @param w         ujo writer handle
+ * @param unchecked ujoTrue to skip the structural checks
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_finish
+ */
+ujoError ujo_writer_set_unchecked(ujo_writer* w, ujoBool unchecked)
+{
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);	
+	report_error(_ujo_writer_get_position(w) == UJO_HEADER_SIZE, "document already started", UJO_ERR_INVALID_OBJECT);
+
+	w->unchecked = unchecked ? ujoTrue : ujoFalse;
+	w->open = 0;
+	return UJO_SUCCESS;
+}
+
+/**
+ * @brief Check that the written document is complete.
+ *
+ * A checked writer only has to be in the closed state. For an unchecked 
+ * writer all containers have to be closed and the encoded document of a
+ * memory writer is run through ujo_validate, so misplaced values surface 
+ * here instead of at the write call. Segmented and file writers in 
+ * unchecked mode are only checked for balanced containers.
+ *
+ * @param w ujo writer handle
+ *
+ * @return UJO error code or UJO_SUCCESS, UJO_ERR_INVALID_OBJECT if the
+ * document is incomplete or invalid
+ * @sa ujo_writer_set_unchecked, ujo_validate
+ */
+ujoError ujo_writer_finish(ujo_writer* w)
+{
+	ujoValidateReport report;
+
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);	
+
+	if (!w->unchecked)
+	{
+		report_error(w->state->state == STATE_CLOSED, "document not closed", UJO_ERR_INVALID_OBJECT);
+		return UJO_SUCCESS;
+	}
+
+	report_error(w->open == 0, "document not closed", UJO_ERR_INVALID_OBJECT);
+	report_error(_ujo_writer_get_position(w) > UJO_HEADER_SIZE, "document is empty", UJO_ERR_INVALID_OBJECT);
+
+	if (w->type == UJO_MEMORY && !w->segmented)
+	{
+		if (ujo_validate(w->buffer, w->bytes, &report) != UJO_SUCCESS)
+		{
+			UJO_LOG("invalid document at offset %lu: %s", (unsigned long)report.offset, report.message);
+			return UJO_ERR_INVALID_OBJECT;
+		}
+	}
+
+	w->state->state = STATE_CLOSED;
+	return UJO_SUCCESS;
+}
+
 
 /**
  * @brief Access the writer memory buffer.
@@ -217,10 +758,12 @@ ujoError ujo_writer_get_type(ujo_writer* w, ujoAccessType* type)
  * @param bytes reference to the size of the buffer.
  *
  * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_get_iovecs
  */
 ujoError ujo_writer_get_buffer(ujo_writer* w, ujoByte** buffer, size_t *bytes)
 {
 	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);		
+	report_error(!w->segmented || w->iovcount == 1, "segmented buffer has to be flattened", UJO_ERR_INVALID_OBJECT);
 	
 	*buffer = w->buffer;
 	*bytes  = w->bytes;
@@ -229,6 +772,200 @@ ujoError ujo_writer_get_buffer(ujo_writer* w, ujoByte** buffer, size_t *bytes)
 };
 
 
+/**
+ * @brief Access the writer memory as a list of pieces.
+ *
+ * The pieces are valid until the next write or reset. A contiguous 
+ * memory writer returns a single piece.
+ *
+ * \code{.c}
+ *   ujo_writer_get_iovecs(w, &iov, &count);
+ *   writev(fd, (const struct iovec*)iov, (int)count);
+ * \endcode
+ *
+ * @param w      ujo writer handle
+ * @param iovecs reference to the array of pieces
+ * @param count  reference to the number of pieces
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_new_segmented_writer, ujo_writer_flatten
+ */
+ujoError ujo_writer_get_iovecs(ujo_writer* w, const ujoIovec** iovecs, size_t* count)
+{
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);		
+	report_error(w->type == UJO_MEMORY, "iovecs require a memory writer", UJO_ERR_INVALID_OBJECT);
+
+	if (w->segmented)
+	{
+		/* the open piece is empty after a reference */
+		w->iovecs[w->iovcount-1].len = w->bytes - w->piecestart;
+		*iovecs = w->iovecs;
+		*count  = w->iovcount;
+		if (w->iovcount > 1 && w->iovecs[w->iovcount-1].len == 0)
+			(*count)--;
+	}
+	else
+	{
+		w->single.base = w->buffer;
+		w->single.len  = w->bytes;
+		*iovecs = &w->single;
+		*count  = 1;
+	}
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Join the segments of a writer into one buffer.
+ *
+ * The data is copied once into a new segment which holds the whole 
+ * document, including payloads added by reference. The buffer is owned
+ * by the writer. Writing more data 
+ * continues with a new segment. A contiguous memory writer returns 
+ * its buffer without a copy.
+ *
+ * @param w      ujo writer handle
+ * @param buffer reference to a pointer indicating the start of the buffer.
+ * @param bytes  reference to the size of the buffer.
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_get_iovecs, ujo_writer_get_buffer
+ */
+ujoError ujo_writer_flatten(ujo_writer* w, ujoByte** buffer, size_t* bytes)
+{
+	ujoByte*  flat;
+	size_t    total = 0;
+	size_t    index;
+
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);		
+	report_error(w->type == UJO_MEMORY, "flatten requires a memory writer", UJO_ERR_INVALID_OBJECT);
+
+	if (w->segmented && w->iovcount > 1)
+	{
+		w->iovecs[w->iovcount-1].len = w->bytes - w->piecestart;
+		for (index = 0; index < w->iovcount; index++)
+			total += w->iovecs[index].len;
+
+		flat = ujo_new_ex(w->allocator, ujoByte, total);
+		report_error(flat, "allocation failed", UJO_ERR_ALLOCATION);
+		ujo_stats_add(w->stats, heapbytes, total);
+		for (total = 0, index = 0; index < w->iovcount; index++)
+		{
+			memcpy(flat + total, w->iovecs[index].base, w->iovecs[index].len);
+			total += w->iovecs[index].len;
+		}
+
+		while (w->segmentspare > 0)
+			ujo_allocator_free(w->allocator, w->segments[--w->segmentspare].base);
+		w->segments[0].base = flat;
+		w->segments[0].len  = total;
+		w->iovecs[0].base   = flat;
+		w->iovecs[0].len    = total;
+		w->segmentspare = 1;
+		w->segmentcount = 1;
+		w->iovcount     = 1;
+		w->piecestart   = 0;
+		w->piecebytes   = 0;
+
+		w->buffer     = flat;
+		w->buffersize = total;
+		w->bytes      = total;
+		_ujo_writer_commit(w);
+	}
+
+	*buffer = w->buffer;
+	*bytes  = w->bytes;
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Take over the writer memory buffer.
+ *
+ * The ownership of the buffer is transferred to the caller, no data
+ * is copied. The caller releases the buffer with the returned destroy
+ * function. If the writer uses a custom allocator the destroy function
+ * is NULL and the buffer has to be released by the free function of 
+ * the allocator.
+ *
+ * The writer gets a new buffer and is ready for the next document, like
+ * after ujo_writer_reset().
+ *
+ * \code{.c}
+ *   ujo_writer_shrink_to_fit(w);
+ *   ujo_writer_detach_buffer(w, &buffer, &bytes, &destroy);
+ *   queue_message(buffer, bytes, destroy);
+ * \endcode
+ *
+ * @param w       ujo writer handle
+ * @param buffer  reference to a pointer indicating the start of the buffer.
+ * @param bytes   reference to the size of the buffer.
+ * @param destroy reference to the function to release the buffer.
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_get_buffer, ujo_writer_shrink_to_fit
+ */
+ujoError ujo_writer_detach_buffer(ujo_writer* w, ujoByte** buffer, size_t *bytes, ujoDestroyFunc* destroy)
+{
+	ujoError err;
+
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);		
+	report_error(w->type == UJO_MEMORY, "detach requires a memory writer", UJO_ERR_INVALID_OBJECT);
+	report_error(!w->fixed, "fixed writer buffer cannot be detached", UJO_ERR_INVALID_OBJECT);
+	report_error(!w->segmented, "segmented writer buffer cannot be detached", UJO_ERR_INVALID_OBJECT);
+
+	*buffer  = w->buffer;
+	*bytes   = w->bytes;
+	*destroy = w->allocator ? NULL : ujo_free;
+
+	w->buffer     = NULL;
+	w->buffersize = 0;
+	w->bytes      = 0;
+	w->state = ujo_state_rewind(w->state, w->state_stack);
+	w->pending = UJO_NO_TYPE;
+	w->depth = 0;
+	w->open  = 0;
+
+	return_on_err(_ujo_writer_put(w, UJO_MAGIC, strnlen(UJO_MAGIC, sizeof(UJO_MAGIC))));
+	return_on_err(_ujo_writer_put_uint16(w, UJO_DATA_VERSION));
+	return_on_err(_ujo_writer_put_uint8(w, UJO_COMPRESS_NONE));
+	_ujo_writer_commit(w);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Release unused buffer capacity.
+ *
+ * The memory buffer is resized to the number of octets written.
+ * Writing more data after this call grows the buffer again.
+ *
+ * @param w    ujo writer handle
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_detach_buffer
+ */
+ujoError ujo_writer_shrink_to_fit(ujo_writer* w)
+{
+	ujoByte* temp;
+
+	report_error(w, "invalid writer handle", UJO_ERR_INVALID_DATA);		
+	report_error(w->type == UJO_MEMORY, "shrink requires a memory writer", UJO_ERR_INVALID_OBJECT);
+	report_error(!w->fixed, "fixed writer buffer cannot be resized", UJO_ERR_INVALID_OBJECT);
+	report_error(!w->segmented, "segmented writer buffer cannot be resized", UJO_ERR_INVALID_OBJECT);
+
+	if (w->bytes == w->buffersize || w->bytes == 0)
+		return UJO_SUCCESS;
+
+	temp = (ujoByte*)ujo_allocator_realloc(w->allocator, w->buffer, w->buffersize, w->bytes);
+	report_error(temp, "resize buffer failed", UJO_ERR_ALLOCATION);
+	w->buffer = temp;
+	w->buffersize = w->bytes;
+
+	return UJO_SUCCESS;
+};
+
+
 /**
  * @brief Open a list.
  *
@@ -246,10 +983,11 @@ ujoError ujo_writer_list_open(ujo_writer* w)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_container(w->state->state),"list not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_container(w->state->state),"list not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	w->state = ujo_state_next(STATE_LIST, w->state, w->state_stack);
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_LIST));
+	return_on_err(_ujo_writer_put_type(w, UJO_TYPE_LIST));
+	_ujo_writer_open(w, STATE_LIST);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -269,12 +1007,11 @@ ujoError ujo_writer_list_close(ujo_writer* w)
 {
 	ujoError err;
 
-	report_error(w->state->state==STATE_LIST,"close list not allowed", UJO_ERR_INVALID_OBJECT);
+	report_error(w->unchecked ? w->open > 0 : w->state->state==STATE_LIST,"close list not allowed", UJO_ERR_INVALID_OBJECT);
 	
-	w->state = ujo_state_prev(w->state, w->state_stack);
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TERMINATOR));
-
-	w->state = ujo_state_switch(CONTAINER_CLOSED, w->state, w->state_stack);
+	return_on_err(_ujo_writer_put_type(w, UJO_TERMINATOR));
+	_ujo_writer_close(w);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -306,10 +1043,11 @@ ujoError ujo_writer_map_open(ujo_writer* w)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_container(w->state->state),"map not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_container(w->state->state),"map not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	w->state = ujo_state_next(STATE_DICT_KEY, w->state, w->state_stack);
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_MAP));
+	return_on_err(_ujo_writer_put_type(w, UJO_TYPE_MAP));
+	_ujo_writer_open(w, STATE_DICT_KEY);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -329,12 +1067,11 @@ ujoError ujo_writer_map_close(ujo_writer* w)
 {
 	ujoError err;
 
-	report_error(w->state->state==STATE_DICT_KEY,"close map not allowed", UJO_ERR_INVALID_OBJECT);
+	report_error(w->unchecked ? w->open > 0 : w->state->state==STATE_DICT_KEY,"close map not allowed", UJO_ERR_INVALID_OBJECT);
 	
-	w->state = ujo_state_prev(w->state, w->state_stack);
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TERMINATOR));
-
-    w->state = ujo_state_switch(CONTAINER_CLOSED, w->state, w->state_stack);
+	return_on_err(_ujo_writer_put_type(w, UJO_TERMINATOR));
+	_ujo_writer_close(w);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -355,13 +1092,13 @@ ujoError ujo_writer_add_int64(ujo_writer* w, int64_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_INT64));
 	value = (int64_t) UJO_UINT64_SWAP(value);
-	return_on_err(_ujo_writer_put(w, &value, sizeof(int64_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_INT64, &value, sizeof(int64_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -382,13 +1119,13 @@ ujoError ujo_writer_add_int32(ujo_writer* w, int32_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_INT32));
 	value = (int32_t) UJO_UINT32_SWAP(value);
-	return_on_err(_ujo_writer_put(w, &value, sizeof(int32_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_INT32, &value, sizeof(int32_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -409,13 +1146,13 @@ ujoError ujo_writer_add_int16(ujo_writer* w, int16_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_INT16));
 	value = (int16_t) UJO_UINT16_SWAP(value);
-	return_on_err(_ujo_writer_put(w, &value, sizeof(int16_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_INT16, &value, sizeof(int16_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -436,12 +1173,12 @@ ujoError ujo_writer_add_int8(ujo_writer* w, int8_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_INT8));
-	return_on_err(_ujo_writer_put(w, &value, sizeof(int8_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_INT8, &value, sizeof(int8_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -461,10 +1198,11 @@ ujoError ujo_writer_add_none(ujo_writer* w)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_NONE));
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	return_on_err(_ujo_writer_put_type(w, UJO_TYPE_NONE));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -488,11 +1226,75 @@ ujoError ujo_writer_add_null(ujo_writer* w, ujoTypeId type)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(type >= UJO_TYPE_FLOAT64 && type <= UJO_TYPE_TIMESTAMP, "invalid null type", UJO_ERR_INVALID_DATA);
 
-	return_on_err(_ujo_writer_put_uint8(w, type & 0x80));
+	return_on_err(_ujo_writer_put_type(w, type | UJO_TYPE_NULL_FLAG));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Write a sequence of Null values.
+ *
+ * Writes n Null values of the same type. A Null value is encoded as
+ * a single octet without data, so a run of Null values is written
+ * as one block. This is useful for sparse table rows, where most of
+ * the cells of a row are empty.
+ *
+ * \code{.c}
+ *   ujo_writer_add_int32(ujow, 42);                     // column 1
+ *   ujo_writer_add_nulls(ujow, UJO_TYPE_FLOAT64, 30);   // column 2..31
+ *   ujo_writer_add_string_c(ujow, "ok", 2);             // column 32
+ * \endcode
+ *
+ * @param w    ujo writer handle
+ * @param type type of the null values
+ * @param n    number of null values
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_add_null
+ */
+ujoError ujo_writer_add_nulls(ujo_writer* w, ujoTypeId type, uint32_t n)
+{
+	ujoError err;
+	ujoByte  block[64];
+	uint32_t count;
+
+	report_error(type >= UJO_TYPE_FLOAT64 && type <= UJO_TYPE_TIMESTAMP, "invalid null type", UJO_ERR_INVALID_DATA);
+
+	memset(block, type | UJO_TYPE_NULL_FLAG, sizeof(block));
+
+	while (n > 0)
+	{
+		report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+
+		/* a null value never changes the container, only the position in it */
+		count = (n < sizeof(block)) ? n : (uint32_t)sizeof(block);
+		if (!w->unchecked && w->state->state != STATE_LIST && w->state->state != STATE_TABLE_VALUES)
+			count = 1;
+
+		return_on_err(_ujo_writer_put(w, block, count));
+		n -= count;
+		ujo_stats_add(w->stats, elements[type | UJO_TYPE_NULL_FLAG], count);
+
+		if (w->unchecked)
+		{
+			/* no position to track */
+		}
+		else if (w->state->state == STATE_TABLE_VALUES)
+		{
+			w->state->table.column = (w->state->table.column + count) % w->state->table.columns;
+		}
+		else if (w->state->state != STATE_LIST)
+		{
+			w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+		}
+		_ujo_writer_commit(w);
+	}
 
 	return UJO_SUCCESS;
 };
@@ -517,7 +1319,7 @@ ujoError ujo_writer_add_float16(ujo_writer* w, float32_t value)
 	ujoError err;
 	float16_t hValue = float_to_half(value);
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
 	if (isnan_float16(hValue) != 0)
 	{
@@ -528,13 +1330,7 @@ ujoError ujo_writer_add_float16(ujo_writer* w, float32_t value)
 		report_error(0,"value is out of range", UJO_ERR_INVALID_DATA);
 	}
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_FLOAT16));
-	hValue = (float16_t) UJO_UINT16_SWAP(hValue);
-	return_on_err(_ujo_writer_put(w, &hValue, sizeof(float16_t)));
-
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
-
-	return UJO_SUCCESS;
+	return _ujo_writer_add_float16_raw(w, hValue);
 };
 
 /**
@@ -553,13 +1349,13 @@ ujoError ujo_writer_add_float32(ujo_writer* w, float32_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_FLOAT32));
 	value = (float32_t) UJO_FLOAT32_SWAP(value);
-	return_on_err(_ujo_writer_put(w, &value, sizeof(float32_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_FLOAT32, &value, sizeof(float32_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -580,13 +1376,13 @@ ujoError ujo_writer_add_float64(ujo_writer* w, float64_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_FLOAT64));
 	value = (float64_t) UJO_FLOAT64_SWAP(value);
-	return_on_err(_ujo_writer_put(w, &value, sizeof(float64_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_FLOAT64, &value, sizeof(float64_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -605,12 +1401,12 @@ ujoError ujo_writer_add_bool(ujo_writer* w, ujoBool value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_BOOL));
-	return_on_err(_ujo_writer_put(w, &value, sizeof(ujoBool)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_BOOL, &value, sizeof(ujoBool)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -631,13 +1427,13 @@ ujoError ujo_writer_add_uint64(ujo_writer* w, uint64_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_UINT64));
 	value = (uint64_t) UJO_UINT64_SWAP(value);
-	return_on_err(_ujo_writer_put(w, &value, sizeof(uint64_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_UINT64, &value, sizeof(uint64_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -658,13 +1454,13 @@ ujoError ujo_writer_add_uint32(ujo_writer* w, uint32_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_UINT32));
 	value = (uint32_t) UJO_UINT32_SWAP(value);
-	return_on_err(_ujo_writer_put(w, &value, sizeof(uint32_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_UINT32, &value, sizeof(uint32_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -685,13 +1481,13 @@ ujoError ujo_writer_add_uint16(ujo_writer* w, uint16_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_UINT16));
 	value = (uint16_t) UJO_UINT16_SWAP(value);
-	return_on_err(_ujo_writer_put(w, &value, sizeof(uint16_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_UINT16, &value, sizeof(uint16_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -712,16 +1508,90 @@ ujoError ujo_writer_add_uint8(ujo_writer* w, uint8_t value)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_UINT8));
-	return_on_err(_ujo_writer_put(w, &value, sizeof(uint8_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_UINT8, &value, sizeof(uint8_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
 
+/**
+ * @brief Write a signed integer in its smallest representation.
+ *
+ * The value is written as UJO_TYPE_INT8, UJO_TYPE_INT16, UJO_TYPE_INT32 or
+ * UJO_TYPE_INT64, whichever is the smallest type to hold the value.
+ * The document remains a standard UJO document, a reader gets the
+ * narrowed type.
+ *
+ * @param w    ujo writer handle
+ * @param value signed integer value
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_add_uint_auto, ujo_writer_add_float_auto
+ */
+ujoError ujo_writer_add_int_auto(ujo_writer* w, int64_t value)
+{
+	if (value >= INT8_MIN && value <= INT8_MAX)
+		return ujo_writer_add_int8(w, (int8_t)value);
+	if (value >= INT16_MIN && value <= INT16_MAX)
+		return ujo_writer_add_int16(w, (int16_t)value);
+	if (value >= INT32_MIN && value <= INT32_MAX)
+		return ujo_writer_add_int32(w, (int32_t)value);
+	return ujo_writer_add_int64(w, value);
+};
+
+/**
+ * @brief Write an unsigned integer in its smallest representation.
+ *
+ * The value is written as UJO_TYPE_UINT8, UJO_TYPE_UINT16, UJO_TYPE_UINT32 or
+ * UJO_TYPE_UINT64, whichever is the smallest type to hold the value.
+ *
+ * @param w    ujo writer handle
+ * @param value unsigned integer value
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_add_int_auto, ujo_writer_add_float_auto
+ */
+ujoError ujo_writer_add_uint_auto(ujo_writer* w, uint64_t value)
+{
+	if (value <= UINT8_MAX)
+		return ujo_writer_add_uint8(w, (uint8_t)value);
+	if (value <= UINT16_MAX)
+		return ujo_writer_add_uint16(w, (uint16_t)value);
+	if (value <= UINT32_MAX)
+		return ujo_writer_add_uint32(w, (uint32_t)value);
+	return ujo_writer_add_uint64(w, value);
+};
+
+/**
+ * @brief Write a float value in its smallest lossless representation.
+ *
+ * The value is written as half, single or double precision float. A smaller
+ * type is only used if converting the value back results in exactly the
+ * same value. NaN and infinity are written as single precision.
+ *
+ * @param w    ujo writer handle
+ * @param value 64bit float value
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_add_float16, ujo_writer_add_float32, ujo_writer_add_float64
+ */
+ujoError ujo_writer_add_float_auto(ujo_writer* w, float64_t value)
+{
+	switch (_ujo_writer_float_type(value))
+	{
+	case UJO_TYPE_FLOAT16:
+		return ujo_writer_add_float16(w, (float32_t)value);
+	case UJO_TYPE_FLOAT32:
+		return ujo_writer_add_float32(w, (float32_t)value);
+	default:
+		return ujo_writer_add_float64(w, value);
+	}
+};
+
 /**
  * @brief Write a Unix date/time.
  *
@@ -740,13 +1610,13 @@ ujoError ujo_writer_add_uxtime(ujo_writer* w, int64_t t)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_UX_TIME));
 	t = (int64_t) UJO_UINT64_SWAP(t);
-	return_on_err(_ujo_writer_put(w, &t, sizeof(int64_t)));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_UX_TIME, &t, sizeof(int64_t)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -766,17 +1636,19 @@ ujoError ujo_writer_add_uxtime(ujo_writer* w, int64_t t)
 ujoError ujo_writer_add_date(ujo_writer* w, const ujoDateTime dt)
 {
 	ujoError err;
-	int16_t i16_year;
+	ujoByte  payload[4];
+	int16_t  i16_year;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_DATE));
 	i16_year = (int16_t) UJO_UINT16_SWAP(dt.year);
-	return_on_err(_ujo_writer_put(w, &i16_year, sizeof(int16_t)));
-	return_on_err(_ujo_writer_put(w, &dt.month, sizeof(uint8_t)));
-	return_on_err(_ujo_writer_put(w, &dt.day, sizeof(uint8_t)));
+	memcpy(payload, &i16_year, sizeof(int16_t));
+	payload[2] = dt.month;
+	payload[3] = dt.day;
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_DATE, payload, sizeof(payload)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -797,15 +1669,17 @@ ujoError ujo_writer_add_date(ujo_writer* w, const ujoDateTime dt)
 ujoError ujo_writer_add_time(ujo_writer* w, const ujoDateTime dt)
 {
 	ujoError err;
+	ujoByte  payload[3];
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_TIME));
-	return_on_err(_ujo_writer_put(w, &dt.hour, sizeof(uint8_t)));
-	return_on_err(_ujo_writer_put(w, &dt.minute, sizeof(uint8_t)));
-	return_on_err(_ujo_writer_put(w, &dt.second, sizeof(uint8_t)));
+	payload[0] = dt.hour;
+	payload[1] = dt.minute;
+	payload[2] = dt.second;
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_TIME, payload, sizeof(payload)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -827,25 +1701,26 @@ ujoError ujo_writer_add_time(ujo_writer* w, const ujoDateTime dt)
 ujoError ujo_writer_add_timestamp(ujo_writer* w, const ujoDateTime dt)
 {
 	ujoError err;
-	int16_t i16_temp;
-
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	ujoByte  payload[9];
+	int16_t  i16_temp;
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_TIMESTAMP));
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
 	i16_temp = (int16_t) UJO_UINT16_SWAP(dt.year);
-	return_on_err(_ujo_writer_put(w, &i16_temp, sizeof(int16_t)));
-	return_on_err(_ujo_writer_put(w, &dt.month, sizeof(uint8_t)));
-	return_on_err(_ujo_writer_put(w, &dt.day, sizeof(uint8_t)));
+	memcpy(payload, &i16_temp, sizeof(int16_t));
+	payload[2] = dt.month;
+	payload[3] = dt.day;
 
-	return_on_err(_ujo_writer_put(w, &dt.hour, sizeof(uint8_t)));
-	return_on_err(_ujo_writer_put(w, &dt.minute, sizeof(uint8_t)));
-	return_on_err(_ujo_writer_put(w, &dt.second, sizeof(uint8_t)));
+	payload[4] = dt.hour;
+	payload[5] = dt.minute;
+	payload[6] = dt.second;
 
 	i16_temp = (int16_t) UJO_UINT16_SWAP(dt.millisecond);
-	return_on_err(_ujo_writer_put(w, &i16_temp, sizeof(uint16_t)));
+	memcpy(payload + 7, &i16_temp, sizeof(uint16_t));
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_TIMESTAMP, payload, sizeof(payload)));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -867,17 +1742,16 @@ ujoError ujo_writer_add_timestamp(ujo_writer* w, const ujoDateTime dt)
 ujoError ujo_writer_add_string_c(ujo_writer* w, const char* s, size_t n)
 {
 	ujoError err;
-	uint32_t units = (uint32_t)(strnlen(s, n)+1);
-
-	report_error(ujo_state_allow_string(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	size_t   length = strnlen(s, n);
+	uint32_t units = (uint32_t)(length+1);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_STRING));
-	return_on_err(_ujo_writer_put_uint8(w, UJO_SUB_STRING_C));
+	report_error(w->unchecked || ujo_state_allow_string(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put(w, &units, sizeof(uint32_t)));
-	return_on_err(_ujo_writer_put(w, s, units));
+	// s is not terminated if it is longer than n
+	return_on_err(_ujo_writer_put_sequence(w, UJO_TYPE_STRING, UJO_SUB_STRING_C, units, s, length, ujoTrue));
 
-	w->state = ujo_state_switch(STRING_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, STRING_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -902,15 +1776,12 @@ ujoError ujo_writer_add_string_u8(ujo_writer* w, const uint8_t* s, size_t n)
 	ujoError err;
 	uint32_t units = (uint32_t)n;
 
-	report_error(ujo_state_allow_string(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_string(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_STRING));
-	return_on_err(_ujo_writer_put_uint8(w, UJO_SUB_STRING_U8));
+	return_on_err(_ujo_writer_put_sequence(w, UJO_TYPE_STRING, UJO_SUB_STRING_U8, units, s, n, ujoFalse));
 
-	return_on_err(_ujo_writer_put(w, &units, sizeof(uint32_t)));
-	return_on_err(_ujo_writer_put(w, s, n));
-
-	w->state = ujo_state_switch(STRING_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, STRING_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -934,15 +1805,12 @@ ujoError ujo_writer_add_string_u16(ujo_writer* w, const uint16_t* s, size_t n)
 	ujoError err;
 	uint32_t units = (uint32_t)n;
 
-	report_error(ujo_state_allow_string(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
-
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_STRING));
-	return_on_err(_ujo_writer_put_uint8(w, UJO_SUB_STRING_U16));
+	report_error(w->unchecked || ujo_state_allow_string(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put(w, &units, sizeof(uint32_t)));
-	return_on_err(_ujo_writer_put(w, s, n*sizeof(uint16_t)));
+	return_on_err(_ujo_writer_put_sequence(w, UJO_TYPE_STRING, UJO_SUB_STRING_U16, units, s, n*sizeof(uint16_t), ujoFalse));
 
-	w->state = ujo_state_switch(STRING_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, STRING_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -966,15 +1834,12 @@ ujoError ujo_writer_add_string_u32(ujo_writer* w, const uint32_t* s, size_t n)
 	ujoError err;
 	uint32_t units = (uint32_t)n;
 
-	report_error(ujo_state_allow_string(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_string(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_STRING));
-	return_on_err(_ujo_writer_put_uint8(w, UJO_SUB_STRING_U32));
+	return_on_err(_ujo_writer_put_sequence(w, UJO_TYPE_STRING, UJO_SUB_STRING_U32, units, s, n*sizeof(uint32_t), ujoFalse));
 
-	return_on_err(_ujo_writer_put(w, &units, sizeof(uint32_t)));
-	return_on_err(_ujo_writer_put(w, s, n*sizeof(uint32_t)));
-
-	w->state = ujo_state_switch(STRING_FOUND, w->state, w->state_stack);
+	_ujo_writer_switch(w, STRING_FOUND);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -999,15 +1864,160 @@ ujoError ujo_writer_add_binary(ujo_writer* w, uint8_t t, const uint8_t* d, uint3
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+
+	return_on_err(_ujo_writer_put_sequence(w, UJO_TYPE_BIN, t, n, d, n, ujoFalse));
+
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Write binary data by reference.
+ *
+ * Only the binary header is written to the buffer. The payload is not
+ * copied, the writer records the pointer and the size and returns the
+ * payload as a piece of its own in ujo_writer_get_iovecs(). The data has
+ * to stay valid and unchanged until the document is sent or flattened.
+ * References are useful for large payloads like images or firmware files,
+ * small values are written faster by ujo_writer_add_binary().
+ *
+ * \code{.c}
+ *   ujo_new_segmented_writer(&w, 0, NULL);
+ *   ujo_writer_add_binary_ref(w, 0, frame, framesize);
+ *   ujo_writer_get_iovecs(w, &iov, &count);
+ *   writev(fd, (const struct iovec*)iov, (int)count);
+ * \endcode
+ *
+ * @param w    ujo writer handle
+ * @param t    binary data type
+ * @param d    data
+ * @param n    number of bytes
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_add_binary, ujo_new_segmented_writer, ujo_writer_get_iovecs
+ */
+ujoError ujo_writer_add_binary_ref(ujo_writer* w, uint8_t t, const uint8_t* d, uint32_t n)
+{
+	ujoError err;
+
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->segmented, "references require a segmented writer", UJO_ERR_INVALID_OBJECT);
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_BIN));
+	return_on_err(_ujo_writer_put_type(w, UJO_TYPE_BIN));
 	return_on_err(_ujo_writer_put_uint8(w, t));
 
 	return_on_err(_ujo_writer_put(w, &n, sizeof(uint32_t)));
+
+	if (n > 0)
+	{
+		return_on_err(_ujo_writer_grow_iovecs(w, &w->iovecs, &w->iovslots, w->iovcount + 2));
+		_ujo_writer_close_piece(w);
+		w->iovecs[w->iovcount].base = (ujoByte*)d;
+		w->iovecs[w->iovcount].len  = n;
+		w->iovcount++;
+		w->piecebytes += n;
+		ujo_stats_add(w->stats, bytes, n);
+		_ujo_writer_open_piece(w);
+	}
+
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Begin binary data written in chunks.
+ *
+ * Large binary data does not have to be in memory at once. After the
+ * header is written with the total size, the data is added by any number
+ * of calls to ujo_writer_binary_append(). ujo_writer_binary_end() 
+ * completes the value. No other value can be written in between.
+ *
+ * \code{.c}
+ *   ujo_writer_binary_begin(w, 0, filesize);
+ *   while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+ *     ujo_writer_binary_append(w, chunk, n);
+ *   ujo_writer_binary_end(w);
+ * \endcode
+ *
+ * @param w    ujo writer handle
+ * @param t    binary data type
+ * @param n    total number of bytes
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_binary_append, ujo_writer_binary_end, ujo_writer_add_binary
+ */
+ujoError ujo_writer_binary_begin(ujo_writer* w, uint8_t t, uint32_t n)
+{
+	ujoError err;
+
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+
+	return_on_err(_ujo_writer_put_type(w, UJO_TYPE_BIN));
+	return_on_err(_ujo_writer_put_uint8(w, t));
+	return_on_err(_ujo_writer_put(w, &n, sizeof(uint32_t)));
+
+	if (!w->unchecked)
+		w->state = ujo_state_next(STATE_BINARY, w->state, w->state_stack);
+	w->binaryleft = n;
+	_ujo_writer_commit(w);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief Append a chunk to binary data.
+ *
+ * The chunks must not exceed the total size given to 
+ * ujo_writer_binary_begin().
+ *
+ * @param w    ujo writer handle
+ * @param d    data
+ * @param n    number of bytes
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_binary_begin, ujo_writer_binary_end
+ */
+ujoError ujo_writer_binary_append(ujo_writer* w, const uint8_t* d, uint32_t n)
+{
+	ujoError err;
+
+	report_error(w->unchecked || w->state->state == STATE_BINARY,"no binary open", UJO_ERR_INVALID_OBJECT);
+	report_error(n <= w->binaryleft,"binary exceeds total size", UJO_ERR_INVALID_DATA);
+
 	return_on_err(_ujo_writer_put(w, d, n));
 
-	w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	w->binaryleft -= n;
+	_ujo_writer_commit(w);
+
+	return UJO_SUCCESS;
+};
+
+/**
+ * @brief End binary data written in chunks.
+ *
+ * All octets announced by ujo_writer_binary_begin() have to be appended.
+ *
+ * @param w    ujo writer handle
+ *
+ * @return UJO error code or UJO_SUCCESS
+ * @sa ujo_writer_binary_begin, ujo_writer_binary_append
+ */
+ujoError ujo_writer_binary_end(ujo_writer* w)
+{
+	report_error(w->unchecked || w->state->state == STATE_BINARY,"no binary open", UJO_ERR_INVALID_OBJECT);
+	report_error(w->binaryleft == 0,"binary incomplete", UJO_ERR_INVALID_DATA);
+
+	if (!w->unchecked)
+	{
+		w->state = ujo_state_prev(w->state, w->state_stack);
+		w->state = ujo_state_switch(ATOMIC_FOUND, w->state, w->state_stack);
+	}
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -1036,15 +2046,16 @@ ujoError ujo_writer_table_open(ujo_writer* w)
 {
 	ujoError err;
 
-	report_error(ujo_state_allow_container(w->state->state),"table not allowed", UJO_ERR_TYPE_MISPLACED);
+	report_error(w->unchecked || ujo_state_allow_container(w->state->state),"table not allowed", UJO_ERR_TYPE_MISPLACED);
 
-	w->state = ujo_state_next(STATE_TABLE_COLUMNS, w->state, w->state_stack);
+	return_on_err(_ujo_writer_put_type(w, UJO_TYPE_TABLE));
+
+	_ujo_writer_open(w, STATE_TABLE_COLUMNS);
+	_ujo_writer_commit(w);
 	
 	w->state->table.columns = 0;
 	w->state->table.column  = 0;
 
-	return_on_err(_ujo_writer_put_uint8(w, UJO_TYPE_TABLE));
-
 	return UJO_SUCCESS;
 };
 
@@ -1063,12 +2074,15 @@ ujoError ujo_writer_table_end_columns(ujo_writer* w)
 {
 	ujoError err;
 
-	report_error(w->state->state==STATE_TABLE_COLUMNS,"close table columns not allowed", UJO_ERR_INVALID_OBJECT);
-	report_error(w->state->table.columns > 0,"minimum column count mismatch", UJO_ERR_INVALID_OBJECT);
+	report_error(w->unchecked || w->state->state==STATE_TABLE_COLUMNS,"close table columns not allowed", UJO_ERR_INVALID_OBJECT);
+	report_error(w->unchecked || w->state->table.columns > 0,"minimum column count mismatch", UJO_ERR_INVALID_OBJECT);
 	
 	return_on_err(_ujo_writer_put_uint8(w, UJO_TERMINATOR));
 
-    w->state->state = STATE_TABLE_VALUES;
+	if (!w->unchecked)
+		w->state->state = STATE_TABLE_VALUES;
+	_ujo_writer_commit(w);
+	ujo_stats_add(w->stats, elements[UJO_TERMINATOR], 1);
 
 	return UJO_SUCCESS;
 };
@@ -1085,13 +2099,14 @@ ujoError ujo_writer_table_end_columns(ujo_writer* w)
  */
 ujoError ujo_writer_table_close(ujo_writer* w)
 {
-	report_error(w->state->state==STATE_TABLE_VALUES,"close table not allowed", UJO_ERR_INVALID_OBJECT);
-	report_error(w->state->table.column == 0,"unbalanced table row", UJO_ERR_INVALID_OBJECT);
-	
-	w->state = ujo_state_prev(w->state, w->state_stack);
-	_ujo_writer_put_uint8(w, UJO_TERMINATOR);
+	ujoError err;
 
-    w->state = ujo_state_switch(CONTAINER_CLOSED, w->state, w->state_stack);
+	report_error(w->unchecked ? w->open > 0 : w->state->state==STATE_TABLE_VALUES,"close table not allowed", UJO_ERR_INVALID_OBJECT);
+	report_error(w->unchecked || w->state->table.column == 0,"unbalanced table row", UJO_ERR_INVALID_OBJECT);
+	
+	return_on_err(_ujo_writer_put_type(w, UJO_TERMINATOR));
+	_ujo_writer_close(w);
+	_ujo_writer_commit(w);
 
 	return UJO_SUCCESS;
 };
@@ -1101,6 +2116,30 @@ ujoError ujo_writer_table_close(ujo_writer* w)
 @cond INTERNAL_DOCS
 */
 
+static ujoError _ujo_writer_put_segments(ujo_writer* w, const ujoByte* sequence, size_t bytes) 
+{
+	ujoError   err;
+	size_t     room;
+
+	while (bytes > 0)
+	{
+		room = w->buffersize - w->bytes;
+		if (room == 0)
+		{
+			return_on_err(_ujo_writer_next_segment(w));
+			continue;
+		}
+		if (room > bytes)
+			room = bytes;
+		memcpy(w->buffer + w->bytes, sequence, room);
+		w->bytes += room;
+		sequence += room;
+		bytes -= room;
+	}
+
+	return UJO_SUCCESS;
+}
+
 static __inline ujoError _ujo_writer_put_memory(ujo_writer* w, const void* sequence, size_t bytes) 
 {
 	uint64_t   totalbytes;
@@ -1111,14 +2150,25 @@ static __inline ujoError _ujo_writer_put_memory(ujo_writer* w, const void* seque
 
 	/* resize buffer */
 	if (totalbytes > w->buffersize) {
+		/* a fixed buffer never grows, the incomplete value is dropped */
+		if (w->fixed) {
+			ujo_stats_add(w->stats, bytes, (uint64_t)0 - (w->bytes - w->committed));
+			w->bytes = w->committed;
+			w->pending = UJO_NO_TYPE;
+			report_error(ujoFalse, "buffer full", UJO_ERR_BUFFER_FULL);
+		}
+		if (w->segmented)
+			return _ujo_writer_put_segments(w, (const ujoByte*)sequence, bytes);
 		/* reallocate buffer */
 		newbufsize = w->buffersize + ((bytes / UJO_DEFAULT_BUFSIZE)+1)*UJO_DEFAULT_BUFSIZE;
 		temp = w->buffer;
-		w->buffer = (ujoByte*)realloc(w->buffer, newbufsize);
+		w->buffer = (ujoByte*)ujo_allocator_realloc(w->allocator, w->buffer, w->buffersize, newbufsize);
 		if (w->buffer == NULL) {
 			w->buffer = temp;
 			report_error(ujoFalse, "resize buffer failed", UJO_ERR_ALLOCATION);
 		} /* end if */
+		ujo_stats_add(w->stats, reallocs, 1);
+		ujo_stats_add(w->stats, heapbytes, newbufsize - w->buffersize);
 		w->buffersize = newbufsize;
 	}
 
@@ -1135,11 +2185,53 @@ static __inline ujoError _ujo_writer_put_file(ujo_writer* w, const void* sequenc
 
 	report_error(fwrite(sequence, 1, bytes, w->file) == bytes,
 		"write to file failed", UJO_ERR_FILE);
+	w->filebytes += bytes;
+	ujo_stats_add(w->stats, iocalls, 1);
 
 	return UJO_SUCCESS;
 };
 
 
+/* smallest float type holding the value without loss */
+ujoTypeId _ujo_writer_float_type(float64_t value)
+{
+	float32_t f32;
+	float16_t f16;
+
+	/* NaN and infinity have no half precision representation */
+	if (value != value || value > DBL_MAX || value < -DBL_MAX)
+		return UJO_TYPE_FLOAT32;
+
+	if (value > FLT_MAX || value < -FLT_MAX)
+		return UJO_TYPE_FLOAT64;
+
+	f32 = (float32_t)value;
+	if ((float64_t)f32 != value)
+		return UJO_TYPE_FLOAT64;
+
+	f16 = float_to_half(f32);
+	if (isnan_float16(f16) == 0 && isinf_float16(f16) == 0 &&
+		(float64_t)half_to_float(f16) == value)
+		return UJO_TYPE_FLOAT16;
+
+	return UJO_TYPE_FLOAT32;
+}
+
+uint64_t _ujo_writer_get_position(ujo_writer* w)
+{
+	switch(w->type)
+	{
+	case UJO_MEMORY:
+		if (w->segmented)
+			return w->piecebytes + (w->bytes - w->piecestart);
+		return w->bytes;
+	case UJO_FILE:
+		return w->filebytes;
+	default:
+		return 0;
+	}
+}
+
 ujoError _ujo_writer_put(ujo_writer* w, const void* sequence, size_t bytes)
 {
 	ujoError err = UJO_SUCCESS;
@@ -1155,6 +2247,8 @@ ujoError _ujo_writer_put(ujo_writer* w, const void* sequence, size_t bytes)
 	default:
 		break;
 	}
+	if (err == UJO_SUCCESS)
+		ujo_stats_add(w->stats, bytes, bytes);
 	return err;
 }
 
@@ -1169,6 +2263,27 @@ ujoError _ujo_writer_put_uint16(ujo_writer* w, uint16_t value)
 	return _ujo_writer_put(w, &value, sizeof(uint16_t));
 };
 
+/* write the bits of a half precision value as they are, NaN and infinity included */
+ujoError _ujo_writer_add_float16_raw(ujo_writer* w, uint16_t value)
+{
+	ujoError err;
+
+	report_error(w->unchecked || ujo_state_allow_atomic(w->state->state),"value not allowed", UJO_ERR_TYPE_MISPLACED);
+
+	value = UJO_UINT16_SWAP(value);
+	return_on_err(_ujo_writer_put_atomic(w, UJO_TYPE_FLOAT16, &value, sizeof(uint16_t)));
+
+	_ujo_writer_switch(w, ATOMIC_FOUND);
+	_ujo_writer_commit(w);
+
+	return UJO_SUCCESS;
+}
+
+ujoBool _ujo_writer_is_closed(ujo_writer* w)
+{
+	return (ujoBool)(w->state->state == STATE_CLOSED);
+};
+
 
 /**
 @endcond
@@ -29,6 +29,7 @@
 
 #include "ujo.h"
 #include "ujo_types.h"
+#include "ujo_handler.h"
 #include "ujo_float.h"
 
 typedef struct _ujo_writer ujo_writer;
@@ -43,11 +44,27 @@ BEGIN_C_DECLS
 	ujoError ujo_new_memory_writer(ujo_writer** w);
 	ujoError ujo_new_file_writer(ujo_writer** w, const char* filename);
 
+	ujoError ujo_new_memory_writer_ex(ujo_writer** w, const ujoAllocator* allocator);
+	ujoError ujo_new_fixed_writer(ujo_writer** w, ujoByte* buffer, size_t capacity);
+	ujoError ujo_new_segmented_writer(ujo_writer** w, size_t segmentsize, const ujoAllocator* allocator);
+	ujoError ujo_new_file_writer_ex(ujo_writer** w, const char* filename, const ujoAllocator* allocator);
+
 	ujoError ujo_free_writer(ujo_writer* w);
 
+	ujoError ujo_writer_reset(ujo_writer* w);
+
 	ujoError ujo_writer_get_type(ujo_writer* w, ujoAccessType* type);
 
+	ujoError ujo_writer_get_stats(ujo_writer* w, ujoStats* stats);
+
+	ujoError ujo_writer_set_unchecked(ujo_writer* w, ujoBool unchecked);
+	ujoError ujo_writer_finish(ujo_writer* w);
+
 	ujoError ujo_writer_get_buffer(ujo_writer *w, ujoByte** buffer, size_t *bytes);
+	ujoError ujo_writer_get_iovecs(ujo_writer* w, const ujoIovec** iovecs, size_t* count);
+	ujoError ujo_writer_flatten(ujo_writer* w, ujoByte** buffer, size_t* bytes);
+	ujoError ujo_writer_detach_buffer(ujo_writer* w, ujoByte** buffer, size_t *bytes, ujoDestroyFunc* destroy);
+	ujoError ujo_writer_shrink_to_fit(ujo_writer* w);
 
 	// list methods
 	ujoError ujo_writer_list_open(ujo_writer* w);
@@ -74,6 +91,11 @@ BEGIN_C_DECLS
 	ujoError ujo_writer_add_uint16(ujo_writer* w, uint16_t value);
 	ujoError ujo_writer_add_uint8(ujo_writer* w, uint8_t value);
 
+	// smallest lossless representation
+	ujoError ujo_writer_add_int_auto(ujo_writer* w, int64_t value);
+	ujoError ujo_writer_add_uint_auto(ujo_writer* w, uint64_t value);
+	ujoError ujo_writer_add_float_auto(ujo_writer* w, float64_t value);
+
 	// float types
 	ujoError ujo_writer_add_float16(ujo_writer* w, float32_t value);
 	ujoError ujo_writer_add_float32(ujo_writer* w, float32_t value);
@@ -82,6 +104,7 @@ BEGIN_C_DECLS
 	// none,null types
 	ujoError ujo_writer_add_none(ujo_writer* w);
 	ujoError ujo_writer_add_null(ujo_writer* w, ujoTypeId type);
+	ujoError ujo_writer_add_nulls(ujo_writer* w, ujoTypeId type, uint32_t n);
 
 	// date and time
 	ujoError ujo_writer_add_uxtime(ujo_writer* w, int64_t t);
@@ -101,6 +124,10 @@ BEGIN_C_DECLS
 
 	// binary
 	ujoError ujo_writer_add_binary(ujo_writer* w, uint8_t t, const uint8_t* d, uint32_t n);
+	ujoError ujo_writer_add_binary_ref(ujo_writer* w, uint8_t t, const uint8_t* d, uint32_t n);
+	ujoError ujo_writer_binary_begin(ujo_writer* w, uint8_t t, uint32_t n);
+	ujoError ujo_writer_binary_append(ujo_writer* w, const uint8_t* d, uint32_t n);
+	ujoError ujo_writer_binary_end(ujo_writer* w);
 
 
 	/* internal methods: don't use them in applications. */
@@ -112,6 +139,10 @@ BEGIN_C_DECLS
 	ujoError _ujo_writer_put(ujo_writer* w, const void* sequence, size_t bytes);
 	ujoError _ujo_writer_put_uint8(ujo_writer* w, uint8_t value); 
 	ujoError _ujo_writer_put_uint16(ujo_writer* w, uint16_t value); 
+	ujoBool  _ujo_writer_is_closed(ujo_writer* w);
+	uint64_t _ujo_writer_get_position(ujo_writer* w);
+	ujoTypeId _ujo_writer_float_type(float64_t value);
+	ujoError _ujo_writer_add_float16_raw(ujo_writer* w, uint16_t value);
 
 	/**
 	@endcond
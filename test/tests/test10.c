@@ -0,0 +1,166 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+
+#define TEST10_COLUMNS 8
+
+/**
+ * test10: sparse table with null values
+ */
+ujoBool test10()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujo_element*	element;
+
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoBool			eod;
+	ujoTypeId		type;
+	ujoTypeId		nulltype;
+	char			column[16];
+	int				i;
+	int				nulls;
+	int				values;
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+
+	err = ujo_writer_table_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_table_open"); 
+
+	for (i = 0; i < TEST10_COLUMNS; i++)
+	{
+		sprintf(column, "col%d", i);
+		err = ujo_writer_add_string_c(ujow, column, sizeof(column));
+		print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	}
+
+	err = ujo_writer_table_end_columns(ujow);
+	print_return_ujo_err(err,"ujo_writer_table_end_columns"); 
+
+	// first row: one value and 7 null values
+	err = ujo_writer_add_int32(ujow, 42);
+	print_return_ujo_err(err,"ujo_writer_add_int32"); 
+
+	datasize = get_write_buffer_size(ujow);
+	err = ujo_writer_add_nulls(ujow, UJO_TYPE_FLOAT64, TEST10_COLUMNS-1);
+	print_return_ujo_err(err,"ujo_writer_add_nulls"); 
+	print_return_expr_fail(datasize+TEST10_COLUMNS-1 == get_write_buffer_size(ujow),
+		"null size unexpected");
+
+	// second row: null values around a string
+	err = ujo_writer_add_nulls(ujow, UJO_TYPE_INT64, 3);
+	print_return_ujo_err(err,"ujo_writer_add_nulls"); 
+
+	err = ujo_writer_add_string_c(ujow, "ok", sizeof("ok"));
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+
+	err = ujo_writer_add_null(ujow, UJO_TYPE_STRING);
+	print_return_ujo_err(err,"ujo_writer_add_null"); 
+
+	err = ujo_writer_add_nulls(ujow, UJO_TYPE_BOOL, 3);
+	print_return_ujo_err(err,"ujo_writer_add_nulls"); 
+
+	// third row: an empty row
+	err = ujo_writer_add_nulls(ujow, UJO_TYPE_UINT8, TEST10_COLUMNS);
+	print_return_ujo_err(err,"ujo_writer_add_nulls"); 
+
+	// the rows are balanced, the table can be closed
+	err = ujo_writer_table_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_table_close"); 
+
+	err = ujo_writer_add_null(ujow, UJO_TYPE_INT8);
+	print_return_expr_fail(err == UJO_ERR_TYPE_MISPLACED, "null after end of document");
+
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	print_buffer(data, datasize);
+
+	/* read the nulls back */
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+
+	err = ujo_reader_set_buffer(ujor, data, datasize);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+
+	nulls  = 0;
+	values = 0;
+
+	err = ujo_reader_get_first(ujor, &element, &eod);
+	print_return_ujo_err(err,"ujo_reader_get_first");
+
+	while (!eod)
+	{
+		err = ujo_element_get_type(element, &type);
+		print_return_ujo_err(err,"ujo_element_get_type");
+
+		if (type & UJO_TYPE_NULL_FLAG)
+		{
+			err = ujo_element_get_null_type(element, &nulltype);
+			print_return_ujo_err(err,"ujo_element_get_null_type");
+			print_return_expr_fail(nulltype == (type & ~UJO_TYPE_NULL_FLAG), "null type mismatch");
+			nulls++;
+		}
+		else
+		{
+			err = ujo_element_get_null_type(element, &nulltype);
+			print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "value reported as null");
+			values++;
+		}
+
+		err = ujo_free_element(element);
+		print_return_ujo_err(err,"ujo_free_element");
+
+		err = ujo_reader_get_next(ujor, &element, &eod);
+		print_return_ujo_err(err,"ujo_reader_get_next");
+	}
+
+	printf("%d nulls, %d values\n", nulls, values);
+	print_return_expr_fail(nulls == 3*TEST10_COLUMNS-2, "null count mismatch");
+
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
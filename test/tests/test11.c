@@ -0,0 +1,137 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+
+/**
+ * test11: automatic numeric narrowing
+ */
+ujoBool test11()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujo_element*	element;
+
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoBool			eod;
+	ujoTypeId		type;
+	int				index;
+
+	int64_t  ivalues[]  = { 5, -200, 70000, INT64_C(1099511627776), INT8_MIN, INT32_MIN };
+	uint64_t uvalues[]  = { 255, 256, 65536, UINT64_C(4294967296) };
+	float64_t fvalues[] = { 0.5, 0.1, (float32_t)3.14, 65504.0, -2.0, 1.0e300 };
+
+	ujoTypeId expected[] = {
+		UJO_TYPE_LIST,
+		UJO_TYPE_INT8, UJO_TYPE_INT16, UJO_TYPE_INT32, UJO_TYPE_INT64, UJO_TYPE_INT8, UJO_TYPE_INT32,
+		UJO_TYPE_UINT8, UJO_TYPE_UINT16, UJO_TYPE_UINT32, UJO_TYPE_UINT64,
+		UJO_TYPE_FLOAT16, UJO_TYPE_FLOAT64, UJO_TYPE_FLOAT32, UJO_TYPE_FLOAT16, UJO_TYPE_FLOAT16, UJO_TYPE_FLOAT64,
+		UJO_TERMINATOR
+	};
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+
+	for (index = 0; index < (int)(sizeof(ivalues)/sizeof(int64_t)); index++)
+	{
+		err = ujo_writer_add_int_auto(ujow, ivalues[index]);
+		print_return_ujo_err(err,"ujo_writer_add_int_auto"); 
+	}
+
+	for (index = 0; index < (int)(sizeof(uvalues)/sizeof(uint64_t)); index++)
+	{
+		err = ujo_writer_add_uint_auto(ujow, uvalues[index]);
+		print_return_ujo_err(err,"ujo_writer_add_uint_auto"); 
+	}
+
+	for (index = 0; index < (int)(sizeof(fvalues)/sizeof(float64_t)); index++)
+	{
+		err = ujo_writer_add_float_auto(ujow, fvalues[index]);
+		print_return_ujo_err(err,"ujo_writer_add_float_auto"); 
+	}
+
+	err = ujo_writer_list_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_close"); 
+
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	print_buffer(data, datasize);
+
+	/* check the narrowed types */
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+
+	err = ujo_reader_set_buffer(ujor, data, datasize);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+
+	err = ujo_reader_get_first(ujor, &element, &eod);
+	print_return_ujo_err(err,"ujo_reader_get_first");
+
+	index = 0;
+	while (!eod)
+	{
+		print_return_expr_fail(index < (int)sizeof(expected), "too many elements");
+
+		err = ujo_element_get_type(element, &type);
+		print_return_ujo_err(err,"ujo_element_get_type");
+		if (type != expected[index])
+			printf("element %d: type %d, expected %d\n", index, type, expected[index]);
+		print_return_expr_fail(type == expected[index], "unexpected narrowed type");
+
+		err = ujo_free_element(element);
+		print_return_ujo_err(err,"ujo_free_element");
+
+		err = ujo_reader_get_next(ujor, &element, &eod);
+		print_return_ujo_err(err,"ujo_reader_get_next");
+		index++;
+	}
+	print_return_expr_fail(index == (int)sizeof(expected), "element count mismatch");
+
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
@@ -0,0 +1,212 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * repack a buffer into a new memory writer
+ */
+static ujoError test12_repack(ujoByte* data, size_t datasize, ujo_writer** w)
+{
+	ujo_reader* ujor;
+	ujoError    err;
+
+	err = ujo_new_memory_reader(&ujor);
+	if (err != UJO_SUCCESS) return err;
+
+	err = ujo_reader_set_buffer(ujor, data, datasize);
+	if (err == UJO_SUCCESS)
+		err = ujo_new_memory_writer(w);
+	if (err == UJO_SUCCESS)
+		err = ujo_repack(ujor, *w);
+
+	ujo_free_reader(ujor);
+	return err;
+}
+
+/**
+ * test12: repack documents
+ */
+ujoBool test12()
+{
+	ujo_writer *ujow;
+	ujo_writer *packed;
+	ujo_writer *repacked;
+	ujoError   err = UJO_SUCCESS;
+	ujoByte    *data;
+	size_t     datasize;
+	ujoByte    *packeddata;
+	size_t     packedsize;
+	ujoByte    *repackeddata;
+	size_t     repackedsize;
+	char*      binstring;
+	ujoByte    special[UJO_HEADER_SIZE + 8];
+	size_t     index;
+	ujoBool    nan_found = ujoFalse;
+
+	uint16_t   u16_ascii[] = { 'U', 'J', 'O' };
+	uint16_t   u16_text[]  = { 'U', 0x00DF };
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+
+	err = ujo_writer_map_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_map_open"); 
+
+		err = ujo_writer_add_string_u16(ujow, u16_ascii, 3);
+		print_return_ujo_err(err,"ujo_writer_add_string_u16"); 
+
+		err = ujo_writer_list_open(ujow);
+		print_return_ujo_err(err,"ujo_writer_list_open"); 
+
+		err = ujo_writer_add_int64(ujow, 7);
+		print_return_ujo_err(err,"ujo_writer_add_int64"); 
+
+		err = ujo_writer_add_uint32(ujow, 300);
+		print_return_ujo_err(err,"ujo_writer_add_uint32"); 
+
+		err = ujo_writer_add_float64(ujow, 1.5);
+		print_return_ujo_err(err,"ujo_writer_add_float64"); 
+
+		err = ujo_writer_add_null(ujow, UJO_TYPE_INT64);
+		print_return_ujo_err(err,"ujo_writer_add_null"); 
+
+		err = ujo_writer_list_close(ujow);
+		print_return_ujo_err(err,"ujo_writer_list_close"); 
+
+		err = ujo_writer_add_string_u16(ujow, u16_text, 2);
+		print_return_ujo_err(err,"ujo_writer_add_string_u16"); 
+
+		err = ujo_writer_table_open(ujow);
+		print_return_ujo_err(err,"ujo_writer_table_open"); 
+
+		err = ujo_writer_add_string_c(ujow, "id", sizeof("id"));
+		print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+
+		err = ujo_writer_table_end_columns(ujow);
+		print_return_ujo_err(err,"ujo_writer_table_end_columns"); 
+
+		err = ujo_writer_add_int32(ujow, -1);
+		print_return_ujo_err(err,"ujo_writer_add_int32"); 
+
+		err = ujo_writer_table_close(ujow);
+		print_return_ujo_err(err,"ujo_writer_table_close"); 
+
+	err = ujo_writer_map_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_map_close"); 
+
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	// repack
+	err = test12_repack(data, datasize, &packed);
+	print_return_ujo_err(err,"ujo_repack"); 
+
+	err = ujo_writer_get_buffer(packed, &packeddata, &packedsize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	print_buffer(packeddata, packedsize);
+	printf("%u bytes repacked to %u bytes\n", (unsigned int)datasize, (unsigned int)packedsize);
+
+	binstring = (char*)calloc(packedsize*2+1, 1);
+	err = bin_to_str(packeddata, binstring, packedsize);
+	print_return_ujo_err(err, "bin_to_str");
+
+	print_return_expr_fail(strcmp("5f554a4f01000031040103000000554a4f3008070b2c0103003e85000402020000005500df00"
+		"320400030000006964000008ff0000",binstring) == 0,"repack integrity failed");
+	free(binstring);
+
+	// repacking is reproducible and the result can not be packed further
+	err = test12_repack(packeddata, packedsize, &repacked);
+	print_return_ujo_err(err,"ujo_repack"); 
+
+	err = ujo_writer_get_buffer(repacked, &repackeddata, &repackedsize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	print_return_expr_fail(repackedsize == packedsize &&
+		memcmp(repackeddata, packeddata, packedsize) == 0, "repacked document differs");
+
+	err = ujo_free_writer(repacked);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	err = ujo_free_writer(packed);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	// half precision NaN and infinity are copied unchanged
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	for (index = 0; index < 2; index++)
+	{
+		err = ujo_writer_add_float16(ujow, 1.5f);
+		print_return_ujo_err(err,"ujo_writer_add_float16"); 
+	}
+	err = ujo_writer_list_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_close"); 
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	print_return_expr_fail(datasize == sizeof(special), "unexpected document size");
+
+	// 1.5 is 0x3E00, NaN is 0x7E00 and infinity 0x7C00
+	memcpy(special, data, datasize);
+	for (index = UJO_HEADER_SIZE; index < datasize; index++)
+	{
+		if (special[index] == 0x3E)
+		{
+			special[index] = nan_found ? 0x7C : 0x7E;
+			nan_found = ujoTrue;
+		}
+	}
+
+	err = test12_repack(special, sizeof(special), &packed);
+	print_return_ujo_err(err,"ujo_repack"); 
+	err = ujo_writer_get_buffer(packed, &packeddata, &packedsize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	print_return_expr_fail(packedsize == sizeof(special) &&
+		memcmp(packeddata, special, sizeof(special)) == 0, "half precision NaN or infinity changed");
+
+	err = ujo_free_writer(packed);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
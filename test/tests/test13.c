@@ -0,0 +1,193 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include "ujo_template.h"
+#include <stdio.h>
+#include <string.h>
+
+static ujoError test13_reference(ujo_writer* w, uint32_t seq, float32_t temp, ujoBool ok, uint16_t level, const ujoDateTime ts)
+{
+	ujoError err;
+
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "seq", 3));
+	return_on_err(ujo_writer_add_uint32(w, seq));
+	return_on_err(ujo_writer_add_string_c(w, "temp", 4));
+	return_on_err(ujo_writer_add_float32(w, temp));
+	return_on_err(ujo_writer_add_string_c(w, "ok", 2));
+	return_on_err(ujo_writer_add_bool(w, ok));
+	return_on_err(ujo_writer_add_string_c(w, "level", 5));
+	return_on_err(ujo_writer_add_uint16(w, level));
+	return_on_err(ujo_writer_add_string_c(w, "ts", 2));
+	return_on_err(ujo_writer_add_timestamp(w, ts));
+	return_on_err(ujo_writer_map_close(w));
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * test13: message templates
+ */
+ujoBool test13()
+{
+	ujo_template*   tpl;
+	ujo_writer*		ujow;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte*		refdata;
+	size_t			refsize;
+
+	ujoSlot         seq, temp, ok, level, ts;
+	ujoDateTime     dt = { 2016, 2, 29, 23, 59, 58, 999 };
+	uint32_t        index;
+	alloc_counter   counter;
+
+	err = ujo_new_template(&tpl);
+	print_return_ujo_err(err,"ujo_new_template"); 
+
+	err = ujo_template_get_writer(tpl, &ujow);
+	print_return_ujo_err(err,"ujo_template_get_writer"); 
+
+	err = ujo_writer_map_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_map_open"); 
+	err = ujo_writer_add_string_c(ujow, "seq", 3);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_UINT32, &seq);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_add_string_c(ujow, "temp", 4);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_FLOAT32, &temp);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_add_string_c(ujow, "ok", 2);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_BOOL, &ok);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_add_string_c(ujow, "level", 5);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_UINT16, &level);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_add_string_c(ujow, "ts", 2);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_TIMESTAMP, &ts);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+
+	// strings have no fixed size
+	err = ujo_template_add_slot(tpl, UJO_TYPE_STRING, &index);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "string slot accepted");
+
+	// a template has to be a complete document
+	err = ujo_template_finish(tpl);
+	print_return_expr_fail(err == UJO_ERR_INVALID_OBJECT, "open document accepted");
+
+	err = ujo_writer_map_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_map_close"); 
+
+	err = ujo_template_finish(tpl);
+	print_return_ujo_err(err,"ujo_template_finish"); 
+
+	// slot type and range checks
+	err = ujo_template_set_int(tpl, seq, 1);
+	print_return_expr_fail(err == UJO_ERR_TYPE_MISPLACED, "type mismatch accepted");
+	err = ujo_template_set_uint(tpl, level, 70000);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "out of range value accepted");
+	err = ujo_template_set_bool(tpl, 5, ujoTrue);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "invalid slot accepted");
+
+	// each message has to be identical to a document written value by value
+	for (index = 0; index < 3; index++)
+	{
+		dt.millisecond = (uint16_t)index;
+
+		err = ujo_template_set_uint(tpl, seq, 4000000000u + index);
+		print_return_ujo_err(err,"ujo_template_set_uint"); 
+		err = ujo_template_set_float(tpl, temp, 21.5 + index);
+		print_return_ujo_err(err,"ujo_template_set_float"); 
+		err = ujo_template_set_bool(tpl, ok, (ujoBool)(index % 2));
+		print_return_ujo_err(err,"ujo_template_set_bool"); 
+		err = ujo_template_set_uint(tpl, level, 65535 - index);
+		print_return_ujo_err(err,"ujo_template_set_uint"); 
+		err = ujo_template_set_datetime(tpl, ts, dt);
+		print_return_ujo_err(err,"ujo_template_set_datetime"); 
+
+		err = ujo_template_get_buffer(tpl, &data, &datasize);
+		print_return_ujo_err(err,"ujo_template_get_buffer"); 
+
+		err = ujo_new_memory_writer(&ujow);
+		print_return_ujo_err(err,"ujo_new_memory_writer"); 
+		err = test13_reference(ujow, 4000000000u + index, (float32_t)(21.5 + index), (ujoBool)(index % 2), (uint16_t)(65535 - index), dt);
+		print_return_ujo_err(err,"test13_reference"); 
+		err = ujo_writer_get_buffer(ujow, &refdata, &refsize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+		if (index == 0)
+			print_buffer(data, datasize);
+
+		print_return_expr_fail(datasize == refsize && memcmp(data, refdata, datasize) == 0, "template message differs");
+
+		err = ujo_free_writer(ujow);
+		print_return_ujo_err(err,"ujo_free_writer"); 
+	}
+
+	err = ujo_free_template(tpl);
+	print_return_ujo_err(err,"ujo_free_template"); 
+
+	// a failed finish keeps nothing and can be repeated
+	set_counting_memory_functions(&counter);
+	err = ujo_new_template(&tpl);
+	if (err == UJO_SUCCESS) err = ujo_template_get_writer(tpl, &ujow);
+	if (err == UJO_SUCCESS) err = ujo_writer_list_open(ujow);
+	if (err == UJO_SUCCESS) err = ujo_template_add_slot(tpl, UJO_TYPE_UINT32, &seq);
+	if (err == UJO_SUCCESS) err = ujo_writer_list_close(ujow);
+	if (err == UJO_SUCCESS)
+	{
+		// the mask is allocated, the image is not
+		counter.failat = counter.allocs + 2;
+		err = ujo_template_finish(tpl);
+		counter.failat = 0;
+		if (err == UJO_ERR_ALLOCATION)
+			err = ujo_template_finish(tpl);
+		else
+			err = UJO_ERR_INVALID_DATA;
+		ujo_free_template(tpl);
+	}
+	set_counting_memory_functions(NULL);
+	print_return_ujo_err(err,"ujo_template_finish"); 
+	print_return_expr_fail(counter.allocs == counter.frees && counter.live == 0, "allocations not released");
+
+	return ujoTrue;
+};
@@ -0,0 +1,223 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include "ujo_template.h"
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+typedef struct {
+	uint32_t    seq;
+	float32_t   temp;
+	ujoBool     ok;
+	uint16_t    level;
+	ujoDateTime ts;
+} test14_frame;
+
+/* variants of the template document */
+typedef enum {
+	TEST14_NARROWED,
+	TEST14_OTHER_KEY,
+	TEST14_OTHER_FAMILY,
+	TEST14_OUT_OF_RANGE
+} test14_variant;
+
+static ujoError test14_document(ujo_writer* w, test14_variant variant, const ujoDateTime ts)
+{
+	ujoError err;
+
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "seq", 3));
+	if (variant == TEST14_OTHER_FAMILY) {
+		return_on_err(ujo_writer_add_int32(w, 7));
+	} else {
+		return_on_err(ujo_writer_add_uint_auto(w, 7));
+	}
+	if (variant == TEST14_OTHER_KEY) {
+		return_on_err(ujo_writer_add_string_c(w, "tmp", 3));
+	} else {
+		return_on_err(ujo_writer_add_string_c(w, "temp", 4));
+	}
+	return_on_err(ujo_writer_add_float16(w, 0.5f));
+	return_on_err(ujo_writer_add_string_c(w, "ok", 2));
+	return_on_err(ujo_writer_add_bool(w, ujoTrue));
+	return_on_err(ujo_writer_add_string_c(w, "level", 5));
+	if (variant == TEST14_OUT_OF_RANGE) {
+		return_on_err(ujo_writer_add_uint32(w, 70000));
+	} else {
+		return_on_err(ujo_writer_add_uint8(w, 3));
+	}
+	return_on_err(ujo_writer_add_string_c(w, "ts", 2));
+	return_on_err(ujo_writer_add_timestamp(w, ts));
+	return_on_err(ujo_writer_map_close(w));
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * test14: template matched decoding
+ */
+ujoBool test14()
+{
+	ujo_template*   tpl;
+	ujo_writer*		ujow;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte*		message;
+
+	ujoSlot         seq, temp, ok, level, ts;
+	ujoDateTime     dt = { 2015, 7, 2, 12, 30, 15, 250 };
+	test14_frame    frame;
+	int             variant;
+	alloc_counter   counter;
+
+	/* build the template */
+	err = ujo_new_template(&tpl);
+	print_return_ujo_err(err,"ujo_new_template"); 
+	err = ujo_template_get_writer(tpl, &ujow);
+	print_return_ujo_err(err,"ujo_template_get_writer"); 
+
+	err = ujo_writer_map_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_map_open"); 
+	err = ujo_writer_add_string_c(ujow, "seq", 3);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_UINT32, &seq);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_add_string_c(ujow, "temp", 4);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_FLOAT32, &temp);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_add_string_c(ujow, "ok", 2);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_BOOL, &ok);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_add_string_c(ujow, "level", 5);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_UINT16, &level);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_add_string_c(ujow, "ts", 2);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_template_add_slot(tpl, UJO_TYPE_TIMESTAMP, &ts);
+	print_return_ujo_err(err,"ujo_template_add_slot"); 
+	err = ujo_writer_map_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_map_close"); 
+
+	err = ujo_template_finish(tpl);
+	print_return_ujo_err(err,"ujo_template_finish"); 
+
+	err = ujo_template_bind_field(tpl, seq, offsetof(test14_frame, seq));
+	print_return_ujo_err(err,"ujo_template_bind_field"); 
+	err = ujo_template_bind_field(tpl, temp, offsetof(test14_frame, temp));
+	print_return_ujo_err(err,"ujo_template_bind_field"); 
+	err = ujo_template_bind_field(tpl, ok, offsetof(test14_frame, ok));
+	print_return_ujo_err(err,"ujo_template_bind_field"); 
+	err = ujo_template_bind_field(tpl, level, offsetof(test14_frame, level));
+	print_return_ujo_err(err,"ujo_template_bind_field"); 
+	err = ujo_template_bind_field(tpl, ts, offsetof(test14_frame, ts));
+	print_return_ujo_err(err,"ujo_template_bind_field"); 
+
+	/* a message produced by the template takes the fast path */
+	err = ujo_template_set_uint(tpl, seq, 123456789);
+	print_return_ujo_err(err,"ujo_template_set_uint"); 
+	err = ujo_template_set_float(tpl, temp, -12.25);
+	print_return_ujo_err(err,"ujo_template_set_float"); 
+	err = ujo_template_set_bool(tpl, ok, ujoTrue);
+	print_return_ujo_err(err,"ujo_template_set_bool"); 
+	err = ujo_template_set_uint(tpl, level, 4711);
+	print_return_ujo_err(err,"ujo_template_set_uint"); 
+	err = ujo_template_set_datetime(tpl, ts, dt);
+	print_return_ujo_err(err,"ujo_template_set_datetime"); 
+
+	err = ujo_template_get_buffer(tpl, &data, &datasize);
+	print_return_ujo_err(err,"ujo_template_get_buffer"); 
+
+	message = (ujoByte*)malloc(datasize);
+	memcpy(message, data, datasize);
+
+	memset(&frame, 0, sizeof(frame));
+	err = ujo_template_match(tpl, message, datasize, &frame);
+	print_return_ujo_err(err,"ujo_template_match"); 
+	free(message);
+
+	print_return_expr_fail(frame.seq == 123456789 && frame.temp == -12.25f && frame.ok == ujoTrue && 
+		frame.level == 4711, "fast path values differ");
+	print_return_expr_fail(frame.ts.year == 2015 && frame.ts.month == 7 && frame.ts.day == 2 &&
+		frame.ts.hour == 12 && frame.ts.minute == 30 && frame.ts.second == 15 && 
+		frame.ts.millisecond == 250, "fast path timestamp differs");
+
+	/* documents with a different encoding take the generic path */
+	for (variant = TEST14_NARROWED; variant <= TEST14_OUT_OF_RANGE; variant++)
+	{
+		err = ujo_new_memory_writer(&ujow);
+		print_return_ujo_err(err,"ujo_new_memory_writer"); 
+		err = test14_document(ujow, (test14_variant)variant, dt);
+		print_return_ujo_err(err,"test14_document"); 
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+		memset(&frame, 0, sizeof(frame));
+		err = ujo_template_match(tpl, data, datasize, &frame);
+
+		if (variant == TEST14_NARROWED)
+		{
+			print_return_ujo_err(err,"ujo_template_match"); 
+			print_return_expr_fail(frame.seq == 7 && frame.temp == 0.5f && frame.ok == ujoTrue && 
+				frame.level == 3 && frame.ts.millisecond == 250, "generic path values differ");
+
+			// the readers of the generic path are kept with the template
+			set_counting_memory_functions(&counter);
+			err = ujo_template_match(tpl, data, datasize, &frame);
+			set_counting_memory_functions(NULL);
+			print_return_ujo_err(err,"ujo_template_match"); 
+			print_return_expr_fail(counted_allocs(counter) == 0 && counter.frees == 0, "generic path allocates");
+		}
+		else
+		{
+			print_return_expr_fail(err == UJO_ERR_TEMPLATE_MISMATCH, "mismatch not detected");
+		}
+
+		err = ujo_free_writer(ujow);
+		print_return_ujo_err(err,"ujo_free_writer"); 
+	}
+
+	err = ujo_free_template(tpl);
+	print_return_ujo_err(err,"ujo_free_template"); 
+
+	return ujoTrue;
+};
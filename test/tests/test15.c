@@ -0,0 +1,121 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * test15: custom allocator
+ */
+ujoBool test15()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujo_element*	element;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoBool			eod;
+	uint8_t         bin[8000];
+	int             index;
+	uint32_t        elements = 0;
+
+	alloc_counter   counter;
+	ujoAllocator    allocator;
+
+	memset(bin, 0x5A, sizeof(bin));
+	init_counting_allocator(&allocator, &counter);
+
+	err = ujo_new_memory_writer_ex(&ujow, &allocator);
+	print_return_ujo_err(err,"ujo_new_memory_writer_ex"); 
+
+	// nested containers push states, the binary grows the buffer
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	for (index = 0; index < 4; index++)
+	{
+		err = ujo_writer_map_open(ujow);
+		print_return_ujo_err(err,"ujo_writer_map_open"); 
+		err = ujo_writer_add_string_c(ujow, "key", 3);
+		print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	}
+	err = ujo_writer_add_binary(ujow, UJO_SUB_BINARY_GENERIC, bin, sizeof(bin));
+	print_return_ujo_err(err,"ujo_writer_add_binary"); 
+	for (index = 0; index < 4; index++)
+	{
+		err = ujo_writer_map_close(ujow);
+		print_return_ujo_err(err,"ujo_writer_map_close"); 
+	}
+	err = ujo_writer_list_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_close"); 
+
+	print_return_expr_fail(counter.reallocs > 0, "buffer not resized by allocator");
+
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	err = ujo_new_memory_reader_ex(&ujor, &allocator);
+	print_return_ujo_err(err,"ujo_new_memory_reader_ex"); 
+	err = ujo_reader_set_buffer(ujor, data, datasize);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+
+	err = ujo_reader_get_first(ujor, &element, &eod);
+	print_return_ujo_err(err,"ujo_reader_get_first");
+	while (!eod)
+	{
+		elements++;
+		err = ujo_free_element(element);
+		print_return_ujo_err(err,"ujo_free_element");
+		err = ujo_reader_get_next(ujor, &element, &eod);
+		print_return_ujo_err(err,"ujo_reader_get_next");
+	}
+	print_return_expr_fail(elements == 15, "element count mismatch");
+
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	printf("%u allocations, %u reallocations, %u frees\n", counter.allocs, counter.reallocs, counter.frees);
+
+	// every block was allocated and released by the custom allocator
+	print_return_expr_fail(counter.foreign == 0, "block not allocated by the custom allocator");
+	print_return_expr_fail(counter.allocs == counter.frees && counter.live == 0, "allocation leaked");
+
+	return ujoTrue;
+};
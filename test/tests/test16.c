@@ -0,0 +1,144 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * test16: arena reader
+ */
+ujoBool test16()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujo_element*	elements[32];
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoBool			eod;
+	uint8_t         bin[3000];
+	char            key[8];
+	char*           s;
+	uint32_t        n;
+	uint8_t         t;
+	uint8_t*        d;
+	int             index;
+	int             count;
+	int             round;
+
+	alloc_counter   counter;
+	uint32_t        before;
+	ujoAllocator    allocator;
+
+	init_counting_allocator(&allocator, &counter);
+
+	memset(bin, 0xA5, sizeof(bin));
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	for (index = 0; index < 20; index++)
+	{
+		sprintf(key, "key%02d", index);
+		err = ujo_writer_add_string_c(ujow, key, strlen(key)+1);
+		print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	}
+	// larger than an arena block
+	err = ujo_writer_add_binary(ujow, UJO_SUB_BINARY_GENERIC, bin, sizeof(bin));
+	print_return_ujo_err(err,"ujo_writer_add_binary"); 
+	err = ujo_writer_list_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_close"); 
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	err = ujo_new_memory_reader_ex(&ujor, &allocator);
+	print_return_ujo_err(err,"ujo_new_memory_reader_ex"); 
+	err = ujo_reader_use_arena(ujor, 2048);
+	print_return_ujo_err(err,"ujo_reader_use_arena"); 
+
+	for (round = 0; round < 3; round++)
+	{
+		err = ujo_reader_set_buffer(ujor, data, datasize);
+		print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+
+		before = counted_allocs(counter);
+		count = 0;
+		err = ujo_reader_get_first(ujor, &elements[count], &eod);
+		print_return_ujo_err(err,"ujo_reader_get_first");
+		while (!eod)
+		{
+			print_return_expr_fail(count < 31, "too many elements");
+			err = ujo_reader_get_next(ujor, &elements[++count], &eod);
+			print_return_ujo_err(err,"ujo_reader_get_next");
+		}
+		print_return_expr_fail(count == 23, "element count mismatch");
+
+		// the arena blocks of the first document are reused
+		if (round > 0)
+			print_return_expr_fail(counted_allocs(counter) == before, "arena allocated new blocks");
+
+		// all elements stay valid until the arena is reset
+		for (index = 0; index < 20; index++)
+		{
+			sprintf(key, "key%02d", index);
+			err = ujo_element_get_string_c(elements[index+1], &s, &n);
+			print_return_ujo_err(err,"ujo_element_get_string_c");
+			print_return_expr_fail(strcmp(s, key) == 0, "string value differs");
+		}
+		err = ujo_element_get_binary(elements[21], &t, &d, &n);
+		print_return_ujo_err(err,"ujo_element_get_binary");
+		print_return_expr_fail(n == sizeof(bin) && memcmp(d, bin, n) == 0, "binary value differs");
+
+		for (index = 0; index < count; index++)
+		{
+			err = ujo_free_element(elements[index]);
+			print_return_ujo_err(err,"ujo_free_element");
+		}
+
+		err = ujo_reader_reset_arena(ujor);
+		print_return_ujo_err(err,"ujo_reader_reset_arena"); 
+	}
+
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
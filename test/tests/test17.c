@@ -0,0 +1,130 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static ujoError test17_message(ujo_writer* w, int32_t seq)
+{
+	ujoError err;
+
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "seq", 3));
+	return_on_err(ujo_writer_add_int32(w, seq));
+	return_on_err(ujo_writer_add_string_c(w, "values", 6));
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_add_float32(w, 1.5f));
+	return_on_err(ujo_writer_table_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "id", 2));
+	return_on_err(ujo_writer_table_end_columns(w));
+	return_on_err(ujo_writer_add_int8(w, (int8_t)seq));
+	return_on_err(ujo_writer_table_close(w));
+	return_on_err(ujo_writer_list_close(w));
+	return_on_err(ujo_writer_map_close(w));
+
+	return UJO_SUCCESS;
+}
+
+/**
+ * test17: writer reset
+ */
+ujoBool test17()
+{
+	ujo_writer*		ujow;
+	ujo_writer*		refw;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte*		refdata;
+	size_t			refsize;
+	int32_t         seq;
+
+	alloc_counter   counter;
+	uint32_t        before = 0;
+	ujoAllocator    allocator;
+
+	init_counting_allocator(&allocator, &counter);
+
+	err = ujo_new_memory_writer_ex(&ujow, &allocator);
+	print_return_ujo_err(err,"ujo_new_memory_writer_ex"); 
+
+	for (seq = 0; seq < 10; seq++)
+	{
+		err = ujo_writer_reset(ujow);
+		print_return_ujo_err(err,"ujo_writer_reset"); 
+
+		// an incomplete document is discarded by the reset
+		if (seq == 5)
+		{
+			err = ujo_writer_list_open(ujow);
+			print_return_ujo_err(err,"ujo_writer_list_open"); 
+			err = ujo_writer_map_open(ujow);
+			print_return_ujo_err(err,"ujo_writer_map_open"); 
+			err = ujo_writer_reset(ujow);
+			print_return_ujo_err(err,"ujo_writer_reset"); 
+		}
+
+		err = test17_message(ujow, seq);
+		print_return_ujo_err(err,"test17_message"); 
+
+		// the first message allocates all internal structures
+		if (seq == 0)
+			before = counted_allocs(counter);
+		print_return_expr_fail(counted_allocs(counter) == before, "reused writer allocated memory");
+
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+		err = ujo_new_memory_writer(&refw);
+		print_return_ujo_err(err,"ujo_new_memory_writer"); 
+		err = test17_message(refw, seq);
+		print_return_ujo_err(err,"test17_message"); 
+		err = ujo_writer_get_buffer(refw, &refdata, &refsize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+		print_return_expr_fail(datasize == refsize && memcmp(data, refdata, datasize) == 0, "reused writer output differs");
+
+		err = ujo_free_writer(refw);
+		print_return_ujo_err(err,"ujo_free_writer"); 
+	}
+
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
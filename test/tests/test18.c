@@ -0,0 +1,149 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static ujoError test18_read(ujo_reader* r, uint32_t* count)
+{
+	ujoError     err;
+	ujo_element* element;
+	ujoBool      eod;
+
+	*count = 0;
+	return_on_err(ujo_reader_get_first(r, &element, &eod));
+	while (!eod)
+	{
+		(*count)++;
+		return_on_err(ujo_free_element(element));
+		return_on_err(ujo_reader_get_next(r, &element, &eod));
+	}
+	return UJO_SUCCESS;
+}
+
+/**
+ * test18: reader reset
+ */
+ujoBool test18()
+{
+	ujo_writer*		ujow[3];
+	ujo_reader*		ujor;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	uint32_t        count;
+	uint32_t        again;
+	uint32_t        before = 0;
+	int             doc;
+	int             index;
+	int             round;
+
+	alloc_counter   counter;
+	ujoAllocator    allocator;
+
+	init_counting_allocator(&allocator, &counter);
+
+	/* documents of different size and depth */
+	for (doc = 0; doc < 3; doc++)
+	{
+		err = ujo_new_memory_writer(&ujow[doc]);
+		print_return_ujo_err(err,"ujo_new_memory_writer"); 
+		for (index = 0; index <= doc; index++)
+		{
+			err = ujo_writer_list_open(ujow[doc]);
+			print_return_ujo_err(err,"ujo_writer_list_open"); 
+		}
+		for (index = 0; index < (doc+1)*10; index++)
+		{
+			err = ujo_writer_add_string_c(ujow[doc], "value", 5);
+			print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+		}
+		for (index = 0; index <= doc; index++)
+		{
+			err = ujo_writer_list_close(ujow[doc]);
+			print_return_ujo_err(err,"ujo_writer_list_close"); 
+		}
+	}
+
+	err = ujo_new_memory_reader_ex(&ujor, &allocator);
+	print_return_ujo_err(err,"ujo_new_memory_reader_ex"); 
+	err = ujo_reader_use_arena(ujor, 0);
+	print_return_ujo_err(err,"ujo_reader_use_arena"); 
+
+	for (round = 0; round < 4; round++)
+	{
+		for (doc = 0; doc < 3; doc++)
+		{
+			err = ujo_writer_get_buffer(ujow[doc], &data, &datasize);
+			print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+			err = ujo_reader_set_buffer(ujor, data, datasize);
+			print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+
+			err = test18_read(ujor, &count);
+			print_return_ujo_err(err,"test18_read"); 
+			print_return_expr_fail(count == (uint32_t)((doc+1)*10 + (doc+1)*2), "element count mismatch");
+
+			// read the same document again
+			err = ujo_reader_reset(ujor);
+			print_return_ujo_err(err,"ujo_reader_reset"); 
+			err = test18_read(ujor, &again);
+			print_return_ujo_err(err,"test18_read"); 
+			print_return_expr_fail(again == count, "element count after reset mismatch");
+
+			err = ujo_reader_reset_arena(ujor);
+			print_return_ujo_err(err,"ujo_reader_reset_arena"); 
+		}
+
+		// after the first round the reader runs without allocation
+		if (round == 0)
+			before = counted_allocs(counter);
+		print_return_expr_fail(counted_allocs(counter) == before, "reused reader allocated memory");
+	}
+
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+	print_return_expr_fail(counter.live == 0, "reader memory leaked");
+
+	for (doc = 0; doc < 3; doc++)
+	{
+		err = ujo_free_writer(ujow[doc]);
+		print_return_ujo_err(err,"ujo_free_writer"); 
+	}
+
+	return ujoTrue;
+};
@@ -0,0 +1,135 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static ujoError test19_write(ujo_writer* w, int32_t value)
+{
+	ujoError err;
+
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "id", 2));
+	return_on_err(ujo_writer_add_int32(w, value));
+	return_on_err(ujo_writer_add_string_c(w, "name", 4));
+	return_on_err(ujo_writer_add_string_c(w, "detached", 8));
+	return_on_err(ujo_writer_map_close(w));
+	return UJO_SUCCESS;
+}
+
+/**
+ * test19: detach writer buffer
+ */
+ujoBool test19()
+{
+	ujo_writer*		ujow;
+	ujo_writer*		ref;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte*		refdata;
+	size_t			refsize;
+	ujoByte*		detached;
+	size_t			detachedsize;
+	ujoDestroyFunc  destroy;
+	int             round;
+
+	alloc_counter   counter;
+	ujoAllocator    allocator;
+
+	err = ujo_new_memory_writer(&ref);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = test19_write(ref, 42);
+	print_return_ujo_err(err,"test19_write"); 
+	err = ujo_writer_get_buffer(ref, &refdata, &refsize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	// the detached buffer is the writer buffer, not a copy
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	for (round = 0; round < 3; round++)
+	{
+		err = test19_write(ujow, 42);
+		print_return_ujo_err(err,"test19_write"); 
+		err = ujo_writer_shrink_to_fit(ujow);
+		print_return_ujo_err(err,"ujo_writer_shrink_to_fit"); 
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+		err = ujo_writer_detach_buffer(ujow, &detached, &detachedsize, &destroy);
+		print_return_ujo_err(err,"ujo_writer_detach_buffer"); 
+		print_return_expr_fail(detached == data, "detached buffer is a copy");
+		print_return_expr_fail(detachedsize == refsize, "detached size mismatch");
+		print_return_expr_fail(memcmp(detached, refdata, refsize) == 0, "detached content mismatch");
+		print_return_expr_fail(destroy != NULL, "missing destroy function");
+
+		// the writer starts over with a new buffer
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+		print_return_expr_fail(data != detached, "writer still holds detached buffer");
+		print_return_expr_fail(datasize == UJO_HEADER_SIZE, "writer not reset");
+
+		destroy(detached);
+	}
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	// with a custom allocator the buffer is released by the allocator
+	init_counting_allocator(&allocator, &counter);
+
+	err = ujo_new_memory_writer_ex(&ujow, &allocator);
+	print_return_ujo_err(err,"ujo_new_memory_writer_ex"); 
+	err = test19_write(ujow, 42);
+	print_return_ujo_err(err,"test19_write"); 
+	err = ujo_writer_detach_buffer(ujow, &detached, &detachedsize, &destroy);
+	print_return_ujo_err(err,"ujo_writer_detach_buffer"); 
+	print_return_expr_fail(destroy == NULL, "unexpected destroy function");
+	print_return_expr_fail(memcmp(detached, refdata, refsize) == 0, "detached content mismatch");
+
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+	print_return_expr_fail(counter.live > 0, "detached buffer released by writer");
+	allocator.free(allocator.user, detached);
+	print_return_expr_fail(counter.live == 0, "writer memory leaked");
+
+	err = ujo_free_writer(ref);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
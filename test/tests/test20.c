@@ -0,0 +1,122 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * test20: fixed writer
+ */
+ujoBool test20()
+{
+	ujo_writer*		ujow;
+	ujo_writer*		ref;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte			fixed[32];
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte*		refdata;
+	size_t			refsize;
+	int32_t			index;
+	int             round;
+
+	// the header has to fit
+	err = ujo_new_fixed_writer(&ujow, fixed, UJO_HEADER_SIZE-1);
+	print_return_expr_fail(err == UJO_ERR_BUFFER_FULL, "header exceeds buffer");
+
+	err = ujo_new_memory_writer(&ref);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_writer_list_open(ref);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	for (index = 0; index < 4; index++)
+	{
+		err = ujo_writer_add_int32(ref, index);
+		print_return_ujo_err(err,"ujo_writer_add_int32"); 
+	}
+	err = ujo_writer_list_close(ref);
+	print_return_ujo_err(err,"ujo_writer_list_close"); 
+	err = ujo_writer_get_buffer(ref, &refdata, &refsize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	err = ujo_new_fixed_writer(&ujow, fixed, sizeof(fixed));
+	print_return_ujo_err(err,"ujo_new_fixed_writer"); 
+
+	for (round = 0; round < 2; round++)
+	{
+		err = ujo_writer_list_open(ujow);
+		print_return_ujo_err(err,"ujo_writer_list_open"); 
+
+		// fill the buffer until it is full
+		index = 0;
+		while ((err = ujo_writer_add_int32(ujow, index)) == UJO_SUCCESS)
+			index++;
+		print_return_expr_fail(err == UJO_ERR_BUFFER_FULL, "buffer full expected");
+		print_return_expr_fail(index == 4, "unexpected number of values");
+
+		// a partially written value is dropped
+		err = ujo_writer_add_string_c(ujow, "does not fit", 12);
+		print_return_expr_fail(err == UJO_ERR_BUFFER_FULL, "buffer full expected");
+
+		// the document is still valid and can be closed
+		err = ujo_writer_list_close(ujow);
+		print_return_ujo_err(err,"ujo_writer_list_close"); 
+
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+		print_return_expr_fail(data == fixed, "writer does not use caller buffer");
+		print_return_expr_fail(datasize == refsize, "document size mismatch");
+		print_return_expr_fail(memcmp(data, refdata, refsize) == 0, "document content mismatch");
+
+		err = ujo_writer_add_int32(ujow, index);
+		print_return_expr_fail(err == UJO_ERR_TYPE_MISPLACED, "value after end of document");
+
+		err = ujo_writer_reset(ujow);
+		print_return_ujo_err(err,"ujo_writer_reset"); 
+	}
+
+	err = ujo_writer_shrink_to_fit(ujow);
+	print_return_expr_fail(err == UJO_ERR_INVALID_OBJECT, "fixed buffer resized");
+
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+	err = ujo_free_writer(ref);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
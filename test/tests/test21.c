@@ -0,0 +1,145 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static ujoError test21_write(ujo_writer* w)
+{
+	ujoError err;
+	int32_t  index;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (index = 0; index < 100; index++)
+	{
+		return_on_err(ujo_writer_add_int32(w, index));
+		return_on_err(ujo_writer_add_string_c(w, "segment", 7));
+	}
+	return_on_err(ujo_writer_list_close(w));
+	return UJO_SUCCESS;
+}
+
+/**
+ * test21: segmented writer
+ */
+ujoBool test21()
+{
+	ujo_writer*		ujow;
+	ujo_writer*		ref;
+	ujoError		err = UJO_SUCCESS;
+
+	const ujoIovec*	iov;
+	size_t			count;
+	size_t			firstcount = 0;
+	size_t			index;
+	size_t			offset;
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte*		refdata;
+	size_t			refsize;
+	int             round;
+
+	err = ujo_new_memory_writer(&ref);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = test21_write(ref);
+	print_return_ujo_err(err,"test21_write"); 
+	err = ujo_writer_get_buffer(ref, &refdata, &refsize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	// a contiguous writer is a single piece
+	err = ujo_writer_get_iovecs(ref, &iov, &count);
+	print_return_ujo_err(err,"ujo_writer_get_iovecs"); 
+	print_return_expr_fail(count == 1 && iov[0].base == refdata && iov[0].len == refsize, "single piece mismatch");
+
+	err = ujo_new_segmented_writer(&ujow, 64, NULL);
+	print_return_ujo_err(err,"ujo_new_segmented_writer"); 
+
+	for (round = 0; round < 2; round++)
+	{
+		err = test21_write(ujow);
+		print_return_ujo_err(err,"test21_write"); 
+
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_expr_fail(err == UJO_ERR_INVALID_OBJECT, "segmented buffer is not contiguous");
+
+		err = ujo_writer_get_iovecs(ujow, &iov, &count);
+		print_return_ujo_err(err,"ujo_writer_get_iovecs"); 
+		print_return_expr_fail(count == (refsize + 63) / 64, "segment count mismatch");
+		if (round == 0)
+			firstcount = count;
+		print_return_expr_fail(count == firstcount, "segments not reused");
+
+		for (offset = 0, index = 0; index < count; index++)
+		{
+			print_return_expr_fail(offset + iov[index].len <= refsize, "segments exceed document");
+			print_return_expr_fail(memcmp(iov[index].base, refdata + offset, iov[index].len) == 0, "segment content mismatch");
+			offset += iov[index].len;
+		}
+		print_return_expr_fail(offset == refsize, "segment size mismatch");
+
+		err = ujo_writer_reset(ujow);
+		print_return_ujo_err(err,"ujo_writer_reset"); 
+	}
+
+	// join the segments
+	err = test21_write(ujow);
+	print_return_ujo_err(err,"test21_write"); 
+	err = ujo_writer_flatten(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_flatten"); 
+	print_return_expr_fail(datasize == refsize && memcmp(data, refdata, refsize) == 0, "flattened content mismatch");
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	print_return_expr_fail(datasize == refsize && memcmp(data, refdata, refsize) == 0, "flattened buffer mismatch");
+
+	// the flattened segment keeps the header for the next document
+	err = ujo_writer_reset(ujow);
+	print_return_ujo_err(err,"ujo_writer_reset"); 
+	err = test21_write(ujow);
+	print_return_ujo_err(err,"test21_write"); 
+	err = ujo_writer_get_iovecs(ujow, &iov, &count);
+	print_return_ujo_err(err,"ujo_writer_get_iovecs"); 
+	print_return_expr_fail(count == 1 && iov[0].len == refsize, "flattened segment not reused");
+	print_return_expr_fail(memcmp(iov[0].base, refdata, refsize) == 0, "document content mismatch");
+
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+	err = ujo_free_writer(ref);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
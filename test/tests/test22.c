@@ -0,0 +1,196 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+	int64_t   sum;
+	uint32_t  strings;
+	uint32_t  views;
+} test22_result;
+
+/* data between first and last is a view on the input */
+static ujoError test22_read(ujo_reader* r, const ujoByte* first, const ujoByte* last, test22_result* result)
+{
+	ujoError     err;
+	ujo_element* element;
+	ujoBool      eod;
+	ujoTypeId    type;
+	int64_t      value;
+	char*        s;
+	uint8_t*     data;
+	uint8_t      subtype;
+	uint32_t     n;
+	uint32_t     index;
+
+	memset(result, 0, sizeof(test22_result));
+	return_on_err(ujo_reader_get_first(r, &element, &eod));
+	while (!eod)
+	{
+		return_on_err(ujo_element_get_type(element, &type));
+		switch (type)
+		{
+		case UJO_TYPE_INT64:
+			return_on_err(ujo_element_get_int64(element, &value));
+			result->sum += value;
+			break;
+		case UJO_TYPE_STRING:
+			return_on_err(ujo_element_get_string_c(element, &s, &n));
+			if (n != 12 || strcmp(s, "hello world") != 0)
+				return UJO_ERR_INVALID_DATA;
+			data = (uint8_t*)s;
+			break;
+		case UJO_TYPE_BIN:
+			return_on_err(ujo_element_get_binary(element, &subtype, &data, &n));
+			for (index = 0; index < n; index++)
+				if (data[index] != (uint8_t)index)
+					return UJO_ERR_INVALID_DATA;
+			break;
+		default:
+			data = NULL;
+			break;
+		}
+		if (type == UJO_TYPE_STRING || type == UJO_TYPE_BIN)
+		{
+			result->strings++;
+			if (data >= first && data < last)
+				result->views++;
+		}
+		return_on_err(ujo_free_element(element));
+		return_on_err(ujo_reader_get_next(r, &element, &eod));
+	}
+	return UJO_SUCCESS;
+}
+
+/**
+ * test22: scattered reader
+ */
+ujoBool test22()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoIovec		iov[4096];
+	size_t			count;
+	size_t			offset;
+	size_t			piece;
+	uint8_t			binary[100];
+	int64_t         index;
+
+	test22_result   expected;
+	test22_result   result;
+
+	for (index = 0; index < 100; index++)
+		binary[index] = (uint8_t)index;
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	for (index = 0; index < 20; index++)
+	{
+		err = ujo_writer_add_int64(ujow, index * 1000);
+		print_return_ujo_err(err,"ujo_writer_add_int64"); 
+		err = ujo_writer_add_string_c(ujow, "hello world", 11);
+		print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+		err = ujo_writer_add_binary(ujow, 0, binary, sizeof(binary));
+		print_return_ujo_err(err,"ujo_writer_add_binary"); 
+	}
+	err = ujo_writer_list_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_close"); 
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+
+	// contiguous copy as reference
+	err = ujo_reader_set_buffer(ujor, data, datasize);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+	err = test22_read(ujor, data, data + datasize, &expected);
+	print_return_ujo_err(err,"test22_read"); 
+	print_return_expr_fail(expected.strings == 40 && expected.sum == 190000, "reference mismatch");
+	print_return_expr_fail(expected.views == 0, "buffer reader returned views");
+
+	// a single segment returns views on the input
+	iov[0].base = data;
+	iov[0].len  = datasize;
+	err = ujo_reader_set_iovecs(ujor, iov, 1);
+	print_return_ujo_err(err,"ujo_reader_set_iovecs"); 
+	err = test22_read(ujor, data, data + datasize, &result);
+	print_return_ujo_err(err,"test22_read"); 
+	print_return_expr_fail(result.sum == expected.sum && result.strings == expected.strings, "single segment mismatch");
+	print_return_expr_fail(result.views == result.strings, "no views returned");
+
+	// pieces of growing size, values straddle the boundaries
+	for (piece = 1; piece < 40; piece += 7)
+	{
+		for (count = 0, offset = 0; offset < datasize; count++)
+		{
+			iov[count].base = data + offset;
+			iov[count].len  = (datasize - offset < piece + count % 3) ? datasize - offset : piece + count % 3;
+			offset += iov[count].len;
+		}
+
+		err = ujo_reader_set_iovecs(ujor, iov, count);
+		print_return_ujo_err(err,"ujo_reader_set_iovecs"); 
+		err = test22_read(ujor, data, data + datasize, &result);
+		print_return_ujo_err(err,"test22_read"); 
+		print_return_expr_fail(result.sum == expected.sum && result.strings == expected.strings, "scattered content mismatch");
+		print_return_expr_fail(result.views < result.strings || piece > 106, "values straddle segments");
+	}
+
+	// truncated segments are detected
+	iov[0].base = data;
+	iov[0].len  = datasize / 2;
+	err = ujo_reader_set_iovecs(ujor, iov, 1);
+	print_return_ujo_err(err,"ujo_reader_set_iovecs"); 
+	err = test22_read(ujor, data, data + datasize, &result);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "truncated document accepted");
+
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
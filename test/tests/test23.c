@@ -0,0 +1,182 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST23_PAYLOAD 100000
+
+static ujoError test23_write(ujo_writer* w, const uint8_t* payload, ujoBool ref)
+{
+	ujoError err;
+	int32_t  index;
+
+	return_on_err(ujo_writer_list_open(w));
+	for (index = 0; index < 3; index++)
+	{
+		return_on_err(ujo_writer_add_int32(w, index));
+		if (ref)
+			err = ujo_writer_add_binary_ref(w, 1, payload + index, TEST23_PAYLOAD - index);
+		else
+			err = ujo_writer_add_binary(w, 1, payload + index, TEST23_PAYLOAD - index);
+		if (err != UJO_SUCCESS)
+			return err;
+	}
+	return_on_err(ujo_writer_add_string_c(w, "end", 3));
+	return_on_err(ujo_writer_list_close(w));
+	return UJO_SUCCESS;
+}
+
+/**
+ * test23: binary references
+ */
+ujoBool test23()
+{
+	ujo_writer*		ujow;
+	ujo_writer*		ref;
+	ujo_reader*		ujor;
+	ujo_element*	element;
+	ujoError		err = UJO_SUCCESS;
+
+	uint8_t*		payload;
+	const ujoIovec*	iov;
+	size_t			count;
+	size_t			index;
+	size_t			total;
+	size_t			refs;
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte*		refdata;
+	size_t			refsize;
+	ujoBool			eod;
+	ujoTypeId		type;
+	uint8_t			subtype;
+	uint8_t*		bin;
+	uint32_t		n;
+	int             round;
+
+	payload = (uint8_t*)malloc(TEST23_PAYLOAD);
+	print_return_expr_fail(payload, "allocation failed");
+	for (index = 0; index < TEST23_PAYLOAD; index++)
+		payload[index] = (uint8_t)(index * 7);
+
+	err = ujo_new_memory_writer(&ref);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = test23_write(ref, payload, ujoFalse);
+	print_return_ujo_err(err,"test23_write"); 
+	err = ujo_writer_get_buffer(ref, &refdata, &refsize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	// references need a writer with pieces
+	err = ujo_writer_reset(ref);
+	print_return_ujo_err(err,"ujo_writer_reset"); 
+	err = test23_write(ref, payload, ujoTrue);
+	print_return_expr_fail(err == UJO_ERR_INVALID_OBJECT, "reference in contiguous writer");
+	err = ujo_writer_reset(ref);
+	print_return_ujo_err(err,"ujo_writer_reset"); 
+	err = test23_write(ref, payload, ujoFalse);
+	print_return_ujo_err(err,"test23_write"); 
+
+	err = ujo_new_segmented_writer(&ujow, 0, NULL);
+	print_return_ujo_err(err,"ujo_new_segmented_writer"); 
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+
+	for (round = 0; round < 2; round++)
+	{
+		err = test23_write(ujow, payload, ujoTrue);
+		print_return_ujo_err(err,"test23_write"); 
+
+		// the payload is a piece of its own, all data matches the copying writer
+		err = ujo_writer_get_iovecs(ujow, &iov, &count);
+		print_return_ujo_err(err,"ujo_writer_get_iovecs"); 
+		print_return_expr_fail(count == 7, "piece count mismatch");
+		for (total = 0, refs = 0, index = 0; index < count; index++)
+		{
+			if (iov[index].base >= payload && iov[index].base < payload + TEST23_PAYLOAD)
+				refs++;
+			print_return_expr_fail(total + iov[index].len <= refsize, "pieces exceed document");
+			print_return_expr_fail(memcmp(iov[index].base, refdata + total, iov[index].len) == 0, "piece content mismatch");
+			total += iov[index].len;
+		}
+		print_return_expr_fail(refs == 3 && total == refsize, "references mismatch");
+
+		// the reader returns views on the referenced payload
+		err = ujo_reader_set_iovecs(ujor, iov, count);
+		print_return_ujo_err(err,"ujo_reader_set_iovecs"); 
+		err = ujo_reader_get_first(ujor, &element, &eod);
+		print_return_ujo_err(err,"ujo_reader_get_first"); 
+		for (refs = 0; !eod; )
+		{
+			err = ujo_element_get_type(element, &type);
+			print_return_ujo_err(err,"ujo_element_get_type"); 
+			if (type == UJO_TYPE_BIN)
+			{
+				err = ujo_element_get_binary(element, &subtype, &bin, &n);
+				print_return_ujo_err(err,"ujo_element_get_binary"); 
+				print_return_expr_fail(bin == payload + refs && n == TEST23_PAYLOAD - refs, "binary view mismatch");
+				refs++;
+			}
+			err = ujo_free_element(element);
+			print_return_ujo_err(err,"ujo_free_element"); 
+			err = ujo_reader_get_next(ujor, &element, &eod);
+			print_return_ujo_err(err,"ujo_reader_get_next"); 
+		}
+		print_return_expr_fail(refs == 3, "binary count mismatch");
+
+		err = ujo_writer_reset(ujow);
+		print_return_ujo_err(err,"ujo_writer_reset"); 
+	}
+
+	// flatten copies the referenced payload
+	err = test23_write(ujow, payload, ujoTrue);
+	print_return_ujo_err(err,"test23_write"); 
+	err = ujo_writer_flatten(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_flatten"); 
+	print_return_expr_fail(datasize == refsize && memcmp(data, refdata, refsize) == 0, "flattened content mismatch");
+
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+	err = ujo_free_writer(ref);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+	free(payload);
+
+	return ujoTrue;
+};
@@ -0,0 +1,204 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST24_SIZE  100000
+#define TEST24_CHUNK 777
+
+typedef struct {
+	uint32_t  next;
+	uint32_t  chunks;
+	uint32_t  largest;
+	ujoBool   valid;
+} test24_state;
+
+static ujoError test24_on_chunk(uint8_t type, const uint8_t* chunk, uint32_t n, uint32_t offset, uint32_t total, ujoPointer data)
+{
+	test24_state* s = (test24_state*)data;
+	uint32_t      index;
+
+	if (type != 3 || total != TEST24_SIZE || offset != s->next)
+		s->valid = ujoFalse;
+	for (index = 0; index < n; index++)
+		if (chunk[index] != (uint8_t)((offset + index) * 13))
+			s->valid = ujoFalse;
+	if (n > s->largest)
+		s->largest = n;
+	s->next += n;
+	s->chunks++;
+	return UJO_SUCCESS;
+}
+
+static ujoError test24_write(ujo_writer* w)
+{
+	ujoError err;
+	uint8_t  chunk[TEST24_CHUNK];
+	uint32_t offset;
+	uint32_t count;
+	uint32_t index;
+
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_add_int32(w, 1));
+	return_on_err(ujo_writer_binary_begin(w, 3, TEST24_SIZE));
+	for (offset = 0; offset < TEST24_SIZE; offset += count)
+	{
+		count = (TEST24_SIZE - offset < TEST24_CHUNK) ? TEST24_SIZE - offset : TEST24_CHUNK;
+		for (index = 0; index < count; index++)
+			chunk[index] = (uint8_t)((offset + index) * 13);
+		return_on_err(ujo_writer_binary_append(w, chunk, count));
+	}
+	return_on_err(ujo_writer_binary_end(w));
+	return_on_err(ujo_writer_add_string_c(w, "end", 3));
+	return_on_err(ujo_writer_list_close(w));
+	return UJO_SUCCESS;
+}
+
+static ujoError test24_read(ujo_reader* r, test24_state* s, uint32_t chunksize)
+{
+	ujoError     err;
+	ujo_element* element;
+	ujoBool      eod;
+	ujoTypeId    type;
+	uint8_t      subtype;
+	uint8_t*     data;
+	uint32_t     n;
+	uint32_t     count = 0;
+
+	memset(s, 0, sizeof(test24_state));
+	s->valid = ujoTrue;
+	return_on_err(ujo_reader_set_on_binary_chunk(r, test24_on_chunk, s, chunksize));
+
+	return_on_err(ujo_reader_get_first(r, &element, &eod));
+	while (!eod)
+	{
+		return_on_err(ujo_element_get_type(element, &type));
+		if (type == UJO_TYPE_BIN)
+		{
+			// all chunks are delivered before the element
+			return_on_err(ujo_element_get_binary(element, &subtype, &data, &n));
+			if (data != NULL || n != TEST24_SIZE || subtype != 3 || s->next != TEST24_SIZE)
+				s->valid = ujoFalse;
+		}
+		count++;
+		return_on_err(ujo_free_element(element));
+		return_on_err(ujo_reader_get_next(r, &element, &eod));
+	}
+	if (count != 5)
+		s->valid = ujoFalse;
+	return UJO_SUCCESS;
+}
+
+/**
+ * test24: chunked binary
+ */
+ujoBool test24()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	uint8_t			chunk[4] = {0, 1, 2, 3};
+	test24_state    state;
+
+	// misuse of the chunk functions
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	err = ujo_writer_binary_append(ujow, chunk, 4);
+	print_return_expr_fail(err == UJO_ERR_INVALID_OBJECT, "append without binary");
+	err = ujo_writer_binary_begin(ujow, 3, 6);
+	print_return_ujo_err(err,"ujo_writer_binary_begin"); 
+	err = ujo_writer_add_int32(ujow, 1);
+	print_return_expr_fail(err == UJO_ERR_TYPE_MISPLACED, "value inside binary");
+	err = ujo_writer_list_close(ujow);
+	print_return_expr_fail(err == UJO_ERR_INVALID_OBJECT, "close inside binary");
+	err = ujo_writer_binary_append(ujow, chunk, 4);
+	print_return_ujo_err(err,"ujo_writer_binary_append"); 
+	err = ujo_writer_binary_append(ujow, chunk, 4);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "binary exceeds size");
+	err = ujo_writer_binary_end(ujow);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "incomplete binary");
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	// file
+	err = ujo_new_file_writer(&ujow, "./test24.ujo");
+	print_return_ujo_err(err,"ujo_new_file_writer"); 
+	err = test24_write(ujow);
+	print_return_ujo_err(err,"test24_write"); 
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	err = ujo_new_file_reader(&ujor, "./test24.ujo");
+	print_return_ujo_err(err,"ujo_new_file_reader"); 
+	err = test24_read(ujor, &state, 1000);
+	print_return_ujo_err(err,"test24_read"); 
+	print_return_expr_fail(state.valid, "file chunks mismatch");
+	print_return_expr_fail(state.chunks == 100 && state.largest == 1000, "file chunk size mismatch");
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+
+	// memory
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = test24_write(ujow);
+	print_return_ujo_err(err,"test24_write"); 
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+	err = ujo_reader_set_buffer(ujor, data, datasize);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+	err = test24_read(ujor, &state, 0);
+	print_return_ujo_err(err,"test24_read"); 
+	print_return_expr_fail(state.valid, "memory chunks mismatch");
+	print_return_expr_fail(state.largest == UJO_DEFAULT_BUFSIZE, "memory chunk size mismatch");
+
+	err = ujo_free_reader(ujor);
+	print_return_ujo_err(err,"ujo_free_reader"); 
+	err = ujo_free_writer(ujow);
+	print_return_ujo_err(err,"ujo_free_writer"); 
+
+	return ujoTrue;
+};
@@ -0,0 +1,185 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ujo_corpus.h"
+
+#define TEST25_SMALL  100
+#define TEST25_LARGE  200000
+#define TEST25_SLACK  70000
+
+/**
+ * Read all elements of a document and count them.
+ */
+static ujoError test25_read(ujoByte* data, size_t bytes, size_t* count)
+{
+	ujo_reader*  r;
+	ujo_element* e;
+	ujoError     err;
+	ujoBool      eod;
+
+	*count = 0;
+	return_on_err(ujo_new_memory_reader(&r));
+	err = ujo_reader_set_buffer(r, data, bytes);
+	if (err == UJO_SUCCESS)
+		err = ujo_reader_get_first(r, &e, &eod);
+	while (err == UJO_SUCCESS && !eod)
+	{
+		ujo_free_element(e);
+		(*count)++;
+		err = ujo_reader_get_next(r, &e, &eod);
+	}
+	ujo_free_reader(r);
+	return err;
+}
+
+/**
+ * Read a whole file.
+ */
+static ujoByte* test25_load(const char* filename, size_t* bytes)
+{
+	FILE*    f = fopen(filename, "rb");
+	ujoByte* data;
+	long     size;
+
+	if (f == NULL) return NULL;
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	data = (ujoByte*)malloc(size);
+	if (data != NULL && fread(data, 1, size, f) != (size_t)size)
+	{
+		free(data);
+		data = NULL;
+	}
+	fclose(f);
+	*bytes = (size_t)size;
+	return data;
+}
+
+/**
+ * test25: corpus generator
+ */
+ujoBool test25()
+{
+	ujo_writer*		ujow;
+	ujo_writer*		other;
+	ujo_writer*		segw;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoCorpusKind	kind;
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte*		otherdata;
+	size_t			othersize;
+	ujoByte*		flat;
+	size_t			flatsize;
+	ujoByte*		filedata;
+	size_t			filesize;
+	size_t			count;
+
+	err = ujo_corpus_get_kind("status", &kind);
+	print_return_expr_fail(err == UJO_SUCCESS && kind == UJO_CORPUS_STATUS, "kind by name");
+	err = ujo_corpus_get_kind("nothing", &kind);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "unknown kind accepted");
+
+	for (kind = UJO_CORPUS_TELEMETRY; kind <= UJO_CORPUS_CONFIG; kind++)
+	{
+		// the same seed always results in the same document
+		err = ujo_new_memory_writer(&ujow);
+		print_return_ujo_err(err,"ujo_new_memory_writer"); 
+		err = ujo_new_memory_writer(&other);
+		print_return_ujo_err(err,"ujo_new_memory_writer"); 
+
+		err = ujo_corpus_write(ujow, kind, 42, TEST25_SMALL);
+		print_return_ujo_err(err,"ujo_corpus_write"); 
+		err = ujo_corpus_write(other, kind, 42, TEST25_SMALL);
+		print_return_ujo_err(err,"ujo_corpus_write"); 
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+		err = ujo_writer_get_buffer(other, &otherdata, &othersize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+		print_return_expr_fail(datasize >= TEST25_SMALL, "small document too short");
+		print_return_expr_fail(datasize == othersize && memcmp(data, otherdata, datasize) == 0, "same seed differs");
+
+		// another seed results in another document
+		err = ujo_writer_reset(other);
+		print_return_ujo_err(err,"ujo_writer_reset"); 
+		err = ujo_corpus_write(other, kind, 43, TEST25_SMALL);
+		print_return_ujo_err(err,"ujo_corpus_write"); 
+		err = ujo_writer_get_buffer(other, &otherdata, &othersize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+		print_return_expr_fail(datasize != othersize || memcmp(data, otherdata, datasize) != 0, "other seed equal");
+
+		// large documents end close to the requested size
+		err = ujo_writer_reset(ujow);
+		print_return_ujo_err(err,"ujo_writer_reset"); 
+		err = ujo_corpus_write(ujow, kind, 7, TEST25_LARGE);
+		print_return_ujo_err(err,"ujo_corpus_write"); 
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+		print_return_expr_fail(datasize >= TEST25_LARGE && datasize < TEST25_LARGE + TEST25_SLACK, "size mismatch");
+
+		err = test25_read(data, datasize, &count);
+		print_return_ujo_err(err,"test25_read"); 
+		print_return_expr_fail(count > 2, "document empty");
+
+		// segmented and file writers produce the same octets
+		err = ujo_new_segmented_writer(&segw, 0, NULL);
+		print_return_ujo_err(err,"ujo_new_segmented_writer"); 
+		err = ujo_corpus_write(segw, kind, 7, TEST25_LARGE);
+		print_return_ujo_err(err,"ujo_corpus_write"); 
+		err = ujo_writer_flatten(segw, &flat, &flatsize);
+		print_return_ujo_err(err,"ujo_writer_flatten"); 
+		print_return_expr_fail(flatsize == datasize && memcmp(flat, data, datasize) == 0, "segmented document differs");
+
+		err = ujo_corpus_write_file("./test25.ujo", kind, 7, TEST25_LARGE);
+		print_return_ujo_err(err,"ujo_corpus_write_file"); 
+		filedata = test25_load("./test25.ujo", &filesize);
+		print_return_expr_fail(filedata, "cannot read file");
+		print_return_expr_fail(filesize == datasize && memcmp(filedata, data, datasize) == 0, "file document differs");
+		free(filedata);
+
+		ujo_free_writer(segw);
+		ujo_free_writer(other);
+		ujo_free_writer(ujow);
+	}
+
+	return ujoTrue;
+}
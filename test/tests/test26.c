@@ -0,0 +1,211 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST26_ENTRIES  10000
+#define TEST26_BINARY   (1024*1024)
+
+/*
+ * Upper limits of allocations for canonical operations. Lower them when
+ * an operation improves, a higher count is a regression.
+ */
+#define TEST26_MAP_ALLOCS        33
+#define TEST26_PARSE_ALLOCS      25
+#define TEST26_BINARY_ALLOCS      8
+#define TEST26_REUSE_ALLOCS       0
+#define TEST26_ARENA_ALLOCS       0
+
+static ujoError test26_on_element(ujo_element* e, ujoPointer data)
+{
+	(*(size_t*)data)++;
+	return UJO_SUCCESS;
+}
+
+/**
+ * Write the document of test05.
+ */
+static ujoError test26_write_nested(ujo_writer* w)
+{
+	ujoError err;
+
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_add_int64(w, 12345678));
+	return_on_err(ujo_writer_add_float16(w, (float32_t)1));
+	return_on_err(ujo_writer_add_float32(w, (float32_t)3.14));
+	return_on_err(ujo_writer_add_float64(w, 9.81));
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_int64(w, 42));
+	return_on_err(ujo_writer_add_int16(w, 102));
+	return_on_err(ujo_writer_add_int8(w, 21));
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_add_bool(w, ujoTrue));
+	return_on_err(ujo_writer_add_none(w));
+	return_on_err(ujo_writer_list_close(w));
+	return_on_err(ujo_writer_map_close(w));
+	return ujo_writer_list_close(w);
+}
+
+/**
+ * Read all elements with the iterator functions.
+ */
+static ujoError test26_read_all(ujo_reader* r, size_t* count)
+{
+	ujo_element* e;
+	ujoError     err;
+	ujoBool      eod;
+
+	*count = 0;
+	err = ujo_reader_get_first(r, &e, &eod);
+	while (err == UJO_SUCCESS && !eod)
+	{
+		ujo_free_element(e);
+		(*count)++;
+		err = ujo_reader_get_next(r, &e, &eod);
+	}
+	return err;
+}
+
+static ujoBool test26_check(const char* operation, size_t allocs, size_t limit)
+{
+	printf("%s: %u allocations (limit %u)\n", operation, (unsigned)allocs, (unsigned)limit);
+	return allocs <= limit;
+}
+
+/**
+ * test26: allocation counts
+ */
+ujoBool test26()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	uint8_t*		payload;
+	size_t			count;
+	size_t			before;
+	uint32_t		i;
+	ujoBool			ok;
+	alloc_counter	counter;
+
+	payload = (uint8_t*)calloc(1, TEST26_BINARY);
+	print_return_expr_fail(payload, "allocation failed");
+
+	set_counting_memory_functions(&counter);
+
+	// writing a map with 10k entries, the buffer grows as needed
+	err = ujo_new_memory_writer(&ujow);
+	if (err == UJO_SUCCESS) err = ujo_writer_map_open(ujow);
+	for (i = 0; i < TEST26_ENTRIES && err == UJO_SUCCESS; i++)
+	{
+		err = ujo_writer_add_uint32(ujow, i);
+		if (err == UJO_SUCCESS) err = ujo_writer_add_int32(ujow, -(int32_t)i);
+	}
+	if (err == UJO_SUCCESS) err = ujo_writer_map_close(ujow);
+	ok = test26_check("write 10k map", counted_allocs(counter), TEST26_MAP_ALLOCS);
+
+	// writing the same map again after a reset reuses the buffer
+	before = counted_allocs(counter);
+	if (err == UJO_SUCCESS) err = ujo_writer_reset(ujow);
+	if (err == UJO_SUCCESS) err = ujo_writer_map_open(ujow);
+	for (i = 0; i < TEST26_ENTRIES && err == UJO_SUCCESS; i++)
+	{
+		err = ujo_writer_add_uint32(ujow, i);
+		if (err == UJO_SUCCESS) err = ujo_writer_add_int32(ujow, -(int32_t)i);
+	}
+	if (err == UJO_SUCCESS) err = ujo_writer_map_close(ujow);
+	ok = test26_check("rewrite 10k map", counted_allocs(counter) - before, TEST26_REUSE_ALLOCS) && ok;
+	ujo_free_writer(ujow);
+
+	// parsing the document of test05 with a callback
+	if (err == UJO_SUCCESS) err = ujo_new_memory_writer(&ujow);
+	if (err == UJO_SUCCESS) err = test26_write_nested(ujow);
+	if (err == UJO_SUCCESS) err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	if (err == UJO_SUCCESS) err = ujo_new_memory_reader(&ujor);
+	if (err == UJO_SUCCESS)
+	{
+		before = counted_allocs(counter);
+		count = 0;
+		err = ujo_reader_set_buffer(ujor, data, datasize);
+		if (err == UJO_SUCCESS) err = ujo_reader_set_on_element(ujor, test26_on_element, &count);
+		if (err == UJO_SUCCESS) err = ujo_reader_parse(ujor);
+		ok = test26_check("parse test05 document", counted_allocs(counter) - before, TEST26_PARSE_ALLOCS) && ok;
+
+		// an arena reader allocates nothing once its blocks exist
+		if (err == UJO_SUCCESS) err = ujo_reader_use_arena(ujor, 0);
+		if (err == UJO_SUCCESS) err = ujo_reader_set_buffer(ujor, data, datasize);
+		if (err == UJO_SUCCESS) err = test26_read_all(ujor, &count);
+		if (err == UJO_SUCCESS) err = ujo_reader_reset_arena(ujor);
+		before = counted_allocs(counter);
+		if (err == UJO_SUCCESS) err = ujo_reader_set_buffer(ujor, data, datasize);
+		if (err == UJO_SUCCESS) err = test26_read_all(ujor, &count);
+		if (err == UJO_SUCCESS) err = ujo_reader_reset_arena(ujor);
+		ok = test26_check("read test05 document with arena", counted_allocs(counter) - before, TEST26_ARENA_ALLOCS) && ok;
+		ujo_free_reader(ujor);
+	}
+	ujo_free_writer(ujow);
+
+	// reading a document with a 1 MB binary
+	if (err == UJO_SUCCESS) err = ujo_new_memory_writer(&ujow);
+	if (err == UJO_SUCCESS) err = ujo_writer_list_open(ujow);
+	if (err == UJO_SUCCESS) err = ujo_writer_add_binary(ujow, 1, payload, TEST26_BINARY);
+	if (err == UJO_SUCCESS) err = ujo_writer_list_close(ujow);
+	if (err == UJO_SUCCESS) err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	if (err == UJO_SUCCESS) err = ujo_new_memory_reader(&ujor);
+	if (err == UJO_SUCCESS)
+	{
+		before = counted_allocs(counter);
+		err = ujo_reader_set_buffer(ujor, data, datasize);
+		if (err == UJO_SUCCESS) err = test26_read_all(ujor, &count);
+		ok = test26_check("read 1 MB binary", counted_allocs(counter) - before, TEST26_BINARY_ALLOCS) && ok;
+		ujo_free_reader(ujor);
+	}
+	ujo_free_writer(ujow);
+
+	set_counting_memory_functions(NULL);
+	free(payload);
+
+	print_return_ujo_err(err,"test26"); 
+	print_return_expr_fail(counter.allocs == counter.frees && counter.live == 0, "allocations not released");
+	print_return_expr_fail(ok, "allocation limit exceeded");
+
+	return ujoTrue;
+}
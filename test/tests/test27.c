@@ -0,0 +1,203 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+
+static ujoError test27_write(ujo_writer* w)
+{
+	ujoError err;
+	uint8_t  data[100];
+
+	memset(data, 7, sizeof(data));
+
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_add_int32(w, 1));
+	return_on_err(ujo_writer_add_int32(w, 2));
+	return_on_err(ujo_writer_add_int32(w, 3));
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "key", 3));
+	return_on_err(ujo_writer_add_null(w, UJO_TYPE_FLOAT32));
+	return_on_err(ujo_writer_map_close(w));
+	return_on_err(ujo_writer_table_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "a", 1));
+	return_on_err(ujo_writer_add_string_c(w, "b", 1));
+	return_on_err(ujo_writer_table_end_columns(w));
+	return_on_err(ujo_writer_add_bool(w, ujoTrue));
+	return_on_err(ujo_writer_add_nulls(w, UJO_TYPE_INT8, 3));
+	return_on_err(ujo_writer_table_close(w));
+	return_on_err(ujo_writer_add_binary(w, 1, data, sizeof(data)));
+	return ujo_writer_list_close(w);
+}
+
+static ujoError test27_read(ujo_reader* r)
+{
+	ujoError     err;
+	ujo_element* e;
+	ujoBool      eod;
+
+	err = ujo_reader_get_first(r, &e, &eod);
+	while (err == UJO_SUCCESS && !eod)
+	{
+		ujo_free_element(e);
+		err = ujo_reader_get_next(r, &e, &eod);
+	}
+	return err;
+}
+
+/**
+ * test27: reader and writer statistics
+ */
+ujoBool test27()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte			fixed[40];
+	ujoStats		wstats;
+	ujoStats		rstats;
+	ujoDestroyFunc	destroy;
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_writer_get_stats(ujow, &wstats);
+	if (err == UJO_ERR_NOT_IMPLEMENTED)
+	{
+		// built without UJO_ENABLE_STATS
+		ujo_free_writer(ujow);
+		return ujoTrue;
+	}
+
+	err = test27_write(ujow);
+	print_return_ujo_err(err,"test27_write"); 
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	err = ujo_writer_get_stats(ujow, &wstats);
+	print_return_ujo_err(err,"ujo_writer_get_stats"); 
+
+	print_return_expr_fail(wstats.bytes == datasize, "writer bytes mismatch");
+	print_return_expr_fail(wstats.elements[UJO_TYPE_LIST] == 1 && wstats.elements[UJO_TYPE_MAP] == 1 &&
+		wstats.elements[UJO_TYPE_TABLE] == 1, "writer container count mismatch");
+	print_return_expr_fail(wstats.elements[UJO_TYPE_INT32] == 3 && wstats.elements[UJO_TYPE_STRING] == 3 &&
+		wstats.elements[UJO_TYPE_BOOL] == 1 && wstats.elements[UJO_TYPE_BIN] == 1, "writer value count mismatch");
+	print_return_expr_fail(wstats.elements[UJO_TYPE_FLOAT32 | UJO_TYPE_NULL_FLAG] == 1 &&
+		wstats.elements[UJO_TYPE_INT8 | UJO_TYPE_NULL_FLAG] == 3, "writer null count mismatch");
+	print_return_expr_fail(wstats.elements[UJO_TERMINATOR] == 4, "writer terminator count mismatch");
+	print_return_expr_fail(wstats.containers == 3 && wstats.maxdepth == 2, "writer nesting mismatch");
+	print_return_expr_fail(wstats.heapbytes >= datasize && wstats.iocalls == 0, "writer memory mismatch");
+
+	// the reader sees the same elements
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+	err = ujo_reader_set_buffer(ujor, data, datasize);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+	err = test27_read(ujor);
+	print_return_ujo_err(err,"test27_read"); 
+	err = ujo_reader_get_stats(ujor, &rstats);
+	print_return_ujo_err(err,"ujo_reader_get_stats"); 
+
+	print_return_expr_fail(rstats.bytes == datasize, "reader bytes mismatch");
+	print_return_expr_fail(memcmp(rstats.elements, wstats.elements, sizeof(wstats.elements)) == 0, "reader element count mismatch");
+	print_return_expr_fail(rstats.containers == 3 && rstats.maxdepth == 2, "reader nesting mismatch");
+	print_return_expr_fail(rstats.heapbytes > 100 && rstats.iocalls == 0, "reader memory mismatch");
+
+	// counters accumulate over documents
+	err = ujo_reader_reset(ujor);
+	print_return_ujo_err(err,"ujo_reader_reset"); 
+	err = test27_read(ujor);
+	print_return_ujo_err(err,"test27_read"); 
+	err = ujo_reader_get_stats(ujor, &rstats);
+	print_return_ujo_err(err,"ujo_reader_get_stats"); 
+	print_return_expr_fail(rstats.bytes == 2*datasize && rstats.containers == 6 && rstats.maxdepth == 2, "reader totals mismatch");
+	ujo_free_reader(ujor);
+	ujo_free_writer(ujow);
+
+	// detaching an open document starts the nesting again
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	err = ujo_writer_detach_buffer(ujow, &data, &datasize, &destroy);
+	print_return_ujo_err(err,"ujo_writer_detach_buffer"); 
+	destroy(data);
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	err = ujo_writer_list_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_close"); 
+	err = ujo_writer_get_stats(ujow, &wstats);
+	print_return_ujo_err(err,"ujo_writer_get_stats"); 
+	print_return_expr_fail(wstats.containers == 3 && wstats.maxdepth == 2, "detached writer nesting mismatch");
+	ujo_free_writer(ujow);
+
+	// a full fixed writer does not count the dropped value
+	err = ujo_new_fixed_writer(&ujow, fixed, sizeof(fixed));
+	print_return_ujo_err(err,"ujo_new_fixed_writer"); 
+	err = test27_write(ujow);
+	print_return_expr_fail(err == UJO_ERR_BUFFER_FULL, "fixed writer not full");
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	err = ujo_writer_get_stats(ujow, &wstats);
+	print_return_ujo_err(err,"ujo_writer_get_stats"); 
+	print_return_expr_fail(wstats.bytes == datasize && wstats.heapbytes == 0, "fixed writer bytes mismatch");
+	ujo_free_writer(ujow);
+
+	// file access is counted in calls
+	err = ujo_new_file_writer(&ujow, "./test27.ujo");
+	print_return_ujo_err(err,"ujo_new_file_writer"); 
+	err = test27_write(ujow);
+	print_return_ujo_err(err,"test27_write"); 
+	err = ujo_writer_get_stats(ujow, &wstats);
+	print_return_ujo_err(err,"ujo_writer_get_stats"); 
+	ujo_free_writer(ujow);
+
+	err = ujo_new_file_reader(&ujor, "./test27.ujo");
+	print_return_ujo_err(err,"ujo_new_file_reader"); 
+	err = test27_read(ujor);
+	print_return_ujo_err(err,"test27_read"); 
+	err = ujo_reader_get_stats(ujor, &rstats);
+	print_return_ujo_err(err,"ujo_reader_get_stats"); 
+	ujo_free_reader(ujor);
+
+	print_return_expr_fail(wstats.iocalls > 0 && rstats.iocalls > 0, "file calls not counted");
+	print_return_expr_fail(wstats.bytes == rstats.bytes, "file bytes mismatch");
+
+	return ujoTrue;
+}
@@ -0,0 +1,106 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+
+typedef struct {
+	int         calls;
+	ujoLogLevel level;
+	int         line;
+	char        file[64];
+	char        message[64];
+} test28_log;
+
+static void test28_sink(ujoLogLevel level, const char* file, int line, const char* message, ujoPointer data)
+{
+	test28_log* log = (test28_log*)data;
+
+	log->calls++;
+	log->level = level;
+	log->line  = line;
+	snprintf(log->file, sizeof(log->file), "%s", file);
+	snprintf(log->message, sizeof(log->message), "%s", message);
+}
+
+/**
+ * test28: log sink
+ */
+ujoBool test28()
+{
+	ujo_writer*		ujow;
+	ujoError		err = UJO_SUCCESS;
+	test28_log		log;
+
+	memset(&log, 0, sizeof(log));
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+
+	err = ujo_set_log_level(UJO_LOG_ERROR);
+	if (err == UJO_ERR_NOT_IMPLEMENTED)
+	{
+		// built without UJO_ENABLE_LOG, errors are still reported
+		print_return_expr_fail(ujo_set_log_sink(test28_sink, &log) == UJO_ERR_NOT_IMPLEMENTED, "log sink available");
+		err = ujo_writer_get_stats(ujow, NULL);
+		print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "error not reported");
+		ujo_free_writer(ujow);
+		return ujoTrue;
+	}
+	print_return_ujo_err(err,"ujo_set_log_level"); 
+	err = ujo_set_log_sink(test28_sink, &log);
+	print_return_ujo_err(err,"ujo_set_log_sink"); 
+
+	// a failed operation reaches the sink
+	err = ujo_writer_get_stats(ujow, NULL);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "error not reported");
+	print_return_expr_fail(log.calls == 1 && log.level == UJO_LOG_ERROR, "message not logged");
+	print_return_expr_fail(strstr(log.file, "ujo_writer.c") != NULL && log.line > 0, "source location mismatch");
+	print_return_expr_fail(strstr(log.message, "invalid statistics") != NULL, "message mismatch");
+
+	// disabled messages are dropped
+	err = ujo_set_log_level(UJO_LOG_OFF);
+	print_return_ujo_err(err,"ujo_set_log_level"); 
+	err = ujo_writer_get_stats(ujow, NULL);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "error not reported");
+	print_return_expr_fail(log.calls == 1, "disabled message logged");
+
+	err = ujo_set_log_sink(NULL, NULL);
+	print_return_ujo_err(err,"ujo_set_log_sink"); 
+	ujo_free_writer(ujow);
+
+	return ujoTrue;
+}
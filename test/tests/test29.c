@@ -0,0 +1,195 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include "ujo_profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST29_BINARY (1 << 20)
+
+static ujoError test29_write(ujo_writer* w)
+{
+	ujoError err;
+
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "id", 2));
+	return_on_err(ujo_writer_add_int32(w, 5));
+	return_on_err(ujo_writer_add_string_c(w, "name", 4));
+	return_on_err(ujo_writer_add_string_c(w, "abc", 3));
+	return_on_err(ujo_writer_map_close(w));
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "id", 2));
+	return_on_err(ujo_writer_add_int32(w, 300));
+	return_on_err(ujo_writer_add_string_c(w, "name", 4));
+	return_on_err(ujo_writer_add_string_c(w, "abc", 3));
+	return_on_err(ujo_writer_map_close(w));
+	return_on_err(ujo_writer_table_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "a", 1));
+	return_on_err(ujo_writer_add_string_c(w, "b", 1));
+	return_on_err(ujo_writer_table_end_columns(w));
+	return_on_err(ujo_writer_add_int64(w, 1));
+	return_on_err(ujo_writer_add_string_c(w, "x", 1));
+	return_on_err(ujo_writer_add_int64(w, 2));
+	return_on_err(ujo_writer_add_string_c(w, "x", 1));
+	return_on_err(ujo_writer_table_close(w));
+	return_on_err(ujo_writer_add_float64(w, 0.5));
+	return ujo_writer_list_close(w);
+}
+
+/**
+ * test29: content profile
+ */
+ujoBool test29()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujo_profile*	profile;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	uint64_t		bytes = UJO_HEADER_SIZE;
+	ujoProfileSummary summary;
+	ujoProfileEntry	entry;
+	int				i;
+	FILE*			file;
+	uint8_t*		payload;
+	alloc_counter	counter;
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = test29_write(ujow);
+	print_return_ujo_err(err,"test29_write"); 
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+	err = ujo_reader_set_buffer(ujor, data, datasize);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+
+	err = ujo_new_profile(&profile, 0);
+	print_return_ujo_err(err,"ujo_new_profile"); 
+	err = ujo_profile_read(profile, ujor);
+	print_return_ujo_err(err,"ujo_profile_read"); 
+	err = ujo_profile_get_summary(profile, &summary);
+	print_return_ujo_err(err,"ujo_profile_get_summary"); 
+
+	// every octet is assigned to a type
+	for (i = 0; i < 256; i++)
+		bytes += summary.typebytes[i];
+	print_return_expr_fail(summary.documents == 1 && summary.bytes == datasize, "document size mismatch");
+	print_return_expr_fail(bytes == datasize, "type octets mismatch");
+	print_return_expr_fail(summary.elements[UJO_TYPE_INT32] == 2 && summary.typebytes[UJO_TYPE_INT32] == 10, "int32 mismatch");
+	print_return_expr_fail(summary.strings[UJO_SUB_STRING_C] == 10 && summary.lengths[2] == 6, "string mismatch");
+
+	// 3+2 octets for int32, 7+7 for int64, 6 for float64
+	print_return_expr_fail(summary.narrowing == 25, "narrowing mismatch");
+
+	print_return_expr_fail(summary.distinct[UJO_PROFILE_KEYS] == 2 && summary.distinct[UJO_PROFILE_COLUMNS] == 2 &&
+		summary.distinct[UJO_PROFILE_STRINGS] == 2, "distinct strings mismatch");
+	err = ujo_profile_get_entry(profile, UJO_PROFILE_KEYS, 1, &entry);
+	print_return_ujo_err(err,"ujo_profile_get_entry"); 
+	print_return_expr_fail(memcmp(entry.name, "name", 4) == 0 && entry.count == 2, "key mismatch");
+	err = ujo_profile_get_entry(profile, UJO_PROFILE_COLUMNS, 0, &entry);
+	print_return_ujo_err(err,"ujo_profile_get_entry"); 
+	print_return_expr_fail(entry.name[0] == 'a' && entry.values == 2 && entry.valuebytes == 18, "column mismatch");
+	err = ujo_profile_get_entry(profile, UJO_PROFILE_STRINGS, 1, &entry);
+	print_return_ujo_err(err,"ujo_profile_get_entry"); 
+	print_return_expr_fail(entry.name[0] == 'x' && entry.count == 2, "value mismatch");
+	err = ujo_profile_get_entry(profile, UJO_PROFILE_STRINGS, 2, &entry);
+	print_return_expr_fail(err == UJO_ERR_INVALID_DATA, "invalid entry returned");
+	ujo_free_profile(profile);
+
+	// strings beyond the limit are not tracked
+	err = ujo_reader_reset(ujor);
+	print_return_ujo_err(err,"ujo_reader_reset"); 
+	err = ujo_new_profile(&profile, 1);
+	print_return_ujo_err(err,"ujo_new_profile"); 
+	err = ujo_profile_read(profile, ujor);
+	print_return_ujo_err(err,"ujo_profile_read"); 
+	err = ujo_profile_get_summary(profile, &summary);
+	print_return_ujo_err(err,"ujo_profile_get_summary"); 
+	print_return_expr_fail(summary.distinct[UJO_PROFILE_KEYS] == 1 && summary.untracked[UJO_PROFILE_KEYS] == 2, "limit mismatch");
+	ujo_free_profile(profile);
+	ujo_free_reader(ujor);
+
+	// a file gives the same result
+	file = fopen("./test29.ujo", "wb");
+	print_return_expr_fail(file != NULL, "cannot create file");
+	fwrite(data, 1, datasize, file);
+	fclose(file);
+	ujo_free_writer(ujow);
+
+	err = ujo_new_profile(&profile, 0);
+	print_return_ujo_err(err,"ujo_new_profile"); 
+	err = ujo_profile_read_file(profile, "./test29.ujo");
+	print_return_ujo_err(err,"ujo_profile_read_file"); 
+	err = ujo_profile_get_summary(profile, &summary);
+	print_return_ujo_err(err,"ujo_profile_get_summary"); 
+	print_return_expr_fail(summary.bytes == datasize && summary.narrowing == 25, "file profile mismatch");
+	ujo_free_profile(profile);
+
+	// binary values are profiled without reading them whole
+	payload = (uint8_t*)calloc(1, TEST29_BINARY);
+	print_return_expr_fail(payload, "allocation failed");
+	err = ujo_new_file_writer(&ujow, "./test29.ujo");
+	print_return_ujo_err(err,"ujo_new_file_writer"); 
+	err = ujo_writer_list_open(ujow);
+	if (err == UJO_SUCCESS) err = ujo_writer_add_binary(ujow, 7, payload, TEST29_BINARY);
+	if (err == UJO_SUCCESS) err = ujo_writer_list_close(ujow);
+	free(payload);
+	print_return_ujo_err(err,"ujo_writer_add_binary"); 
+	ujo_free_writer(ujow);
+
+	memset(&counter, 0, sizeof(counter));
+	set_counting_memory_functions(&counter);
+	err = ujo_new_profile(&profile, 0);
+	if (err == UJO_SUCCESS)
+	{
+		err = ujo_profile_read_file(profile, "./test29.ujo");
+		if (err == UJO_SUCCESS) err = ujo_profile_get_summary(profile, &summary);
+		ujo_free_profile(profile);
+	}
+	set_counting_memory_functions(NULL);
+	print_return_ujo_err(err,"ujo_profile_read_file"); 
+	print_return_expr_fail(summary.elements[UJO_TYPE_BIN] == 1 && summary.typebytes[UJO_TYPE_BIN] == TEST29_BINARY + 6, "binary mismatch");
+	print_return_expr_fail(counter.largest < TEST29_BINARY, "binary read whole");
+
+	return ujoTrue;
+}
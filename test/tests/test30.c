@@ -0,0 +1,186 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include "ujo_corpus.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST30_WIDE 65536
+
+static ujoError test30_write(ujo_writer* w)
+{
+	ujoError err;
+	uint8_t  data[3] = { 1, 2, 3 };
+
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "id", 2));
+	return_on_err(ujo_writer_add_int32(w, 5));
+	return_on_err(ujo_writer_add_uint8(w, 7));
+	return_on_err(ujo_writer_add_binary(w, 0, data, sizeof(data)));
+	return_on_err(ujo_writer_map_close(w));
+	return_on_err(ujo_writer_table_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "a", 1));
+	return_on_err(ujo_writer_add_string_c(w, "b", 1));
+	return_on_err(ujo_writer_table_end_columns(w));
+	return_on_err(ujo_writer_add_null(w, UJO_TYPE_TIMESTAMP));
+	return_on_err(ujo_writer_add_float16(w, 1.5f));
+	return_on_err(ujo_writer_table_close(w));
+	return ujo_writer_list_close(w);
+}
+
+/* validate a modified copy of the document */
+static ujoError test30_check(const ujoByte* data, size_t datasize, size_t pos, size_t remove, 
+	const ujoByte* insert, size_t n, ujoValidateReport* report)
+{
+	ujoByte  buffer[256];
+
+	memcpy(buffer, data, pos);
+	memcpy(buffer + pos, insert, n);
+	memcpy(buffer + pos + n, data + pos + remove, datasize - pos - remove);
+
+	return ujo_validate(buffer, datasize - remove + n, report);
+}
+
+/**
+ * test30: document validation
+ */
+ujoBool test30()
+{
+	ujo_writer*		ujow;
+	ujo_reader*		ujor;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte			buffer[256];
+	ujoValidateReport report;
+	size_t			i;
+	int				kind;
+
+	ujoByte			terminator = UJO_TERMINATOR;
+	ujoByte			list = UJO_TYPE_LIST;
+	ujoByte			int8[2] = { UJO_TYPE_INT8, 1 };
+	ujoByte			unknown = 0x20;
+	ujoByte			string[6] = { UJO_TYPE_STRING, UJO_SUB_STRING_U8, 0xFF, 0xFF, 0, 0 };
+	uint32_t		units = TEST30_WIDE - 100;
+	ujoByte*		wide;
+	ujoAllocator	allocator;
+	alloc_counter	counter;
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = test30_write(ujow);
+	print_return_ujo_err(err,"test30_write"); 
+	err = ujo_writer_get_buffer(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	print_return_expr_fail(datasize == 59, "unexpected document size");
+
+	err = ujo_validate(data, datasize, &report);
+	print_return_ujo_err(err,"ujo_validate"); 
+	print_return_expr_fail(report.bytes == datasize && report.elements == 15 && report.maxdepth == 2 &&
+		report.message == NULL, "report mismatch");
+
+	// every truncated document is invalid
+	for (i = 0; i < datasize; i++)
+		print_return_expr_fail(ujo_validate(data, i, NULL) == UJO_ERR_INVALID_DATA, "truncated document accepted");
+
+	// header, trailing data and unknown types
+	memcpy(buffer, data, datasize);
+	buffer[0] = 'X';
+	print_return_expr_fail(ujo_validate(buffer, datasize, &report) == UJO_ERR_INVALID_DATA && report.offset == 0, "invalid magic accepted");
+	print_return_expr_fail(test30_check(data, datasize, datasize, 0, &list, 1, &report) == UJO_ERR_INVALID_DATA && 
+		report.offset == datasize, "trailing data accepted");
+	print_return_expr_fail(test30_check(data, datasize, 8, 0, &unknown, 1, &report) == UJO_ERR_INVALID_DATA && 
+		report.offset == 8, "unknown type accepted");
+
+	// map pairs: the uint8 value is removed, the binary becomes a key
+	print_return_expr_fail(test30_check(data, datasize, 23, 2, int8, 0, &report) == UJO_ERR_INVALID_DATA, "map without value accepted");
+	// table rows: a value is added to the row
+	print_return_expr_fail(test30_check(data, datasize, 57, 0, int8, 2, &report) == UJO_ERR_INVALID_DATA, "incomplete row accepted");
+	// a terminator too many
+	print_return_expr_fail(test30_check(data, datasize, 57, 0, &terminator, 1, &report) == UJO_ERR_INVALID_DATA, "unbalanced container accepted");
+	// a length beyond the end
+	print_return_expr_fail(test30_check(data, datasize, 8, 0, string, sizeof(string), &report) == UJO_ERR_INVALID_DATA &&
+		report.offset == 8, "string length accepted");
+
+	// the memory reader checks the bounds as well
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+	for (i = 1; i < datasize; i++)
+	{
+		err = ujo_reader_set_buffer(ujor, data, i);
+		print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+		print_return_expr_fail(ujo_reader_parse(ujor) != UJO_SUCCESS, "truncated document parsed");
+	}
+	ujo_free_reader(ujor);
+
+	// units of a wide string are checked in octets before allocating
+	wide = (ujoByte*)calloc(1, TEST30_WIDE);
+	print_return_expr_fail(wide, "allocation failed");
+	memcpy(wide, data, UJO_HEADER_SIZE);
+	wide[UJO_HEADER_SIZE] = UJO_TYPE_STRING;
+	wide[UJO_HEADER_SIZE+1] = UJO_SUB_STRING_U32;
+	memcpy(wide + UJO_HEADER_SIZE + 2, &units, sizeof(uint32_t));
+	init_counting_allocator(&allocator, &counter);
+	err = ujo_new_memory_reader_ex(&ujor, &allocator);
+	print_return_ujo_err(err,"ujo_new_memory_reader_ex"); 
+	err = ujo_reader_set_buffer(ujor, wide, TEST30_WIDE);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+	free(wide);
+	print_return_expr_fail(ujo_reader_parse(ujor) == UJO_ERR_INVALID_DATA, "truncated wide string parsed");
+	print_return_expr_fail(counter.largest < units * sizeof(uint32_t), "truncated wide string allocated");
+	ujo_free_reader(ujor);
+	ujo_free_writer(ujow);
+
+	// generated documents of all kinds
+	for (kind = UJO_CORPUS_TELEMETRY; kind <= UJO_CORPUS_CONFIG; kind++)
+	{
+		err = ujo_new_memory_writer(&ujow);
+		print_return_ujo_err(err,"ujo_new_memory_writer"); 
+		err = ujo_corpus_write(ujow, (ujoCorpusKind)kind, 30, 20000);
+		print_return_ujo_err(err,"ujo_corpus_write"); 
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+		err = ujo_validate(data, datasize, &report);
+		print_return_ujo_err(err,"ujo_validate"); 
+		print_return_expr_fail(report.bytes == datasize, "corpus size mismatch");
+		ujo_free_writer(ujow);
+	}
+
+	return ujoTrue;
+}
@@ -0,0 +1,170 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include "ujo_corpus.h"
+#include <stdio.h>
+
+static ujoError test31_write(ujo_writer* w)
+{
+	ujoError err;
+	uint8_t  data[3] = { 1, 2, 3 };
+
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_map_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "id", 2));
+	return_on_err(ujo_writer_add_int32(w, 5));
+	return_on_err(ujo_writer_add_uint8(w, 7));
+	return_on_err(ujo_writer_binary_begin(w, 0, sizeof(data)));
+	return_on_err(ujo_writer_binary_append(w, data, sizeof(data)));
+	return_on_err(ujo_writer_binary_end(w));
+	return_on_err(ujo_writer_map_close(w));
+	// a c string longer than n is cut and terminated
+	return_on_err(ujo_writer_add_string_c(w, "abcdef", 3));
+	return_on_err(ujo_writer_table_open(w));
+	return_on_err(ujo_writer_add_string_c(w, "a", 1));
+	return_on_err(ujo_writer_add_string_c(w, "b", 1));
+	return_on_err(ujo_writer_table_end_columns(w));
+	return_on_err(ujo_writer_add_nulls(w, UJO_TYPE_TIMESTAMP, 3));
+	return_on_err(ujo_writer_add_float16(w, 1.5f));
+	return_on_err(ujo_writer_table_close(w));
+	return ujo_writer_list_close(w);
+}
+
+/* write a document with a checked and an unchecked writer and compare,
+   a negative kind selects the document of test31_write */
+static ujoBool test31_compare(int kind)
+{
+	ujo_writer*		checked;
+	ujo_writer*		unchecked;
+	ujoError		err;
+	ujoByte*		data1;
+	ujoByte*		data2;
+	size_t			size1;
+	size_t			size2;
+
+	err = ujo_new_memory_writer(&checked);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_new_memory_writer(&unchecked);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = ujo_writer_set_unchecked(unchecked, ujoTrue);
+	print_return_ujo_err(err,"ujo_writer_set_unchecked"); 
+
+	if (kind < 0)
+	{
+		err = test31_write(checked);
+		print_return_ujo_err(err,"test31_write"); 
+		err = test31_write(unchecked);
+		print_return_ujo_err(err,"test31_write"); 
+	}
+	else
+	{
+		err = ujo_corpus_write(checked, (ujoCorpusKind)kind, 31, 20000);
+		print_return_ujo_err(err,"ujo_corpus_write"); 
+		err = ujo_corpus_write(unchecked, (ujoCorpusKind)kind, 31, 20000);
+		print_return_ujo_err(err,"ujo_corpus_write"); 
+	}
+
+	err = ujo_writer_finish(checked);
+	print_return_ujo_err(err,"ujo_writer_finish"); 
+	err = ujo_writer_finish(unchecked);
+	print_return_ujo_err(err,"ujo_writer_finish"); 
+
+	err = ujo_writer_get_buffer(checked, &data1, &size1);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	err = ujo_writer_get_buffer(unchecked, &data2, &size2);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	print_return_expr_fail(size1 == size2 && memcmp(data1, data2, size1) == 0, "documents differ");
+
+	ujo_free_writer(checked);
+	ujo_free_writer(unchecked);
+	return ujoTrue;
+}
+
+/**
+ * test31: unchecked writer
+ */
+ujoBool test31()
+{
+	ujo_writer*		ujow;
+	ujoError		err = UJO_SUCCESS;
+	int				kind;
+
+	// identical output in both modes
+	for (kind = -1; kind <= UJO_CORPUS_CONFIG; kind++)
+		print_return_expr_fail(test31_compare(kind), "compare failed");
+
+	err = ujo_new_memory_writer(&ujow);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+
+	// a checked writer needs a closed document
+	err = ujo_writer_list_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_list_open"); 
+	print_return_expr_fail(ujo_writer_finish(ujow) == UJO_ERR_INVALID_OBJECT, "open document finished");
+
+	// the mode can not change within a document
+	print_return_expr_fail(ujo_writer_set_unchecked(ujow, ujoTrue) == UJO_ERR_INVALID_OBJECT, "mode changed in document");
+	err = ujo_writer_reset(ujow);
+	print_return_ujo_err(err,"ujo_writer_reset"); 
+	err = ujo_writer_set_unchecked(ujow, ujoTrue);
+	print_return_ujo_err(err,"ujo_writer_set_unchecked"); 
+
+	// an empty document is incomplete
+	print_return_expr_fail(ujo_writer_finish(ujow) == UJO_ERR_INVALID_OBJECT, "empty document finished");
+
+	// misplaced values are accepted and found by finish
+	err = ujo_writer_map_open(ujow);
+	print_return_ujo_err(err,"ujo_writer_map_open"); 
+	err = ujo_writer_add_int32(ujow, 1);
+	print_return_ujo_err(err,"ujo_writer_add_int32"); 
+	print_return_expr_fail(ujo_writer_finish(ujow) == UJO_ERR_INVALID_OBJECT, "unclosed document finished");
+	err = ujo_writer_map_close(ujow);
+	print_return_ujo_err(err,"ujo_writer_map_close"); 
+	print_return_expr_fail(ujo_writer_finish(ujow) == UJO_ERR_INVALID_OBJECT, "map without value finished");
+
+	// too many closes are still refused
+	print_return_expr_fail(ujo_writer_list_close(ujow) != UJO_SUCCESS, "unbalanced close accepted");
+
+	// the mode survives a reset
+	err = ujo_writer_reset(ujow);
+	print_return_ujo_err(err,"ujo_writer_reset"); 
+	err = ujo_writer_add_string_c(ujow, "a", 1);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	err = ujo_writer_add_string_c(ujow, "b", 1);
+	print_return_ujo_err(err,"ujo_writer_add_string_c"); 
+	print_return_expr_fail(ujo_writer_finish(ujow) == UJO_ERR_INVALID_OBJECT, "two root values finished");
+
+	ujo_free_writer(ujow);
+	return ujoTrue;
+}
@@ -0,0 +1,179 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+#include "ujo_tests.h"
+#include "testujo_helper.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST32_FILE "./test32.ujo"
+
+/* every value type, strings and binaries with and without payload */
+static ujoError test32_write(ujo_writer* w)
+{
+	ujoError    err;
+	ujoDateTime dt;
+	uint16_t    u16[3] = { 0x41, 0x20AC, 0x42 };
+	uint32_t    u32[2] = { 0x1F600, 0x43 };
+	uint8_t     data[5] = { 1, 2, 3, 4, 5 };
+
+	memset(&dt, 0, sizeof(dt));
+	dt.year = 2016; dt.month = 5; dt.day = 17;
+	dt.hour = 13; dt.minute = 42; dt.second = 59; dt.millisecond = 999;
+
+	return_on_err(ujo_writer_list_open(w));
+	return_on_err(ujo_writer_add_int64(w, -1234567890123LL));
+	return_on_err(ujo_writer_add_int32(w, -123456));
+	return_on_err(ujo_writer_add_int16(w, -1234));
+	return_on_err(ujo_writer_add_int8(w, -12));
+	return_on_err(ujo_writer_add_uint64(w, 1234567890123ULL));
+	return_on_err(ujo_writer_add_uint32(w, 123456));
+	return_on_err(ujo_writer_add_uint16(w, 1234));
+	return_on_err(ujo_writer_add_uint8(w, 12));
+	return_on_err(ujo_writer_add_float64(w, 0.1));
+	return_on_err(ujo_writer_add_float32(w, 0.5f));
+	return_on_err(ujo_writer_add_float16(w, 1.5f));
+	return_on_err(ujo_writer_add_bool(w, ujoTrue));
+	return_on_err(ujo_writer_add_none(w));
+	return_on_err(ujo_writer_add_null(w, UJO_TYPE_INT32));
+	return_on_err(ujo_writer_add_uxtime(w, 1463500000));
+	return_on_err(ujo_writer_add_date(w, dt));
+	return_on_err(ujo_writer_add_time(w, dt));
+	return_on_err(ujo_writer_add_timestamp(w, dt));
+	return_on_err(ujo_writer_add_string_c(w, "fused", 5));
+	return_on_err(ujo_writer_add_string_c(w, "terminated", 100));
+	return_on_err(ujo_writer_add_string_c(w, "", 0));
+	return_on_err(ujo_writer_add_string_u8(w, (const uint8_t*)"utf8", 4));
+	return_on_err(ujo_writer_add_string_u16(w, u16, 3));
+	return_on_err(ujo_writer_add_string_u32(w, u32, 2));
+	return_on_err(ujo_writer_add_binary(w, 7, data, sizeof(data)));
+	return_on_err(ujo_writer_add_binary(w, 0, data, 0));
+	return ujo_writer_list_close(w);
+}
+
+/**
+ * test32: fused value encoding
+ */
+ujoBool test32()
+{
+	ujo_writer*		ujow;
+	ujo_writer*		ref;
+	ujo_reader*		ujor;
+	ujo_element*	element;
+	ujoError		err = UJO_SUCCESS;
+
+	ujoByte*		refdata;
+	size_t			refsize;
+	ujoByte*		data;
+	size_t			datasize;
+	ujoByte			fixed[256];
+	ujoDateTime		dt;
+	ujoBool			eod;
+	ujoTypeId		type = UJO_TYPE_NONE;
+	size_t			capacity;
+	FILE*			f;
+
+	err = ujo_new_memory_writer(&ref);
+	print_return_ujo_err(err,"ujo_new_memory_writer"); 
+	err = test32_write(ref);
+	print_return_ujo_err(err,"test32_write"); 
+	err = ujo_writer_get_buffer(ref, &refdata, &refsize);
+	print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+	print_return_expr_fail(refsize < sizeof(fixed), "reference too large");
+	err = ujo_validate(refdata, refsize, NULL);
+	print_return_ujo_err(err,"ujo_validate"); 
+
+	// the timestamp is read back field by field
+	err = ujo_new_memory_reader(&ujor);
+	print_return_ujo_err(err,"ujo_new_memory_reader"); 
+	err = ujo_reader_set_buffer(ujor, refdata, refsize);
+	print_return_ujo_err(err,"ujo_reader_set_buffer"); 
+	err = ujo_reader_get_first(ujor, &element, &eod);
+	while (err == UJO_SUCCESS && !eod)
+	{
+		ujo_element_get_type(element, &type);
+		if (type == UJO_TYPE_TIMESTAMP)
+			break;
+		ujo_free_element(element);
+		err = ujo_reader_get_next(ujor, &element, &eod);
+	}
+	print_return_ujo_err(err,"ujo_reader_get_next"); 
+	print_return_expr_fail(!eod, "timestamp not found");
+	err = ujo_element_get_timestamp(element, &dt);
+	print_return_ujo_err(err,"ujo_element_get_timestamp"); 
+	print_return_expr_fail(dt.year == 2016 && dt.month == 5 && dt.day == 17 && dt.hour == 13 &&
+		dt.minute == 42 && dt.second == 59 && dt.millisecond == 999, "timestamp mismatch");
+	ujo_free_element(element);
+	ujo_free_reader(ujor);
+
+	// values cross the borders of the smallest segments
+	err = ujo_new_segmented_writer(&ujow, UJO_HEADER_SIZE, NULL);
+	print_return_ujo_err(err,"ujo_new_segmented_writer"); 
+	err = test32_write(ujow);
+	print_return_ujo_err(err,"test32_write"); 
+	err = ujo_writer_flatten(ujow, &data, &datasize);
+	print_return_ujo_err(err,"ujo_writer_flatten"); 
+	print_return_expr_fail(datasize == refsize && memcmp(data, refdata, refsize) == 0, "segmented content mismatch");
+	ujo_free_writer(ujow);
+
+	// a fixed writer keeps complete values only
+	for (capacity = UJO_HEADER_SIZE; capacity <= refsize; capacity++)
+	{
+		err = ujo_new_fixed_writer(&ujow, fixed, capacity);
+		print_return_ujo_err(err,"ujo_new_fixed_writer"); 
+		err = test32_write(ujow);
+		print_return_expr_fail(err == (capacity < refsize ? UJO_ERR_BUFFER_FULL : UJO_SUCCESS), "unexpected fixed writer result");
+		err = ujo_writer_get_buffer(ujow, &data, &datasize);
+		print_return_ujo_err(err,"ujo_writer_get_buffer"); 
+		print_return_expr_fail(datasize <= capacity && memcmp(data, refdata, datasize) == 0, "fixed content mismatch");
+		ujo_free_writer(ujow);
+	}
+
+	// a file writer puts each value at once
+	err = ujo_new_file_writer(&ujow, TEST32_FILE);
+	print_return_ujo_err(err,"ujo_new_file_writer"); 
+	err = test32_write(ujow);
+	print_return_ujo_err(err,"test32_write"); 
+	ujo_free_writer(ujow);
+
+	f = fopen(TEST32_FILE, "rb");
+	print_return_expr_fail(f != NULL, "file not written");
+	datasize = fread(fixed, 1, sizeof(fixed), f);
+	fclose(f);
+	remove(TEST32_FILE);
+	print_return_expr_fail(datasize == refsize && memcmp(fixed, refdata, refsize) == 0, "file content mismatch");
+
+	ujo_free_writer(ref);
+	return ujoTrue;
+}
@@ -36,6 +36,7 @@
 #define __UJO_TESTS_H__
 
 #include "ujo.h"
+#include "ujo_repack.h"
 
 /**
  * test01: library test
@@ -82,4 +83,119 @@ ujoBool test08();
  */
 ujoBool test09();
 
+/**
+ * test10: sparse table with null values
+ */
+ujoBool test10();
+
+/**
+ * test11: automatic numeric narrowing
+ */
+ujoBool test11();
+
+/**
+ * test12: repack documents
+ */
+ujoBool test12();
+
+/**
+ * test13: message templates
+ */
+ujoBool test13();
+
+/**
+ * test14: template matched decoding
+ */
+ujoBool test14();
+
+/**
+ * test15: custom allocator
+ */
+ujoBool test15();
+
+/**
+ * test16: arena reader
+ */
+ujoBool test16();
+
+/**
+ * test17: writer reset
+ */
+ujoBool test17();
+
+/**
+ * test18: reader reset
+ */
+ujoBool test18();
+
+/**
+ * test19: detach writer buffer
+ */
+ujoBool test19();
+
+/**
+ * test20: fixed writer
+ */
+ujoBool test20();
+
+/**
+ * test21: segmented writer
+ */
+ujoBool test21();
+
+/**
+ * test22: scattered reader
+ */
+ujoBool test22();
+
+/**
+ * test23: binary references
+ */
+ujoBool test23();
+
+/**
+ * test24: chunked binary
+ */
+ujoBool test24();
+
+/**
+ * test25: corpus generator
+ */
+ujoBool test25();
+
+/**
+ * test26: allocation counts
+ */
+ujoBool test26();
+
+/**
+ * test27: reader and writer statistics
+ */
+ujoBool test27();
+
+/**
+ * test28: log sink
+ */
+ujoBool test28();
+
+/**
+ * test29: content profile
+ */
+ujoBool test29();
+
+/**
+ * test30: document validation
+ */
+ujoBool test30();
+
+/**
+ * test31: unchecked writer
+ */
+ujoBool test31();
+
+/**
+ * test32: fused value encoding
+ */
+ujoBool test32();
+
 #endif
\ No newline at end of file
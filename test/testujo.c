@@ -111,6 +111,167 @@ ujoBool run_test(int no)
 			printf ("Test 09: file access [ FAILED ]\n");
 			return ujoFalse;
 		}; break;
+	case 10: 
+		if (test10()) {
+			printf ("Test 10: sparse table with null values [   OK   ]\n");
+		}else {
+			printf ("Test 10: sparse table with null values [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 11: 
+		if (test11()) {
+			printf ("Test 11: automatic numeric narrowing [   OK   ]\n");
+		}else {
+			printf ("Test 11: automatic numeric narrowing [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 12: 
+		if (test12()) {
+			printf ("Test 12: repack documents [   OK   ]\n");
+		}else {
+			printf ("Test 12: repack documents [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 13: 
+		if (test13()) {
+			printf ("Test 13: message templates [   OK   ]\n");
+		}else {
+			printf ("Test 13: message templates [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 14: 
+		if (test14()) {
+			printf ("Test 14: template matched decoding [   OK   ]\n");
+		}else {
+			printf ("Test 14: template matched decoding [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 15: 
+		if (test15()) {
+			printf ("Test 15: custom allocator [   OK   ]\n");
+		}else {
+			printf ("Test 15: custom allocator [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 16: 
+		if (test16()) {
+			printf ("Test 16: arena reader [   OK   ]\n");
+		}else {
+			printf ("Test 16: arena reader [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 17: 
+		if (test17()) {
+			printf ("Test 17: writer reset [   OK   ]\n");
+		}else {
+			printf ("Test 17: writer reset [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 18: 
+		if (test18()) {
+			printf ("Test 18: reader reset [   OK   ]\n");
+		}else {
+			printf ("Test 18: reader reset [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 19: 
+		if (test19()) {
+			printf ("Test 19: detach writer buffer [   OK   ]\n");
+		}else {
+			printf ("Test 19: detach writer buffer [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 20: 
+		if (test20()) {
+			printf ("Test 20: fixed writer [   OK   ]\n");
+		}else {
+			printf ("Test 20: fixed writer [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 21: 
+		if (test21()) {
+			printf ("Test 21: segmented writer [   OK   ]\n");
+		}else {
+			printf ("Test 21: segmented writer [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 22: 
+		if (test22()) {
+			printf ("Test 22: scattered reader [   OK   ]\n");
+		}else {
+			printf ("Test 22: scattered reader [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 23: 
+		if (test23()) {
+			printf ("Test 23: binary references [   OK   ]\n");
+		}else {
+			printf ("Test 23: binary references [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 24: 
+		if (test24()) {
+			printf ("Test 24: chunked binary [   OK   ]\n");
+		}else {
+			printf ("Test 24: chunked binary [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 25: 
+		if (test25()) {
+			printf ("Test 25: corpus generator [   OK   ]\n");
+		}else {
+			printf ("Test 25: corpus generator [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 26: 
+		if (test26()) {
+			printf ("Test 26: allocation counts [   OK   ]\n");
+		}else {
+			printf ("Test 26: allocation counts [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 27: 
+		if (test27()) {
+			printf ("Test 27: reader and writer statistics [   OK   ]\n");
+		}else {
+			printf ("Test 27: reader and writer statistics [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 28: 
+		if (test28()) {
+			printf ("Test 28: log sink [   OK   ]\n");
+		}else {
+			printf ("Test 28: log sink [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 29: 
+		if (test29()) {
+			printf ("Test 29: content profile [   OK   ]\n");
+		}else {
+			printf ("Test 29: content profile [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 30: 
+		if (test30()) {
+			printf ("Test 30: document validation [   OK   ]\n");
+		}else {
+			printf ("Test 30: document validation [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 31: 
+		if (test31()) {
+			printf ("Test 31: unchecked writer [   OK   ]\n");
+		}else {
+			printf ("Test 31: unchecked writer [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
+	case 32: 
+		if (test32()) {
+			printf ("Test 32: fused value encoding [   OK   ]\n");
+		}else {
+			printf ("Test 32: fused value encoding [ FAILED ]\n");
+			return ujoFalse;
+		}; break;
 	default:
 		printf ("Test with no %d not found! [ FAILED ]\n", no);
 		return ujoFalse;
@@ -146,7 +307,7 @@ int main(int argc, char **argv)
 		}
 	}
 	else {
-		for (testno = 1; testno <= 9; testno++)
+		for (testno = 1; testno <= 32; testno++)
 		{
 			if (!run_test(testno)) {
 			return -1;
@@ -124,6 +124,120 @@ uint8_t* get_pseudo_bin(uint32_t n)
 
 };
 
+// ---------------------------- counting allocator -------------------------
+#define ALLOC_MAGIC 0x554A4F41u
+
+/* each block carries a header with its size to track the memory in use 
+   and to detect blocks that were not allocated here */
+typedef struct {
+	uint32_t magic;
+	size_t   size;
+	uint64_t align;
+} alloc_header;
+
+static ujoPointer counting_alloc(ujoPointer user, size_t size)
+{
+	alloc_counter* c = (alloc_counter*)user;
+	alloc_header*  h;
+
+	if (c->failat != 0 && c->allocs + 1 >= c->failat)
+		return NULL;
+	h = (alloc_header*)calloc(1, sizeof(alloc_header) + size);
+	if (h == NULL)
+		return NULL;
+	h->magic = ALLOC_MAGIC;
+	h->size  = size;
+	c->allocs++;
+	c->live += size;
+	if (size > c->largest)
+		c->largest = size;
+	return h + 1;
+}
+
+static ujoPointer counting_realloc(ujoPointer user, ujoPointer ref, size_t oldsize, size_t size)
+{
+	alloc_counter* c = (alloc_counter*)user;
+	alloc_header*  h = (alloc_header*)ref - 1;
+
+	if (h->magic != ALLOC_MAGIC || h->size != oldsize)
+	{
+		c->foreign++;
+		return NULL;
+	}
+	h = (alloc_header*)realloc(h, sizeof(alloc_header) + size);
+	if (h == NULL)
+		return NULL;
+	h->size = size;
+	c->reallocs++;
+	c->live = c->live - oldsize + size;
+	if (size > c->largest)
+		c->largest = size;
+	return h + 1;
+}
+
+static void counting_free(ujoPointer user, ujoPointer ref)
+{
+	alloc_counter* c = (alloc_counter*)user;
+	alloc_header*  h = (alloc_header*)ref - 1;
+
+	if (h->magic != ALLOC_MAGIC)
+	{
+		c->foreign++;
+		return;
+	}
+	h->magic = 0;
+	c->frees++;
+	c->live -= h->size;
+	free(h);
+}
+
+void init_counting_allocator(ujoAllocator* allocator, alloc_counter* counter)
+{
+	memset(counter, 0, sizeof(alloc_counter));
+	allocator->alloc   = counting_alloc;
+	allocator->realloc = counting_realloc;
+	allocator->free    = counting_free;
+	allocator->user    = counter;
+}
+
+/* the memory functions have no user data */
+static alloc_counter* memory_counter;
+
+static ujoPointer counting_memory_calloc(size_t count, size_t size)
+{
+	return counting_alloc(memory_counter, count * size);
+}
+
+static ujoPointer counting_memory_realloc(ujoPointer ref, size_t size)
+{
+	if (ref == NULL)
+		return counting_alloc(memory_counter, size);
+	return counting_realloc(memory_counter, ref, ((alloc_header*)ref - 1)->size, size);
+}
+
+static void counting_memory_free(ujoPointer ref)
+{
+	if (ref != NULL)
+		counting_free(memory_counter, ref);
+}
+
+static const ujoMemoryFunctions counting_memory_functions = {
+	counting_memory_calloc, counting_memory_realloc, counting_memory_free
+};
+
+void set_counting_memory_functions(alloc_counter* counter)
+{
+	if (counter == NULL)
+	{
+		ujo_set_memory_functions(NULL);
+		memory_counter = NULL;
+		return;
+	}
+	memset(counter, 0, sizeof(alloc_counter));
+	memory_counter = counter;
+	ujo_set_memory_functions(&counting_memory_functions);
+}
+
 /**
  * myOnElement: Callback method for ujo_reader_set_on_element
  */
@@ -58,6 +58,33 @@ size_t get_write_buffer_size(ujo_writer* w);
 
 uint8_t* get_pseudo_bin(uint32_t n);
 
+/**
+ * counters of the test allocator
+ */
+typedef struct {
+	uint32_t allocs;     // new blocks
+	uint32_t reallocs;   // resized blocks
+	uint32_t frees;
+	uint32_t foreign;    // blocks not allocated by the test allocator
+	size_t   live;       // octets in use
+	size_t   largest;    // largest block
+	uint32_t failat;     // new blocks fail from this count on, 0 never fails
+} alloc_counter;
+
+/* calls that allocated or resized a block */
+#define counted_allocs(c) ((c).allocs + (c).reallocs)
+
+/**
+ * init_counting_allocator: an allocator that counts its calls in counter
+ */
+void init_counting_allocator(ujoAllocator* allocator, alloc_counter* counter);
+
+/**
+ * set_counting_memory_functions: count the default allocations of the library 
+ * in counter, NULL restores the default memory functions
+ */
+void set_counting_memory_functions(alloc_counter* counter);
+
 /**
  * myOnElement: Callback method for ujo_reader_set_on_element
  */
@@ -0,0 +1,99 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ujo.h"
+#include "ujo_corpus.h"
+
+/**
+ * Parse a size with an optional K, M or G suffix or return 0.
+ */
+static uint64_t parse_size(const char* text)
+{
+	char*    end;
+	uint64_t size = strtoull(text, &end, 10);
+
+	switch (*end)
+	{
+	case 'k': case 'K': size <<= 10; end++; break;
+	case 'm': case 'M': size <<= 20; end++; break;
+	case 'g': case 'G': size <<= 30; end++; break;
+	default: break;
+	}
+
+	return (*end == '\0') ? size : 0;
+}
+
+/**
+ * Main function.
+ */
+int main(int argc, char **argv)
+{
+	ujoError      err;
+	ujoCorpusKind kind;
+	uint64_t      size;
+	uint64_t      seed = 1;
+
+	if (argc != 4 && argc != 5) {
+		fprintf(stderr, "usage: ujocorpus <kind> <size[K|M|G]> <output.ujo> [seed]\n\n");
+		fprintf(stderr, "Writes a reproducible workload document of about the given size.\n");
+		fprintf(stderr, "Kinds: telemetry, events, status, images, config\n");
+		return -1;
+	}
+
+	if (ujo_corpus_get_kind(argv[1], &kind) != UJO_SUCCESS) {
+		fprintf(stderr, "ujocorpus: unknown kind %s\n", argv[1]);
+		return -1;
+	}
+
+	size = parse_size(argv[2]);
+	if (size == 0) {
+		fprintf(stderr, "ujocorpus: invalid size %s\n", argv[2]);
+		return -1;
+	}
+
+	if (argc == 5)
+		seed = strtoull(argv[4], NULL, 0);
+
+	err = ujo_corpus_write_file(argv[3], kind, seed, size);
+	if (err != UJO_SUCCESS) {
+		fprintf(stderr, "ujocorpus: writing %s failed with error %u\n", argv[3], err);
+		return -1;
+	}
+
+	printf("%s: %s corpus, seed %llu\n", argv[3], argv[1], (unsigned long long)seed);
+
+	return 0;
+}
@@ -0,0 +1,83 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ujo.h"
+#include "ujo_profile.h"
+
+/**
+ * Main function.
+ */
+int main(int argc, char **argv)
+{
+	ujoError     err;
+	ujo_profile* p;
+	size_t       top = 10;
+	int          i = 1;
+
+	if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+		top = (size_t)strtoul(argv[2], NULL, 10);
+		i = 3;
+	}
+
+	if (i >= argc) {
+		fprintf(stderr, "usage: ujoprofile [-n top] <input.ujo> [input.ujo ...]\n\n");
+		fprintf(stderr, "Reports how the octets of the documents are spent as JSON.\n");
+		fprintf(stderr, "The top keys, column names and string values are listed by octets.\n");
+		return -1;
+	}
+
+	err = ujo_new_profile(&p, 0);
+	if (err != UJO_SUCCESS) {
+		fprintf(stderr, "ujoprofile: creating the profiler failed with error %u\n", err);
+		return -1;
+	}
+
+	for (; i < argc; i++) {
+		err = ujo_profile_read_file(p, argv[i]);
+		if (err != UJO_SUCCESS) {
+			fprintf(stderr, "ujoprofile: reading %s failed with error %u\n", argv[i], err);
+			ujo_free_profile(p);
+			return -1;
+		}
+	}
+
+	ujo_profile_print(p, stdout, top);
+	ujo_free_profile(p);
+
+	return 0;
+}
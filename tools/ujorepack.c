@@ -0,0 +1,82 @@
+/* 
+ *  LibUjo:  An UJO binaray data object notation library.
+ *  Copyright (c) 2015 by wobe-systems GmbH
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public License
+ *  as published by the Free Software Foundation; either version 2.1
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this program; if not, write to the Free
+ *  Software Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA
+ *  02111-1307 USA
+ *  
+ *  You may find a copy of the license under this software is released
+ *  at COPYING file. This is LGPL software: you are welcome to develop
+ *  proprietary applications using this library without any royalty or
+ *  fee but returning back any change, improvement or addition in the
+ *  form of source code, project image, documentation patches, etc.
+ *
+ *  Homepage:
+ *    http://www.libujo.org
+ *
+ *  For professional support contact us:
+ *
+ *    wobe-systems GmbH
+ *    support@libujo.org
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "ujo.h"
+#include "ujo_repack.h"
+
+/**
+ * Get the size of a file or -1.
+ */
+static long file_size(const char* filename)
+{
+	FILE* f = fopen(filename, "rb");
+	long  size;
+
+	if (f == NULL) return -1;
+	fseek(f, 0, SEEK_END);
+	size = ftell(f);
+	fclose(f);
+
+	return size;
+}
+
+/**
+ * Main function.
+ */
+int main(int argc, char **argv)
+{
+	ujoError err;
+	long     insize;
+	long     outsize;
+
+	if (argc != 3) {
+		fprintf(stderr, "usage: ujorepack <input.ujo> <output.ujo>\n\n");
+		fprintf(stderr, "Rewrites an UJO document with the smallest lossless type of each value.\n");
+		return -1;
+	}
+
+	err = ujo_repack_file(argv[1], argv[2]);
+	if (err != UJO_SUCCESS) {
+		fprintf(stderr, "ujorepack: repacking %s failed with error %u\n", argv[1], err);
+		return -1;
+	}
+
+	insize  = file_size(argv[1]);
+	outsize = file_size(argv[2]);
+	printf("%s: %ld bytes -> %s: %ld bytes\n", argv[1], insize, argv[2], outsize);
+
+	return 0;
+}